@@ -0,0 +1,60 @@
+#include "gl_extensions.h"
+
+#include <cstring>
+#include <glad/glad.h>
+
+namespace GLExtensions {
+
+	using GetTextureHandleProc = uint64_t(APIENTRYP)(uint32_t texture);
+	using TextureHandleProc = void(APIENTRYP)(uint64_t handle);
+
+	GetTextureHandleProc gGetTextureHandle = nullptr;
+	TextureHandleProc gMakeTextureHandleResident = nullptr;
+	TextureHandleProc gMakeTextureHandleNonResident = nullptr;
+
+	bool gBindlessTexture = false;
+
+	// Returns if the backend reports the extension of the given name
+	bool _supported(const char* extension)
+	{
+		int32_t nExtensions = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &nExtensions);
+		for (int32_t i = 0; i < nExtensions; i++) {
+			const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+			if (name && std::strcmp(name, extension) == 0) return true;
+		}
+		return false;
+	}
+
+	void load(ProcLoader loader)
+	{
+		gBindlessTexture = false;
+		if (_supported("GL_ARB_bindless_texture")) {
+			gGetTextureHandle = reinterpret_cast<GetTextureHandleProc>(loader("glGetTextureHandleARB"));
+			gMakeTextureHandleResident = reinterpret_cast<TextureHandleProc>(loader("glMakeTextureHandleResidentARB"));
+			gMakeTextureHandleNonResident = reinterpret_cast<TextureHandleProc>(loader("glMakeTextureHandleNonResidentARB"));
+			gBindlessTexture = gGetTextureHandle && gMakeTextureHandleResident && gMakeTextureHandleNonResident;
+		}
+	}
+
+	bool bindlessTexture()
+	{
+		return gBindlessTexture;
+	}
+
+	uint64_t getTextureHandle(uint32_t texture)
+	{
+		return gGetTextureHandle(texture);
+	}
+
+	void makeTextureHandleResident(uint64_t handle)
+	{
+		gMakeTextureHandleResident(handle);
+	}
+
+	void makeTextureHandleNonResident(uint64_t handle)
+	{
+		gMakeTextureHandleNonResident(handle);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Optional backend extensions, loaded independently of the core function loader
+namespace GLExtensions
+{
+	// Function returning the address of a backend function by its name
+	using ProcLoader = void* (*)(const char* name);
+
+	// Checks which extensions are supported and loads their functions, after the core functions were loaded
+	void load(ProcLoader loader);
+
+	// Returns if bindless textures are supported (ARB_bindless_texture)
+	bool bindlessTexture();
+
+	// Equivalent of glGetTextureHandleARB
+	uint64_t getTextureHandle(uint32_t texture);
+
+	// Equivalent of glMakeTextureHandleResidentARB
+	void makeTextureHandleResident(uint64_t handle);
+
+	// Equivalent of glMakeTextureHandleNonResidentARB
+	void makeTextureHandleNonResident(uint64_t handle);
+};
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "gl_state.h"
+
+#include <glad/glad.h>
+
+#include <diagnostics/diagnostics.h>
+
+namespace GLState {
+
+	// Value of state that isn't known
+	constexpr uint32_t UNKNOWN = UINT32_MAX;
+
+	// Amount of texture units with cached bindings, binds to higher units are always issued
+	constexpr uint32_t MAX_TEXTURE_UNITS = 32;
+
+	// Texture targets with cached bindings
+	enum TextureTarget : uint32_t {
+		TEXTURE_2D,
+		TEXTURE_3D,
+		TEXTURE_CUBE_MAP,
+		TEXTURE_2D_MULTISAMPLE,
+		TEXTURE_2D_ARRAY,
+		TEXTURE_TARGET_COUNT
+	};
+
+	// Capabilities with cached states
+	enum Capability : uint32_t {
+		DEPTH_TEST,
+		CULL_FACE,
+		BLEND,
+		CAPABILITY_COUNT
+	};
+
+	uint32_t gProgram = UNKNOWN;
+	uint32_t gVertexArray = UNKNOWN;
+	uint32_t gDrawFramebuffer = UNKNOWN;
+	uint32_t gReadFramebuffer = UNKNOWN;
+
+	uint32_t gActiveUnit = UNKNOWN;
+	uint32_t gTextures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+
+	uint32_t gCapabilities[CAPABILITY_COUNT]; // GL_TRUE, GL_FALSE or unknown
+	uint32_t gCullFaceMode = UNKNOWN;
+	uint32_t gDepthFunction = UNKNOWN;
+	uint32_t gBlendSourceFactor = UNKNOWN;
+	uint32_t gBlendDestinationFactor = UNKNOWN;
+
+	// Returns if a call setting the given cached value is redundant, updating the cache and diagnostics
+	bool _redundant(uint32_t& cached, uint32_t value)
+	{
+		if (cached == value) {
+			Diagnostics::addCurrentFilteredStateChanges(1);
+			return true;
+		}
+
+		cached = value;
+		Diagnostics::addCurrentStateChanges(1);
+		return false;
+	}
+
+	// Returns the cached target index of the given texture target, TEXTURE_TARGET_COUNT if it isn't cached
+	uint32_t _textureTarget(uint32_t target)
+	{
+		switch (target) {
+		case GL_TEXTURE_2D:
+			return TEXTURE_2D;
+		case GL_TEXTURE_3D:
+			return TEXTURE_3D;
+		case GL_TEXTURE_CUBE_MAP:
+			return TEXTURE_CUBE_MAP;
+		case GL_TEXTURE_2D_MULTISAMPLE:
+			return TEXTURE_2D_MULTISAMPLE;
+		case GL_TEXTURE_2D_ARRAY:
+			return TEXTURE_2D_ARRAY;
+		default:
+			return TEXTURE_TARGET_COUNT;
+		}
+	}
+
+	// Returns the cached capability index of the given capability, CAPABILITY_COUNT if it isn't cached
+	uint32_t _capability(uint32_t capability)
+	{
+		switch (capability) {
+		case GL_DEPTH_TEST:
+			return DEPTH_TEST;
+		case GL_CULL_FACE:
+			return CULL_FACE;
+		case GL_BLEND:
+			return BLEND;
+		default:
+			return CAPABILITY_COUNT;
+		}
+	}
+
+	void invalidate()
+	{
+		gProgram = UNKNOWN;
+		gVertexArray = UNKNOWN;
+		gDrawFramebuffer = UNKNOWN;
+		gReadFramebuffer = UNKNOWN;
+
+		gActiveUnit = UNKNOWN;
+		for (uint32_t unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+			for (uint32_t target = 0; target < TEXTURE_TARGET_COUNT; target++)
+				gTextures[unit][target] = UNKNOWN;
+
+		for (uint32_t capability = 0; capability < CAPABILITY_COUNT; capability++)
+			gCapabilities[capability] = UNKNOWN;
+		gCullFaceMode = UNKNOWN;
+		gDepthFunction = UNKNOWN;
+		gBlendSourceFactor = UNKNOWN;
+		gBlendDestinationFactor = UNKNOWN;
+	}
+
+	void useProgram(uint32_t program)
+	{
+		if (_redundant(gProgram, program)) return;
+		glUseProgram(program);
+	}
+
+	void bindVertexArray(uint32_t vao)
+	{
+		if (_redundant(gVertexArray, vao)) return;
+		glBindVertexArray(vao);
+	}
+
+	void bindFramebuffer(uint32_t target, uint32_t fbo)
+	{
+		if (target == GL_FRAMEBUFFER) {
+			if (gDrawFramebuffer == fbo && gReadFramebuffer == fbo) {
+				Diagnostics::addCurrentFilteredStateChanges(1);
+				return;
+			}
+
+			gDrawFramebuffer = fbo;
+			gReadFramebuffer = fbo;
+			Diagnostics::addCurrentStateChanges(1);
+		}
+		else if (target == GL_DRAW_FRAMEBUFFER) {
+			if (_redundant(gDrawFramebuffer, fbo)) return;
+		}
+		else if (target == GL_READ_FRAMEBUFFER) {
+			if (_redundant(gReadFramebuffer, fbo)) return;
+		}
+
+		glBindFramebuffer(target, fbo);
+	}
+
+	void activeTexture(uint32_t unit)
+	{
+		if (_redundant(gActiveUnit, unit - GL_TEXTURE0)) return;
+		glActiveTexture(unit);
+	}
+
+	void bindTexture(uint32_t target, uint32_t texture)
+	{
+		// Bindings of unknown units or uncached targets are always issued
+		uint32_t targetIndex = _textureTarget(target);
+		if (gActiveUnit >= MAX_TEXTURE_UNITS || targetIndex == TEXTURE_TARGET_COUNT) {
+			Diagnostics::addCurrentStateChanges(1);
+			glBindTexture(target, texture);
+			return;
+		}
+
+		if (_redundant(gTextures[gActiveUnit][targetIndex], texture)) return;
+		glBindTexture(target, texture);
+	}
+
+	void enable(uint32_t capability)
+	{
+		uint32_t index = _capability(capability);
+		if (index == CAPABILITY_COUNT) Diagnostics::addCurrentStateChanges(1);
+		else if (_redundant(gCapabilities[index], GL_TRUE)) return;
+		glEnable(capability);
+	}
+
+	void disable(uint32_t capability)
+	{
+		uint32_t index = _capability(capability);
+		if (index == CAPABILITY_COUNT) Diagnostics::addCurrentStateChanges(1);
+		else if (_redundant(gCapabilities[index], GL_FALSE)) return;
+		glDisable(capability);
+	}
+
+	void cullFace(uint32_t mode)
+	{
+		if (_redundant(gCullFaceMode, mode)) return;
+		glCullFace(mode);
+	}
+
+	void depthFunc(uint32_t function)
+	{
+		if (_redundant(gDepthFunction, function)) return;
+		glDepthFunc(function);
+	}
+
+	void blendFunc(uint32_t sourceFactor, uint32_t destinationFactor)
+	{
+		if (gBlendSourceFactor == sourceFactor && gBlendDestinationFactor == destinationFactor) {
+			Diagnostics::addCurrentFilteredStateChanges(1);
+			return;
+		}
+
+		gBlendSourceFactor = sourceFactor;
+		gBlendDestinationFactor = destinationFactor;
+		Diagnostics::addCurrentStateChanges(1);
+		glBlendFunc(sourceFactor, destinationFactor);
+	}
+
+	void deleteProgram(uint32_t program)
+	{
+		// A program in use is only deleted once it's unbound, forget it so the next use is issued
+		if (gProgram == program) gProgram = UNKNOWN;
+		glDeleteProgram(program);
+	}
+
+	void deleteVertexArrays(int32_t n, const uint32_t* vaos)
+	{
+		for (int32_t i = 0; i < n; i++)
+			if (vaos[i] && gVertexArray == vaos[i]) gVertexArray = 0;
+		glDeleteVertexArrays(n, vaos);
+	}
+
+	void deleteFramebuffers(int32_t n, const uint32_t* fbos)
+	{
+		for (int32_t i = 0; i < n; i++) {
+			if (!fbos[i]) continue;
+			if (gDrawFramebuffer == fbos[i]) gDrawFramebuffer = 0;
+			if (gReadFramebuffer == fbos[i]) gReadFramebuffer = 0;
+		}
+		glDeleteFramebuffers(n, fbos);
+	}
+
+	void deleteTextures(int32_t n, const uint32_t* textures)
+	{
+		for (int32_t i = 0; i < n; i++) {
+			if (!textures[i]) continue;
+			for (uint32_t unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+				for (uint32_t target = 0; target < TEXTURE_TARGET_COUNT; target++)
+					if (gTextures[unit][target] == textures[i]) gTextures[unit][target] = 0;
+		}
+		glDeleteTextures(n, textures);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Cache of bound objects and fixed function state, dropping calls that wouldn't change the current state
+// Tracked state must only be changed through here, third party code changing it requires an invalidation
+namespace GLState
+{
+	// Forgets all cached state, the next call of each kind is always issued
+	void invalidate();
+
+	// Equivalent of glUseProgram
+	void useProgram(uint32_t program);
+
+	// Equivalent of glBindVertexArray
+	void bindVertexArray(uint32_t vao);
+
+	// Equivalent of glBindFramebuffer, GL_FRAMEBUFFER binds both the draw and read framebuffer
+	void bindFramebuffer(uint32_t target, uint32_t fbo);
+
+	// Equivalent of glActiveTexture, expects GL_TEXTURE0 + unit
+	void activeTexture(uint32_t unit);
+
+	// Equivalent of glBindTexture, binds to the active texture unit
+	void bindTexture(uint32_t target, uint32_t texture);
+
+	// Equivalent of glEnable, depth test, face culling and blending are cached
+	void enable(uint32_t capability);
+
+	// Equivalent of glDisable, depth test, face culling and blending are cached
+	void disable(uint32_t capability);
+
+	// Equivalent of glCullFace
+	void cullFace(uint32_t mode);
+
+	// Equivalent of glDepthFunc
+	void depthFunc(uint32_t function);
+
+	// Equivalent of glBlendFunc
+	void blendFunc(uint32_t sourceFactor, uint32_t destinationFactor);
+
+	// Equivalent of glDeleteProgram, resetting the cached program if it's the deleted one
+	void deleteProgram(uint32_t program);
+
+	// Equivalent of glDeleteVertexArrays, resetting cached bindings of deleted vertex arrays
+	void deleteVertexArrays(int32_t n, const uint32_t* vaos);
+
+	// Equivalent of glDeleteFramebuffers, resetting cached bindings of deleted framebuffers
+	void deleteFramebuffers(int32_t n, const uint32_t* fbos);
+
+	// Equivalent of glDeleteTextures, resetting cached bindings of deleted textures on all units
+	void deleteTextures(int32_t n, const uint32_t* textures);
+};
\ No newline at end of file
@@ -14,8 +14,11 @@ extern "C"
 #include <input/input.h>
 #include <input/cursor.h>
 #include <utils/console.h>
+#include <backend/gl_state.h>
+#include <backend/gl_extensions.h>
 #include <diagnostics/diagnostics.h>
 #include <rendering/primitives/global_quad.h>
+#include <rendering/texture/texture_array_pool.h>
 
 namespace ApplicationContext {
 
@@ -36,6 +39,22 @@ namespace ApplicationContext {
 	// Global resource manager
 	ResourceManager gResourceManager;
 
+	// Global job system
+	JobSystem gJobSystem;
+
+	// Global staging ring for asynchronous gpu uploads
+	StagingRing gStagingRing;
+
+	// Capacity of the global staging ring
+	constexpr size_t gStagingRingCapacity = 64 * 1024 * 1024;
+
+	// Global geometry arena all mesh buffers are sub-allocated from
+	GeometryArena gGeometryArena;
+
+	// Default vertex and index buffer page sizes of the global geometry arena
+	constexpr size_t gGeometryVertexPageSize = 64 * 1024 * 1024;
+	constexpr size_t gGeometryIndexPageSize = 32 * 1024 * 1024;
+
 	// Default glfw error callback
 	static void _glfwErrorCallback(int32_t error, const char* description)
 	{
@@ -77,6 +96,12 @@ namespace ApplicationContext {
 			Console::out::error("Application Context", "Initialization of GLAD failed");
 		}
 
+		// Load optional extensions
+		GLExtensions::load((GLExtensions::ProcLoader)glfwGetProcAddress);
+
+		// Start with unknown render state
+		GLState::invalidate();
+
 		// Debug graphics api version
 		const char* version = (const char*)glGetString(GL_VERSION);
 		Console::out::info("Application Context", "Initialized, OpenGL version: " + std::string(version));
@@ -178,6 +203,15 @@ namespace ApplicationContext {
 		// Create physics context
 		gPhysicsContext.create();
 
+		// Start job system workers
+		gJobSystem.start();
+
+		// Create staging ring for asynchronous uploads
+		gStagingRing.create(gStagingRingCapacity);
+
+		// Create geometry arena for mesh buffers
+		gGeometryArena.create(gGeometryVertexPageSize, gGeometryIndexPageSize);
+
 		// Create essential primitives
 		GlobalQuad::create();
 
@@ -192,6 +226,18 @@ namespace ApplicationContext {
 		// Destroy physics context
 		gPhysicsContext.destroy();
 
+		// Stop job system workers
+		gJobSystem.stop();
+
+		// Destroy staging ring while context is alive
+		gStagingRing.destroy();
+
+		// Destroy geometry arena while context is alive
+		gGeometryArena.destroy();
+
+		// Destroy packed texture arrays while context is alive
+		TextureArrayPool::destroy();
+
 		// Destroy window and terminate glfw
 		if (gWindow != nullptr)
 		{
@@ -206,6 +252,12 @@ namespace ApplicationContext {
 		// Update glfw events
 		glfwPollEvents();
 
+		// Forget cached render state, third party code like imgui changes it outside of the cache
+		GLState::invalidate();
+
+		// Reclaim staging memory of finished uploads
+		gStagingRing.reclaim();
+
 		// Make global resource loader dispatch next pending resource to gpu
 		gResourceManager.updateContext();
 
@@ -405,4 +457,19 @@ namespace ApplicationContext {
 		return gResourceManager;
 	}
 
+	JobSystem& jobSystem()
+	{
+		return gJobSystem;
+	}
+
+	StagingRing& stagingRing()
+	{
+		return gStagingRing;
+	}
+
+	GeometryArena& geometryArena()
+	{
+		return gGeometryArena;
+	}
+
 }
\ No newline at end of file
@@ -4,7 +4,10 @@
 #include <glm/glm.hpp>
 
 #include <backend/api.h>
+#include <utils/job_system.h>
 #include <audio/audio_context.h>
+#include <memory/staging_ring.h>
+#include <memory/geometry_arena.h>
 #include <memory/resource_manager.h>
 #include <physics/core/physics_context.h>
 
@@ -92,4 +95,13 @@ namespace ApplicationContext
 	// Returns the resource manager
 	ResourceManager& resourceManager();
 
+	// Returns the job system
+	JobSystem& jobSystem();
+
+	// Returns the staging ring used for asynchronous gpu uploads
+	StagingRing& stagingRing();
+
+	// Returns the geometry arena all mesh buffers are sub-allocated from
+	GeometryArena& geometryArena();
+
 };
\ No newline at end of file
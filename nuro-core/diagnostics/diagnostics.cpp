@@ -17,6 +17,9 @@ namespace Diagnostics {
 	uint32_t gNCPUEntities = 0;
 	uint32_t gNGPUEntities = 0;
 
+	uint32_t gCurrentStateChanges = 0;
+	uint32_t gCurrentFilteredStateChanges = 0;
+
 	void step()
 	{
 		float delta = Time::unscaledDeltaf();
@@ -29,6 +32,9 @@ namespace Diagnostics {
 		gNCPUEntities = 0;
 		gNGPUEntities = 0;
 
+		gCurrentStateChanges = 0;
+		gCurrentFilteredStateChanges = 0;
+
 		// Calculate current fps
 		gFps = 1.0 / delta;
 
@@ -78,6 +84,16 @@ namespace Diagnostics {
 		return gNGPUEntities;
 	}
 
+	const uint32_t getCurrentStateChanges()
+	{
+		return gCurrentStateChanges;
+	}
+
+	const uint32_t getCurrentFilteredStateChanges()
+	{
+		return gCurrentFilteredStateChanges;
+	}
+
 	const void addCurrentDrawCalls(const uint32_t increment)
 	{
 		gCurrentDrawCalls += increment;
@@ -103,4 +119,14 @@ namespace Diagnostics {
 		gNGPUEntities += increment;
 	}
 
+	const void addCurrentStateChanges(const uint32_t increment)
+	{
+		gCurrentStateChanges += increment;
+	}
+
+	const void addCurrentFilteredStateChanges(const uint32_t increment)
+	{
+		gCurrentFilteredStateChanges += increment;
+	}
+
 }
\ No newline at end of file
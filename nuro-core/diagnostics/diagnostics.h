@@ -15,11 +15,15 @@ namespace Diagnostics
 	const uint32_t getCurrentPolygons(); // Polygons rendered this frame
 	const uint32_t getNEntitiesCPU(); // Entities handled on the cpu this frame
 	const uint32_t getNEntitiesGPU(); // Entities handled on the gpu this frame
+	const uint32_t getCurrentStateChanges(); // Render state changes issued this frame
+	const uint32_t getCurrentFilteredStateChanges(); // Redundant render state changes dropped this frame
 
 	const void addCurrentDrawCalls(const uint32_t increment);
 	const void addCurrentVertices(const uint32_t increment);
 	const void addCurrentPolygons(const uint32_t increment);
 	const void addNEntitiesCPU(const uint32_t increment);
 	const void addNEntitiesGPU(const uint32_t increment);
+	const void addCurrentStateChanges(const uint32_t increment);
+	const void addCurrentFilteredStateChanges(const uint32_t increment);
 
 };
\ No newline at end of file
@@ -65,15 +65,14 @@ struct TransformComponent {
 	// MATRIX CACHE
 	//
 
-	// Transforms current model matrix in world space
-	glm::mat4 model = glm::mat4(1.0f);
+	// Slot of transforms model and normal matrices within the world matrix store and of its per view matrices (entity index)
+	uint32_t slot = UINT32_MAX;
 
-	// Transforms current normal matrix in world space
-	glm::mat4 normal = glm::mat4(1.0f);
-
-	// Transforms current model-view-projection matrix
-	glm::mat4 mvp = glm::mat4(1.0f);
+};
 
+// Marks an entity as static, its transform is evaluated once when marked and skipped by the per frame transform loop afterwards
+// (modify static transforms only after removing the marker, or re-mark them)
+struct StaticComponent {
 };
 
 struct MeshRendererComponent {
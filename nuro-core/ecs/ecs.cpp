@@ -8,13 +8,22 @@
 #include <audio/audio_context.h>
 #include <transform/transform.h>
 
-ECS::ECS() : registry(), idCounter(0), renderQueue()
+ECS::ECS() : registry(), idCounter(0), renderQueue(registry), worldMatrices(), staticUpdates()
 {
 	// Setup ecs component reflection
 	ECSReflection::registerAll();
 
+	// Register transform events, slot is restored after replacing a transform too
+	registry.on_construct<TransformComponent>().connect<&ECS::assignTransformSlot>(this);
+	registry.on_update<TransformComponent>().connect<&ECS::assignTransformSlot>(this);
+
+	// Register static marker events
+	registry.on_construct<StaticComponent>().connect<&ECS::markStatic>(this);
+	registry.on_destroy<StaticComponent>().connect<&ECS::unmarkStatic>(this);
+
 	// Register mesh renderer events
 	registry.on_construct<MeshRendererComponent>().connect<&ECS::insertMeshRenderer>(this);
+	registry.on_update<MeshRendererComponent>().connect<&ECS::refreshMeshRenderer>(this);
 	registry.on_destroy<MeshRendererComponent>().connect<&ECS::purgeMeshRenderer>(this);
 
 	// Register audio source events
@@ -24,9 +33,27 @@ ECS::ECS() : registry(), idCounter(0), renderQueue()
 
 const RenderQueue& ECS::getRenderQueue()
 {
+	// Apply pending insertions and re-sorts batched since the last access
+	if (renderQueue.pending()) renderQueue.flush();
+
 	return renderQueue;
 }
 
+void ECS::sortRenderQueue(const glm::mat4& view)
+{
+	renderQueue.sort(view);
+}
+
+WorldMatrices& ECS::getWorldMatrices()
+{
+	return worldMatrices;
+}
+
+std::vector<Entity>& ECS::getStaticUpdates()
+{
+	return staticUpdates;
+}
+
 std::optional<Camera> ECS::getActiveCamera() {
 	auto group = registry.group<TransformComponent>(entt::get<CameraComponent>);
 	for (auto entity : group) {
@@ -101,6 +128,7 @@ void ECS::setParent(Entity entity, Entity parent)
 	transform.parent = parent;
 	transform.depth = parentTransform.depth + 1;
 	transform.modified = true;
+	propagateDepth(transform);
 }
 
 void ECS::removeParent(Entity entity)
@@ -123,6 +151,7 @@ void ECS::removeParent(Entity entity)
 	transform.parent = entt::null;
 	transform.depth = 0;
 	transform.modified = true;
+	propagateDepth(transform);
 }
 
 ECS& ECS::main()
@@ -138,78 +167,44 @@ uint32_t ECS::getId() {
 	return idCounter;
 }
 
-void ECS::insertMeshRenderer(Entity target) {
-
-	//
-	// NON-OPTIMAL BOILERPLATE CODE!
-	// Right now, this code is just regenerating the render queue using all mesh renderer components
-	// This is sub-optimal, it should just be inserted into the render queue at the right place
-	//
-
-	// Fill target queue
-	std::vector<Entity> targetQueue;
-
-	view<MeshRendererComponent>().each([&](auto entity, const auto&) {
-		targetQueue.push_back(entity);
-		});
+void ECS::assignTransformSlot(Entity target) {
+	// Slots are entity indices, entt recycles them densely
+	uint32_t slot = static_cast<uint32_t>(entt::to_entity(target));
+	worldMatrices.reserve(slot);
+	get<TransformComponent>(target).slot = slot;
+}
 
-	// Sort targets by shader and material
-	std::sort(targetQueue.begin(), targetQueue.end(), [&](auto lhsEntity, auto rhsEntity) {
-		MeshRendererComponent& lhs = get<MeshRendererComponent>(lhsEntity);
-		auto lhsShaderId = lhs.material ? lhs.material->getShaderId() : -1;
-		auto lhsMaterialId = lhs.material ? lhs.material->getId() : -1;
+void ECS::markStatic(Entity target) {
+	if (!has<TransformComponent>(target)) return;
 
-		MeshRendererComponent& rhs = get<MeshRendererComponent>(rhsEntity);
-		auto rhsShaderId = rhs.material ? rhs.material->getShaderId() : -1;
-		auto rhsMaterialId = rhs.material ? rhs.material->getId() : -1;
+	get<TransformComponent>(target).modified = true;
+	staticUpdates.push_back(target);
+}
 
-		return std::tie(lhsShaderId, lhsMaterialId) < std::tie(rhsShaderId, rhsMaterialId);
-		});
+void ECS::unmarkStatic(Entity target) {
+	if (!has<TransformComponent>(target)) return;
 
-	// Fill render queue
-	renderQueue.clear();
+	// Dynamic transforms are picked up by the transform pass again
+	get<TransformComponent>(target).modified = true;
+}
 
-	for (auto entity : targetQueue) {
-		renderQueue.emplace_back(entity, get<TransformComponent>(entity), get<MeshRendererComponent>(entity));
+void ECS::propagateDepth(TransformComponent& transform) {
+	// Keep depth of descendants in sync, the transform pass evaluates hierarchies level by level
+	for (Entity child : transform.children) {
+		TransformComponent& childTransform = get<TransformComponent>(child);
+		childTransform.depth = transform.depth + 1;
+		propagateDepth(childTransform);
 	}
-
 }
 
-void ECS::purgeMeshRenderer(Entity target) {
-
-	//
-	// NON-OPTIMAL BOILERPLATE CODE!
-	// Right now, this code is just regenerating the render queue using all mesh renderer components but skips the provided target entity
-	// This is sub-optimal, it should just be removed from the render queue
-	//
-
-	// Fill target queue
-	std::vector<Entity> targetQueue;
-
-	view<MeshRendererComponent>().each([&](auto entity, const auto&) {
-		if (entity != target) {
-			targetQueue.push_back(entity);
-		}
-		});
-
-	// Sort targets by shader and material
-	std::sort(targetQueue.begin(), targetQueue.end(), [&](auto lhsEntity, auto rhsEntity) {
-		MeshRendererComponent& lhs = get<MeshRendererComponent>(lhsEntity);
-		auto lhsShaderId = lhs.material ? lhs.material->getShaderId() : -1;
-		auto lhsMaterialId = lhs.material ? lhs.material->getId() : -1;
-
-		MeshRendererComponent& rhs = get<MeshRendererComponent>(rhsEntity);
-		auto rhsShaderId = rhs.material ? rhs.material->getShaderId() : -1;
-		auto rhsMaterialId = rhs.material ? rhs.material->getId() : -1;
-
-		return std::tie(lhsShaderId, lhsMaterialId) < std::tie(rhsShaderId, rhsMaterialId);
-		});
-
-	// Fill render queue
-	renderQueue.clear();
+void ECS::insertMeshRenderer(Entity target) {
+	renderQueue.insert(target);
+}
 
-	for (auto entity : targetQueue) {
-		renderQueue.emplace_back(entity, get<TransformComponent>(entity), get<MeshRendererComponent>(entity));
-	}
+void ECS::refreshMeshRenderer(Entity target) {
+	renderQueue.refresh(target);
+}
 
+void ECS::purgeMeshRenderer(Entity target) {
+	renderQueue.erase(target);
 }
\ No newline at end of file
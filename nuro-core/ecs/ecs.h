@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tuple>
+#include <vector>
 #include <memory>
 #include <sstream>
 #include <cstdint>
@@ -9,22 +10,32 @@
 
 #include <utils/console.h>
 #include <ecs/components.h>
+#include <ecs/render_queue.h>
+#include <transform/world_matrices.h>
 #include <ecs/ecs_reflection.h>
 
 using namespace entt::literals;
 
 using Entity = entt::entity;
 using Registry = entt::registry;
-using RenderQueue = std::vector<std::tuple<Entity, TransformComponent&, MeshRendererComponent&>>;
 using Camera = std::tuple<TransformComponent&, CameraComponent&>;
 
 class ECS {
 public:
 	ECS();
 
-	// Returns the render queue
+	// Returns the render queue, applying all of its pending updates first
 	const RenderQueue& getRenderQueue();
 
+	// Sorts the render queue front to back for the given view while keeping state changes grouped
+	void sortRenderQueue(const glm::mat4& view);
+
+	// Returns the world matrix store of all transforms
+	WorldMatrices& getWorldMatrices();
+
+	// Returns the entities marked static since the last transform pass, awaiting their final evaluation
+	std::vector<Entity>& getStaticUpdates();
+
 	// Returns the camera currently rendering
 	std::optional<Camera> getActiveCamera();
 
@@ -52,6 +63,12 @@ public:
 		return registry.view<Components...>();
 	}
 
+	// Creates a view skipping entities with any of the excluded components
+	template<typename... Components, typename... Excluded>
+	auto view(entt::exclude_t<Excluded...> excluded) {
+		return registry.view<Components...>(excluded);
+	}
+
 	// Returns if entity is valid
 	bool verify(Entity entity) const {
 		return registry.valid(entity);
@@ -81,6 +98,12 @@ public:
 		return registry.get<T>(entity);
 	}
 
+	// Patches component of given type attached to entity and notifies its observers (e.g. re-sorts the render queue)
+	template<typename T, typename... Func>
+	T& patch(Entity entity, Func&&... func) {
+		return registry.patch<T>(entity, std::forward<Func>(func)...);
+	}
+
 	// Removes component of given type from entity
 	template<typename T>
 	void remove(Entity entity) {
@@ -95,13 +118,30 @@ private:
 	Registry registry;
 	uint32_t idCounter;
 	RenderQueue renderQueue;
+	WorldMatrices worldMatrices;
+	std::vector<Entity> staticUpdates;
 
 	// Returns a unique id
 	uint32_t getId();
 
+	// Assigns the target entities transform its slot within the world matrix store
+	void assignTransformSlot(Entity target);
+
+	// Queues the final evaluation of the target entities transform after it was marked static
+	void markStatic(Entity target);
+
+	// Makes the target entities transform dynamic again
+	void unmarkStatic(Entity target);
+
+	// Updates the hierarchy depth of all descendants of the given transform
+	void propagateDepth(TransformComponent& transform);
+
 	// Inserts the target entity and its mesh renderer component to the render queue
 	void insertMeshRenderer(Entity target);
 
+	// Re-sorts the target entity within the render queue after its mesh renderer component was updated
+	void refreshMeshRenderer(Entity target);
+
 	// Purges the target entity and its mesh renderer component from the render queue
 	void purgeMeshRenderer(Entity target);
 };
\ No newline at end of file
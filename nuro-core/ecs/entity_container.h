@@ -134,6 +134,28 @@ public:
 		return ECS::main().get<T>(_handle);
 	}
 
+	// Patches component of given component type if attached to entity, notifying its observers (e.g. re-sorting the render queue)
+	template<typename T, typename... Func>
+	T& patch(Func&&... func) {
+
+		// Fail if entity isn't valid
+		if (!verify()) {
+			verifyFailed();
+			static T defaultComponent;
+			return defaultComponent;
+		}
+
+		// Make sure entity has component
+		if (!has<T>()) {
+			componentOperationFailed<T>("patch", "doesn't own an instance of it");
+			static T defaultComponent;
+			return defaultComponent;
+		}
+
+		// Patch and return component
+		return ECS::main().patch<T>(_handle, std::forward<Func>(func)...);
+	}
+
 	// Removes component of given component type if attached to entity
 	template<typename T>
 	void remove() {
@@ -0,0 +1,285 @@
+#include "render_queue.h"
+
+#include <cmath>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+
+#include <ecs/ecs.h>
+#include <transform/world_matrices.h>
+#include <rendering/model/mesh.h>
+#include <rendering/material/imaterial.h>
+
+RenderQueue::RenderQueue(Registry& registry) : registry(registry),
+lookup(),
+sorted(),
+sortBuffer(),
+insertBuffer(),
+depthBuffer(),
+depthView(0.0f),
+depthWorldVersion(0),
+depthOutdated(false),
+pendingEntities(),
+pendingLookup()
+{
+}
+
+uint64_t RenderQueue::packKey(Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId)
+{
+	// Ids exceeding their bit range wrap around, which only weakens grouping and never affects correctness
+	uint64_t key = 0;
+	key |= (static_cast<uint64_t>(pass) & ((1ull << PASS_BITS) - 1)) << PASS_SHIFT;
+	key |= (static_cast<uint64_t>(shaderId) & ((1ull << SHADER_BITS) - 1)) << SHADER_SHIFT;
+	key |= (static_cast<uint64_t>(materialId) & ((1ull << MATERIAL_BITS) - 1)) << MATERIAL_SHIFT;
+	key |= (static_cast<uint64_t>(meshId) & ((1ull << MESH_BITS) - 1)) << MESH_SHIFT;
+	return key;
+}
+
+void RenderQueue::insert(Entity entity)
+{
+	// Defer insertion, the mesh renderer is usually set up right after being constructed
+	refresh(entity);
+}
+
+void RenderQueue::refresh(Entity entity)
+{
+	// Skip if entity is already pending
+	if (!pendingLookup.insert(entity).second) return;
+
+	pendingEntities.push_back(entity);
+}
+
+void RenderQueue::erase(Entity entity)
+{
+	// Remove entity from pending entities if needed
+	if (pendingLookup.erase(entity)) {
+		auto it = std::find(pendingEntities.begin(), pendingEntities.end(), entity);
+		if (it != pendingEntities.end()) {
+			std::swap(*it, pendingEntities.back());
+			pendingEntities.pop_back();
+		}
+	}
+
+	// Remove sorted item of entity
+	auto it = lookup.find(entity);
+	if (it == lookup.end()) return;
+
+	size_t index = locate(entity, it->second);
+	if (index < sorted.size()) sorted.erase(sorted.begin() + index);
+	lookup.erase(it);
+}
+
+void RenderQueue::flush()
+{
+	insertBuffer.clear();
+	bool removed = false;
+
+	for (Entity entity : pendingEntities) {
+		// Entity might have lost its mesh renderer in the meantime
+		if (!registry.all_of<MeshRendererComponent>(entity)) continue;
+
+		Item item = createItem(entity);
+
+		// Keep item if its sorting didn't change, otherwise mark it for removal and insert it again
+		auto it = lookup.find(entity);
+		if (it != lookup.end()) {
+			if (it->second == item.key) continue;
+
+			size_t index = locate(entity, it->second);
+			if (index < sorted.size()) {
+				sorted[index].entity = entt::null;
+				removed = true;
+			}
+			it->second = item.key;
+		}
+		else {
+			lookup.emplace(entity, item.key);
+		}
+
+		insertBuffer.push_back(item);
+	}
+
+	pendingEntities.clear();
+	pendingLookup.clear();
+
+	// Drop items marked for removal
+	if (removed) sorted.erase(std::remove_if(sorted.begin(), sorted.end(), [](const Item& item) { return item.entity == entt::null; }), sorted.end());
+
+	if (insertBuffer.empty()) return;
+
+	// Merge sorted batch into the sorted items, inserted items have no depth yet
+	std::sort(insertBuffer.begin(), insertBuffer.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+	sortBuffer.clear();
+	sortBuffer.reserve(sorted.size() + insertBuffer.size());
+	std::merge(sorted.begin(), sorted.end(), insertBuffer.begin(), insertBuffer.end(), std::back_inserter(sortBuffer), [](const Item& a, const Item& b) { return a.key < b.key; });
+	sorted.swap(sortBuffer);
+
+	depthOutdated = true;
+}
+
+void RenderQueue::sort(const glm::mat4& view)
+{
+	if (pending()) flush();
+
+	size_t n = sorted.size();
+	if (n == 0) return;
+
+	// Depth order is still valid if neither the queue, the view nor any world matrix changed
+	WorldMatrices& matrices = ECS::main().getWorldMatrices();
+	if (!depthOutdated && view == depthView && matrices.version() == depthWorldVersion) return;
+	depthOutdated = false;
+	depthView = view;
+	depthWorldVersion = matrices.version();
+
+	// Calculate logarithmic view depth of each item and the depth range of the current view
+	constexpr float minDepth = 0.001f;
+	float nearest = std::numeric_limits<float>::max();
+	float farthest = std::log(minDepth);
+
+	const glm::mat4* models = matrices.modelData();
+	size_t nSlots = matrices.size();
+
+	depthBuffer.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		// World matrix slots are the entity indices
+		uint32_t slot = static_cast<uint32_t>(entt::to_entity(sorted[i].entity));
+		glm::vec4 position = slot < nSlots ? models[slot][3] : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		float viewZ = view[0][2] * position.x + view[1][2] * position.y + view[2][2] * position.z + view[3][2];
+		float depth = std::log(std::max(-viewZ, minDepth));
+
+		depthBuffer[i] = depth;
+		nearest = std::min(nearest, depth);
+		farthest = std::max(farthest, depth);
+	}
+
+	// Quantize depth logarithmically within the depth range, giving near items more precision
+	constexpr float depthMax = static_cast<float>((1ull << DEPTH_BITS) - 1);
+	float range = farthest - nearest;
+	float scale = range > 0.0f ? depthMax / range : 0.0f;
+
+	for (size_t i = 0; i < n; i++) {
+		uint64_t depth = static_cast<uint64_t>((depthBuffer[i] - nearest) * scale);
+		depth = std::min<uint64_t>(depth, static_cast<uint64_t>(depthMax));
+		sorted[i].key = (sorted[i].key & ~DEPTH_MASK) | (depth << DEPTH_SHIFT);
+	}
+
+	sortDepth();
+}
+
+bool RenderQueue::pending() const
+{
+	return !pendingEntities.empty();
+}
+
+size_t RenderQueue::size() const
+{
+	return sorted.size();
+}
+
+const std::vector<RenderQueue::Item>& RenderQueue::getItems() const
+{
+	return sorted;
+}
+
+RenderQueue::Iterator RenderQueue::begin() const
+{
+	return Iterator(&registry, sorted.begin());
+}
+
+RenderQueue::Iterator RenderQueue::end() const
+{
+	return Iterator(&registry, sorted.end());
+}
+
+RenderQueue::Item RenderQueue::createItem(Entity entity) const
+{
+	const MeshRendererComponent& renderer = registry.get<MeshRendererComponent>(entity);
+
+	Item item;
+	item.entity = entity;
+
+	if (!renderer.mesh || !renderer.material) {
+		item.key = packKey(Pass::UNAVAILABLE, 0, 0, 0);
+		return item;
+	}
+
+	item.key = packKey(Pass::SOLID, renderer.material->getShaderId(), renderer.material->getId(), renderer.mesh->id());
+	return item;
+}
+
+size_t RenderQueue::locate(Entity entity, uint64_t key) const
+{
+	// Items are ordered by their keys, so items sharing a key without depth are adjacent
+	auto it = std::lower_bound(sorted.begin(), sorted.end(), key, [](const Item& item, uint64_t key) { return (item.key & ~DEPTH_MASK) < key; });
+	for (; it != sorted.end() && (it->key & ~DEPTH_MASK) == key; ++it) {
+		if (it->entity == entity) return static_cast<size_t>(std::distance(sorted.begin(), it));
+	}
+	return sorted.size();
+}
+
+void RenderQueue::sortDepth()
+{
+	// Runs below this size are insertion sorted instead of radix sorted
+	constexpr size_t RADIX_THRESHOLD = 64;
+
+	size_t n = sorted.size();
+	size_t begin = 0;
+	while (begin < n) {
+		uint64_t key = sorted[begin].key & ~DEPTH_MASK;
+		size_t end = begin + 1;
+		while (end < n && (sorted[end].key & ~DEPTH_MASK) == key) end++;
+
+		size_t count = end - begin;
+		if (count >= RADIX_THRESHOLD) {
+			sortBuffer.resize(count);
+			radixSort(sorted.data() + begin, sortBuffer.data(), count, DEPTH_SHIFT, DEPTH_BITS);
+		}
+		else {
+			for (size_t i = begin + 1; i < end; i++) {
+				Item item = sorted[i];
+				size_t j = i;
+				for (; j > begin && sorted[j - 1].key > item.key; j--) sorted[j] = sorted[j - 1];
+				sorted[j] = item;
+			}
+		}
+
+		begin = end;
+	}
+}
+
+void RenderQueue::radixSort(Item* items, Item* buffer, size_t n, uint32_t firstBit, uint32_t nBits)
+{
+	constexpr uint32_t DIGIT_BITS = 8;
+	constexpr uint32_t BUCKETS = 1 << DIGIT_BITS;
+
+	if (n == 0) return;
+
+	Item* source = items;
+	Item* destination = buffer;
+
+	size_t counts[BUCKETS];
+	for (uint32_t shift = firstBit; shift < firstBit + nBits; shift += DIGIT_BITS) {
+		// Build histogram of current digit
+		std::fill(std::begin(counts), std::end(counts), 0);
+		for (size_t i = 0; i < n; i++) counts[(source[i].key >> shift) & (BUCKETS - 1)]++;
+
+		// Skip pass if all keys share the same digit
+		if (counts[(source[0].key >> shift) & (BUCKETS - 1)] == n) continue;
+
+		// Convert histogram to bucket offsets
+		size_t offset = 0;
+		for (uint32_t i = 0; i < BUCKETS; i++) {
+			size_t count = counts[i];
+			counts[i] = offset;
+			offset += count;
+		}
+
+		// Scatter items stable into their buckets
+		for (size_t i = 0; i < n; i++) destination[counts[(source[i].key >> shift) & (BUCKETS - 1)]++] = source[i];
+
+		std::swap(source, destination);
+	}
+
+	// Make sure result ends up in given items
+	if (source != items) std::copy(source, source + n, items);
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <entt/entt.hpp>
+
+#include <ecs/components.h>
+
+using Entity = entt::entity;
+using Registry = entt::registry;
+
+class RenderQueue
+{
+public:
+	//
+	// SORT KEY LAYOUT (most to least significant bits)
+	// [63..62] pass | [61..48] shader | [47..32] material | [31..16] mesh | [15..0] quantized view depth
+	//
+
+	// Render pass of an item, sorted by first
+	enum class Pass : uint64_t {
+		SOLID = 0, // Opaque geometry, rendered front to back
+		UNAVAILABLE = 3 // Renderer without mesh or material, rendered last
+	};
+
+	static constexpr uint64_t PASS_BITS = 2;
+	static constexpr uint64_t SHADER_BITS = 14;
+	static constexpr uint64_t MATERIAL_BITS = 16;
+	static constexpr uint64_t MESH_BITS = 16;
+	static constexpr uint64_t DEPTH_BITS = 16;
+
+	static constexpr uint64_t DEPTH_SHIFT = 0;
+	static constexpr uint64_t MESH_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+	static constexpr uint64_t MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+	static constexpr uint64_t SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	static constexpr uint64_t PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+
+	static constexpr uint64_t DEPTH_MASK = ((1ull << DEPTH_BITS) - 1) << DEPTH_SHIFT;
+
+	// Packs the given pass, shader, material and mesh ids into a sort key without depth
+	static uint64_t packKey(Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId);
+
+	// Single entry of the render queue
+	struct Item {
+		// Packed sort key
+		uint64_t key = 0;
+
+		// Entity owning the mesh renderer
+		Entity entity = entt::null;
+	};
+
+	// Iterates the render queue in sorted order, resolving each item to its entity and components
+	class Iterator {
+	public:
+		Iterator(Registry* registry, std::vector<Item>::const_iterator it) : registry(registry), it(it) {};
+
+		std::tuple<Entity, TransformComponent&, MeshRendererComponent&> operator*() const {
+			Entity entity = it->entity;
+			return { entity, registry->get<TransformComponent>(entity), registry->get<MeshRendererComponent>(entity) };
+		}
+
+		Iterator& operator++() {
+			++it;
+			return *this;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return it != other.it;
+		}
+
+	private:
+		Registry* registry;
+		std::vector<Item>::const_iterator it;
+	};
+
+	explicit RenderQueue(Registry& registry);
+
+	// Queues the insertion of the given entity, applied with the next flush
+	void insert(Entity entity);
+
+	// Queues the re-sorting of the given entity (e.g. after its mesh or material changed), applied with the next flush
+	void refresh(Entity entity);
+
+	// Removes the given entity from the render queue immediately using a binary search on its key
+	void erase(Entity entity);
+
+	// Applies all pending insertions and re-sorts in one batch, merging them into the sorted items in a single pass
+	void flush();
+
+	// Quantizes the view depth of each item using the given view matrix and sorts items sharing a key without depth by depth, skipped if neither the view, the queue nor any world matrix changed
+	void sort(const glm::mat4& view);
+
+	// Returns if there are pending updates awaiting the next flush
+	bool pending() const;
+
+	// Returns the amount of items in the render queue
+	size_t size() const;
+
+	// Returns the contiguous items in render order
+	const std::vector<Item>& getItems() const;
+
+	Iterator begin() const;
+	Iterator end() const;
+
+private:
+	// Creates an item for the given entity using its current mesh renderer
+	Item createItem(Entity entity) const;
+
+	// Returns the position of the item of the given entity with the given key without depth, the items size if it isn't queued
+	size_t locate(Entity entity, uint64_t key) const;
+
+	// Sorts each run of items sharing a key without depth by depth, items are kept ordered by their keys without depth
+	void sortDepth();
+
+	// Stable least significant digit radix sort of the given items by the given bits of their keys
+	static void radixSort(Item* items, Item* buffer, size_t n, uint32_t firstBit, uint32_t nBits);
+
+	// Registry the render queue resolves its entities with
+	Registry& registry;
+
+	// Maps each entity in the render queue to the key without depth of its item
+	std::unordered_map<Entity, uint64_t> lookup;
+
+	// Contiguous items in render order, always ordered by their keys
+	std::vector<Item> sorted;
+	std::vector<Item> sortBuffer;
+	std::vector<Item> insertBuffer;
+	std::vector<float> depthBuffer;
+
+	// View and world matrices version the depth of the items was last quantized with
+	glm::mat4 depthView;
+	uint32_t depthWorldVersion;
+	bool depthOutdated;
+
+	// Entities awaiting insertion or re-sorting with the next flush
+	std::vector<Entity> pendingEntities;
+	std::unordered_set<Entity> pendingLookup;
+};
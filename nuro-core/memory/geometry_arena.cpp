@@ -0,0 +1,246 @@
+#include "geometry_arena.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+#include <backend/gl_state.h>
+#include <utils/console.h>
+#include <rendering/model/model.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/passes/instance_batch.h>
+
+GeometryArena::RangeAllocator::RangeAllocator(uint32_t capacity) : freeRanges(),
+_capacity(capacity),
+_used(0)
+{
+	if (capacity) freeRanges[0] = capacity;
+}
+
+bool GeometryArena::RangeAllocator::allocate(uint32_t size, uint32_t& offset)
+{
+	if (size == 0) {
+		offset = 0;
+		return true;
+	}
+
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+		if (it->second < size) continue;
+
+		// Take the front of the free range
+		offset = it->first;
+		uint32_t remaining = it->second - size;
+		freeRanges.erase(it);
+		if (remaining) freeRanges[offset + size] = remaining;
+
+		_used += size;
+		return true;
+	}
+
+	return false;
+}
+
+void GeometryArena::RangeAllocator::free(uint32_t offset, uint32_t size)
+{
+	if (size == 0) return;
+
+	auto it = freeRanges.emplace(offset, size).first;
+
+	// Merge with following free range
+	auto next = std::next(it);
+	if (next != freeRanges.end() && it->first + it->second == next->first) {
+		it->second += next->second;
+		freeRanges.erase(next);
+	}
+
+	// Merge with preceding free range
+	if (it != freeRanges.begin()) {
+		auto previous = std::prev(it);
+		if (previous->first + previous->second == it->first) {
+			previous->second += it->second;
+			freeRanges.erase(it);
+		}
+	}
+
+	_used -= size;
+}
+
+uint32_t GeometryArena::RangeAllocator::capacity() const
+{
+	return _capacity;
+}
+
+uint32_t GeometryArena::RangeAllocator::used() const
+{
+	return _used;
+}
+
+GeometryArena::GeometryArena() : vertexPageSize(0),
+indexPageSize(0),
+pages()
+{
+}
+
+GeometryArena::~GeometryArena()
+{
+	// Backend resources are released by destroy() while the context is still alive
+}
+
+void GeometryArena::create(size_t _vertexPageSize, size_t _indexPageSize)
+{
+	vertexPageSize = _vertexPageSize;
+	indexPageSize = _indexPageSize;
+}
+
+void GeometryArena::destroy()
+{
+	for (Page& page : pages) {
+		GLState::deleteVertexArrays(1, &page.vao);
+		glDeleteBuffers(1, &page.vbo);
+		glDeleteBuffers(1, &page.ebo);
+	}
+	pages.clear();
+}
+
+GeometryArena::Allocation GeometryArena::allocate(Format format, uint32_t nVertices, uint32_t nIndices)
+{
+	Allocation allocation;
+	allocation.nVertices = nVertices;
+	allocation.nIndices = nIndices;
+
+	// Find a page of the same format with space for both ranges
+	for (uint32_t i = 0; i < pages.size(); i++) {
+		Page& page = pages[i];
+		if (page.format != format) continue;
+
+		if (!page.vertices.allocate(nVertices, allocation.vertexOffset)) continue;
+		if (!page.indices.allocate(nIndices, allocation.indexOffset)) {
+			page.vertices.free(allocation.vertexOffset, nVertices);
+			continue;
+		}
+
+		allocation.page = i;
+		return allocation;
+	}
+
+	// Create a new page, large enough for oversized meshes
+	uint32_t pageIndex = createPage(format, nVertices, nIndices);
+	if (pageIndex == UINT32_MAX) return Allocation();
+
+	Page& page = pages[pageIndex];
+	page.vertices.allocate(nVertices, allocation.vertexOffset);
+	page.indices.allocate(nIndices, allocation.indexOffset);
+	allocation.page = pageIndex;
+	return allocation;
+}
+
+void GeometryArena::free(Allocation& allocation)
+{
+	// Pages are gone already if the arena was destroyed first
+	if (allocation.valid() && allocation.page < pages.size()) {
+		Page& page = pages[allocation.page];
+		page.vertices.free(allocation.vertexOffset, allocation.nVertices);
+		page.indices.free(allocation.indexOffset, allocation.nIndices);
+	}
+
+	allocation = Allocation();
+}
+
+uint32_t GeometryArena::vao(const Allocation& allocation) const
+{
+	return allocation.page < pages.size() ? pages[allocation.page].vao : 0;
+}
+
+uint32_t GeometryArena::vbo(const Allocation& allocation) const
+{
+	return allocation.page < pages.size() ? pages[allocation.page].vbo : 0;
+}
+
+uint32_t GeometryArena::ebo(const Allocation& allocation) const
+{
+	return allocation.page < pages.size() ? pages[allocation.page].ebo : 0;
+}
+
+size_t GeometryArena::stride(Format format)
+{
+	return format == Format::PACKED ? sizeof(VertexFormat::PackedVertex) : sizeof(Model::VertexData);
+}
+
+size_t GeometryArena::capacity() const
+{
+	size_t total = 0;
+	for (const Page& page : pages)
+		total += page.vertices.capacity() * stride(page.format) + page.indices.capacity() * sizeof(uint32_t);
+	return total;
+}
+
+size_t GeometryArena::used() const
+{
+	size_t total = 0;
+	for (const Page& page : pages)
+		total += page.vertices.used() * stride(page.format) + page.indices.used() * sizeof(uint32_t);
+	return total;
+}
+
+uint32_t GeometryArena::createPage(Format format, uint32_t nVertices, uint32_t nIndices)
+{
+	size_t vertexStride = stride(format);
+	uint32_t vertexCapacity = static_cast<uint32_t>(std::max<size_t>(vertexPageSize / vertexStride, nVertices));
+	uint32_t indexCapacity = static_cast<uint32_t>(std::max<size_t>(indexPageSize / sizeof(uint32_t), nIndices));
+	if (vertexCapacity == 0 || indexCapacity == 0) {
+		Console::out::warning("Geometry Arena", "Couldn't create geometry page, arena wasn't created");
+		return UINT32_MAX;
+	}
+
+	Page page;
+	page.format = format;
+	page.vertices = RangeAllocator(vertexCapacity);
+	page.indices = RangeAllocator(indexCapacity);
+
+	// Generate VAO, VBO and EBO
+	glGenVertexArrays(1, &page.vao);
+	glGenBuffers(1, &page.vbo);
+	glGenBuffers(1, &page.ebo);
+
+	// Bind VAO
+	GLState::bindVertexArray(page.vao);
+
+	// Allocate immutable vertex and index storage written to by buffer copies
+	glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+	glBufferStorage(GL_ARRAY_BUFFER, static_cast<size_t>(vertexCapacity) * vertexStride, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ebo);
+	glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, static_cast<size_t>(indexCapacity) * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	// Set attributes for VAO
+	if (format == Format::PACKED) {
+		VertexFormat::setupPackedAttributes();
+	}
+	else {
+		using VertexData = Model::VertexData;
+		// Vertex position attribute (location = 0)
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
+		// Normal attribute (location = 1)
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
+		// Texture coordinates attribute (location = 2)
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, uv));
+		// Tangent attribute (location = 3)
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tangent));
+		// Bitangent attribute (location = 4)
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, bitangent));
+	}
+
+	// Set format of per instance attributes read from the instance buffer of instanced draws, they are enabled per instanced draw
+	InstanceBatch::setupAttributes();
+
+	// Unbind VAO before the buffers so the VAO keeps its index buffer
+	GLState::bindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	pages.push_back(std::move(page));
+	return static_cast<uint32_t>(pages.size() - 1);
+}
\ No newline at end of file
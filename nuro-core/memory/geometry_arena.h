@@ -0,0 +1,109 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Large shared vertex and index buffer pages meshes are sub-allocated from, sharing one vertex array per page
+class GeometryArena
+{
+public:
+	// Vertex layouts meshes can be stored in
+	enum class Format : uint8_t {
+		FLOAT, // Model::VertexData
+		PACKED // VertexFormat::PackedVertex
+	};
+
+	// Vertex and index ranges reserved within a page
+	struct Allocation {
+		uint32_t page = UINT32_MAX; // Index of the page holding the ranges
+		uint32_t vertexOffset = 0; // Offset of the first vertex within the pages vertex buffer in vertices
+		uint32_t nVertices = 0; // Amount of reserved vertices
+		uint32_t indexOffset = 0; // Offset of the first index within the pages index buffer in indices
+		uint32_t nIndices = 0; // Amount of reserved indices
+
+		// Returns if the allocation holds geometry memory
+		bool valid() const {
+			return page != UINT32_MAX;
+		}
+	};
+
+	GeometryArena();
+	~GeometryArena();
+
+	// Sets the default sizes of vertex and index buffer pages in bytes, pages are created once needed (context thread only)
+	void create(size_t vertexPageSize, size_t indexPageSize);
+
+	// Destroys all pages (context thread only)
+	void destroy();
+
+	// Reserves vertex and index ranges within a page of the given format, creating a new page if none has space left (context thread only)
+	Allocation allocate(Format format, uint32_t nVertices, uint32_t nIndices);
+
+	// Releases the ranges of an allocation and resets it (context thread only)
+	void free(Allocation& allocation);
+
+	// Returns the vertex array of the page an allocation lives in
+	uint32_t vao(const Allocation& allocation) const;
+
+	// Returns the vertex buffer of the page an allocation lives in
+	uint32_t vbo(const Allocation& allocation) const;
+
+	// Returns the index buffer of the page an allocation lives in
+	uint32_t ebo(const Allocation& allocation) const;
+
+	// Returns the size of a single vertex of the given format
+	static size_t stride(Format format);
+
+	// Returns the total size of all pages in bytes
+	size_t capacity() const;
+
+	// Returns the amount of bytes currently reserved
+	size_t used() const;
+
+private:
+	// First fit allocator of element ranges, free ranges are coalesced on release
+	class RangeAllocator
+	{
+	public:
+		explicit RangeAllocator(uint32_t capacity = 0);
+
+		// Reserves a range of the given size, returns false if there is no free range large enough
+		bool allocate(uint32_t size, uint32_t& offset);
+
+		// Releases a range
+		void free(uint32_t offset, uint32_t size);
+
+		// Returns the amount of elements
+		uint32_t capacity() const;
+
+		// Returns the amount of reserved elements
+		uint32_t used() const;
+
+	private:
+		// Free ranges by their offset
+		std::map<uint32_t, uint32_t> freeRanges;
+
+		uint32_t _capacity;
+		uint32_t _used;
+	};
+
+	struct Page {
+		Format format = Format::FLOAT;
+		uint32_t vao = 0;
+		uint32_t vbo = 0;
+		uint32_t ebo = 0;
+		RangeAllocator vertices;
+		RangeAllocator indices;
+	};
+
+	// Creates a page of the given format with at least the given capacities, returns its index
+	uint32_t createPage(Format format, uint32_t nVertices, uint32_t nIndices);
+
+	// Default page sizes in bytes
+	size_t vertexPageSize;
+	size_t indexPageSize;
+
+	std::vector<Page> pages;
+};
\ No newline at end of file
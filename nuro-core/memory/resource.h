@@ -2,11 +2,11 @@
 
 #include <string>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 #include <memory/resource_pipe.h>
-
-using ResourceID = uint32_t;
+#include <memory/resource_handle.h>
 
 enum class ResourceState {
 	// Resource has not been initialized or loaded yet
@@ -22,7 +22,16 @@ enum class ResourceState {
 	READY,
 
 	// Laoding resource failed
-	FAILED
+	FAILED,
+
+	// Resource data was evicted to stay within the memory budget, it is recreated once it's needed again
+	EVICTED
+};
+
+// Memory held by a resource in bytes
+struct ResourceFootprint {
+	size_t cpu = 0;
+	size_t gpu = 0;
 };
 
 class Resource
@@ -39,13 +48,30 @@ private:
 	// State of the resource
 	std::atomic<ResourceState> _resourceState;
 
+	// Frame the resource was last looked up in
+	std::atomic<uint64_t> _resourceLastUsed;
+
+	// Footprint cached by the resource manager and whether it has to be queried again (cache is context thread only)
+	ResourceFootprint _resourceFootprint;
+	std::atomic<bool> _resourceFootprintOutdated;
+
 protected:
 	// Returns a new resource pipe owned by this resource
 	ResourcePipe pipe() {
 		return std::move(ResourcePipe(_resourceId));
 	}
 
-	Resource() : _resourceId(0), _resourceName("none"), _resourceState(ResourceState::EMPTY) {};
+	// Frees all data of the resource to stay within the memory budget, returns false if the resource can't be evicted (context thread only)
+	virtual bool evict() {
+		return false;
+	}
+
+	// Returns the pipe recreating the resource after it was evicted
+	virtual ResourcePipe reload() {
+		return pipe();
+	}
+
+	Resource() : _resourceId(0), _resourceName("none"), _resourceState(ResourceState::EMPTY), _resourceLastUsed(0), _resourceFootprint(), _resourceFootprintOutdated(true) {};
 
 public:
 	virtual ~Resource() = 0;
@@ -64,6 +90,16 @@ public:
 	ResourceState resourceState() const {
 		return _resourceState;
 	}
+
+	// Returns the memory currently held by the resource, only queried while the resource is ready and cached until it's loaded again or changed
+	virtual ResourceFootprint footprint() const {
+		return ResourceFootprint();
+	}
+
+	// Makes the resource manager query the footprint again, for memory changing outside of the resources pipes (thread safe)
+	void footprintChanged() {
+		_resourceFootprintOutdated = true;
+	}
 };
 
 inline Resource::~Resource() {}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+using ResourceID = uint32_t;
+
+class Texture;
+class Model;
+class Shader;
+class AudioClip;
+class Cubemap;
+
+// Typed 32 bit handle of a resource, combining its registry slot and the slots generation
+template <typename T>
+struct ResourceHandle {
+	ResourceID id = 0;
+
+	ResourceHandle() = default;
+	explicit ResourceHandle(ResourceID id) : id(id) {};
+
+	// Returns if the handle refers to a resource at all (it might have been released meanwhile)
+	bool valid() const {
+		return id != 0;
+	}
+
+	operator ResourceID() const {
+		return id;
+	}
+
+	bool operator==(const ResourceHandle& other) const {
+		return id == other.id;
+	}
+
+	bool operator!=(const ResourceHandle& other) const {
+		return id != other.id;
+	}
+};
+
+using TextureHandle = ResourceHandle<Texture>;
+using ModelHandle = ResourceHandle<Model>;
+using ShaderHandle = ResourceHandle<Shader>;
+using AudioClipHandle = ResourceHandle<AudioClip>;
+using CubemapHandle = ResourceHandle<Cubemap>;
\ No newline at end of file
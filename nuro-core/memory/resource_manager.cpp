@@ -1,72 +1,223 @@
 #include "resource_manager.h"
 
-ResourceManager::ResourceManager() : idCounter(0),
-resources(),
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+
+ResourceManager::ResourceManager() : resources(),
+retiredResources(),
+frame(0),
+memoryBudget(),
+memoryUsage(),
+reloadRequests(),
+mtxReloads(),
 asyncPipes(),
 asyncPipesSize(0),
+mtxPipes(),
+cvNextPipe(),
 processorRunning(false),
-processor(),
-mtxProcessor(),
+workerCount(std::max(std::thread::hardware_concurrency() / 2, 1u)),
+workers(),
+mtxProcessorState(),
 processorState(),
-cvNextPipe(),
-cvAwaitingContext(),
-contextNext(false),
-contextResult(false),
-contextTask(nullptr)
+dependents(),
+nWaiting(0),
+mtxDependencies(),
+callbacks(),
+mtxCallbacks(),
+contextPipes(),
+nParkedPipes(0),
+mtxContext(),
+contextBudget(2.0),
+contextUsage()
 {
 }
 
 ResourceManager::~ResourceManager()
 {
-	// Stop processor
-	processorRunning = false;
-	if (processor.joinable()) processor.detach();
+	stopProcessor();
 }
 
 void ResourceManager::updateContext()
 {
-	// Make sure task is waiting to get executed on context thread
-	if (!contextNext) return;
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start = Clock::now();
+
+	// Queue reloads of evicted resources requested from other threads
+	std::vector<ResourceID> reloads;
+	{
+		std::lock_guard<std::mutex> lock(mtxReloads);
+		reloads.swap(reloadRequests);
+	}
+	for (ResourceID id : reloads) {
+		ResourceRef<Resource> resource = findResource(id);
+		if (resource) queueReload(resource);
+	}
+
+	uint32_t nExecuted = 0;
+	double used = 0.0;
+	double budget = contextBudget.load(std::memory_order_relaxed);
+
+	while (true) {
+		// Take next parked pipe, always executing at least one task per update so uploads never starve
+		QueuedPipe queued;
+		{
+			std::lock_guard<std::mutex> lock(mtxContext);
+			if (contextPipes.empty()) break;
+			if (nExecuted > 0 && used >= budget) break;
+
+			queued = std::move(contextPipes.front());
+			contextPipes.pop_front();
+		}
+
+		// Execute consecutive context thread tasks of pipe while budget is left
+		bool success = true;
+		do {
+			// Stop if resource was released meanwhile
+			if (queued.owner->_resourceState != ResourceState::LOADING) {
+				success = false;
+				break;
+			}
 
-	// Execute context thread task
-	if (contextTask)
-		contextResult = contextTask();
+			ResourceTask task = *queued.pipe->next();
+			success = task.func();
 
-	// Notify pipe processor
-	cvAwaitingContext.notify_all();
+			nExecuted++;
+			used = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		} while (success && queued.pipe->peek() && queued.pipe->peek()->flags & TaskFlags::UseContextThread && used < budget);
+
+		const ResourceTask* next = queued.pipe->peek();
+		if (success && next && next->flags & TaskFlags::UseContextThread) {
+			// Budget exceeded, keep pipe parked for the next update
+			std::lock_guard<std::mutex> lock(mtxContext);
+			contextPipes.push_front(std::move(queued));
+			continue;
+		}
+
+		nParkedPipes--;
+		if (success && next) {
+			// Hand remaining tasks back to the workers, finish pipe if its owner was released meanwhile
+			if (!requeuePipe(std::move(queued))) finishPipe(queued, false);
+		}
+		else {
+			finishPipe(queued, success);
+		}
+	}
+
+	// Publish usage of this update
+	{
+		std::lock_guard<std::mutex> lock(mtxContext);
+		contextUsage.budget = budget;
+		contextUsage.used = used;
+		contextUsage.nExecuted = nExecuted;
+		contextUsage.nPending = 0;
+		for (const QueuedPipe& queued : contextPipes) contextUsage.nPending += queued.pipe->nContextTasks;
+	}
+
+	// Call completion callbacks of finished pipes
+	dispatchCallbacks();
+
+	// Stay within memory budget
+	updateResidency();
 }
 
-bool ResourceManager::exec(ResourcePipe&& pipe)
+void ResourceManager::setMemoryBudget(size_t cpuBytes, size_t gpuBytes)
 {
-	// Start async pipe processing if not running already
-	if (!processorRunning) {
-		processorRunning = true;
-		processor = std::thread(&ResourceManager::asyncPipeProcessor, this);
+	memoryBudget.cpu = cpuBytes;
+	memoryBudget.gpu = gpuBytes;
+}
+
+void ResourceManager::setContextBudget(double milliseconds)
+{
+	contextBudget.store(std::max(milliseconds, 0.0), std::memory_order_relaxed);
+}
+
+bool ResourceManager::setWorkerCount(uint32_t count)
+{
+	// Make sure async pipe processing isn't running yet
+	if (processorRunning) {
+		Console::out::warning("Resource Manager", "Tried to set the worker count, but the async pipe processor is already running");
+		return false;
 	}
 
+	workerCount = std::max(count, 1u);
+	return true;
+}
+
+bool ResourceManager::exec(ResourcePipe&& pipe, ResourcePriority priority)
+{
+	// Start async pipe processing if not running already
+	startProcessor();
+
 	// Ensure owner resource is valid
-	ResourceRef<Resource> resource = getResource(pipe.owner());
+	ResourceRef<Resource> resource = findResource(pipe.owner());
 	if (!resource) {
 		// Pipe owning resource not available
 		Console::out::warning("Resource Manager", "Failed to enqueue execution of pipe, its owner resource with id " + std::to_string(pipe.owner()) + " is invalid");
 		return false;
 	}
 
-	// Try to enqueue the pipe
-	auto pipeHandle = std::make_unique<ResourcePipe>(std::move(pipe));
-	bool success = asyncPipes.try_enqueue(std::move(pipeHandle));
+	// Workers hold on to the pipes owner so they never have to access the resource registry
+	QueuedPipe queued{ resource, std::make_unique<ResourcePipe>(std::move(pipe)), priority };
+	resource->_resourceState = ResourceState::QUEUED;
 
-	// Update resource status if pipe was enqueued
-	if (success) {
-		asyncPipesSize++;
-		resource->_resourceState = ResourceState::QUEUED;
-		cvNextPipe.notify_all();
+	// Wait for dependencies which aren't ready yet, state changes of dependencies are resolved while holding the dependency lock
+	std::unique_lock<std::mutex> lock(mtxDependencies);
+
+	std::vector<ResourceID> pending;
+	std::vector<ResourceRef<Resource>> dependencies;
+	for (ResourceID id : queued.pipe->dependencies) {
+		if (id == resource->resourceId()) {
+			Console::out::warning("Resource Manager", "Resource '" + resource->resourceName() + "' can't depend on itself");
+			continue;
+		}
+
+		// Evicted dependencies are waited for and reloaded once the dependency lock is released
+		ResourceRef<Resource> dependency = findResource(id);
+		if (dependency) dependencies.push_back(dependency);
+		ResourceState state = dependency ? dependency->_resourceState.load() : ResourceState::FAILED;
+		if (state == ResourceState::READY)
+			continue;
+
+		// Fail pipe right away if a dependency is invalid, failed or was never queued, as it would never become ready
+		if (state == ResourceState::FAILED || state == ResourceState::EMPTY) {
+			Console::out::warning("Resource Manager", "Failed to enqueue execution of pipe, dependency with id " + std::to_string(id) + " of resource '" + resource->resourceName() + "' is invalid, failed or wasn't queued");
+			resource->_resourceState = ResourceState::FAILED;
+			resolveDependents(resource->resourceId(), false);
+			lock.unlock();
+			queueCallback(queued, false);
+			return false;
+		}
+
+		pending.push_back(id);
 	}
-	else {
-		resource->_resourceState = ResourceState::FAILED;
+
+	// Wait for pending dependencies
+	bool ready = pending.empty();
+	if (!ready) {
+		std::shared_ptr<WaitingPipe> waiting = std::make_shared<WaitingPipe>();
+		waiting->queued = std::move(queued);
+		waiting->nPending = static_cast<uint32_t>(pending.size());
+		for (ResourceID id : pending)
+			dependents[id].push_back(waiting);
+		nWaiting++;
 	}
 
-	return success;
+	lock.unlock();
+
+	// Mark dependencies as used, reloading evicted ones
+	for (const ResourceRef<Resource>& dependency : dependencies) use(dependency);
+
+	// All dependencies are ready, fail pipes waiting for the owner if it was released meanwhile
+	if (ready && !enqueuePipe(std::move(queued))) {
+		{
+			std::lock_guard<std::mutex> dependencyLock(mtxDependencies);
+			resolveDependents(queued.owner->resourceId(), false);
+		}
+		queueCallback(queued, false);
+	}
+
+	return true;
 }
 
 bool ResourceManager::execAsDependency(ResourcePipe&& pipe)
@@ -78,7 +229,7 @@ bool ResourceManager::execAsDependency(ResourcePipe&& pipe)
 	}
 
 	// Ensure owner resource is valid
-	ResourceRef<Resource> resource = getResource(pipe.owner());
+	ResourceRef<Resource> resource = findResource(pipe.owner());
 	if (!resource) {
 		// Pipe owning resource not available
 		Console::out::warning("Resource Manager", "Failed to synchronously execute pipe, its owner resource with id " + std::to_string(pipe.owner()) + " is invalid");
@@ -86,89 +237,412 @@ bool ResourceManager::execAsDependency(ResourcePipe&& pipe)
 	}
 
 	// Execute each pipe task synchronously
+	bool success = true;
 	while (NextTask nextTask = pipe.next()) {
 		ResourceTask task = *nextTask;
-		bool success = task.func();
-		if (!success) {
-			resource->_resourceState = ResourceState::FAILED;
-			return false;
-		}
+		success = task.func();
+		if (!success) break;
 	}
 
-	// All pipe tasks were executed successfully
-	resource->_resourceState = ResourceState::READY;
-	return true;
+	// Update state and resolve pipes waiting for resource
+	resource->_resourceState = success ? ResourceState::READY : ResourceState::FAILED;
+	resource->footprintChanged();
+	{
+		std::lock_guard<std::mutex> lock(mtxDependencies);
+		resolveDependents(resource->resourceId(), success);
+	}
+
+	// Call completion callback right away
+	if (pipe.callback) pipe.callback(success);
+
+	return success;
 }
 
 void ResourceManager::release(ResourceID id)
 {
-	ResourceRef<Resource> resource = getResource(id);
+	ResourceRef<Resource> resource = findResource(id);
 	if (!resource) 
 		return;
 
-	resource->_resourceState = ResourceState::EMPTY;
-	resources.erase(id);
+	// Cancelled pipes of resource, their callbacks are fired as failed
+	std::vector<QueuedPipe> cancelled;
+	auto cancel = [id, &cancelled](std::deque<QueuedPipe>& queue) {
+		auto it = std::stable_partition(queue.begin(), queue.end(), [id](const QueuedPipe& queued) { return queued.owner->resourceId() != id; });
+		uint32_t nCancelled = static_cast<uint32_t>(std::distance(it, queue.end()));
+		std::move(it, queue.end(), std::back_inserter(cancelled));
+		queue.erase(it, queue.end());
+		return nCancelled;
+	};
+
+	// Cancel queued pipes of resource, pipes being executed stop before their next task
+	{
+		std::lock_guard<std::mutex> lock(mtxPipes);
+		for (auto& queue : asyncPipes) asyncPipesSize -= cancel(queue);
+		resource->_resourceState = ResourceState::EMPTY;
+		resource->footprintChanged();
+	}
+
+	// Cancel pipes of resource parked for the context thread
+	{
+		std::lock_guard<std::mutex> lock(mtxContext);
+		nParkedPipes -= cancel(contextPipes);
+	}
+
+	// Cancel pipes of resource waiting for dependencies and fail pipes waiting for resource
+	{
+		std::lock_guard<std::mutex> lock(mtxDependencies);
+		for (auto& [dependency, waitingPipes] : dependents) {
+			for (std::shared_ptr<WaitingPipe>& waiting : waitingPipes) {
+				if (waiting->resolved || waiting->queued.owner->resourceId() != id) continue;
+				waiting->resolved = true;
+				nWaiting--;
+				cancelled.push_back(std::move(waiting->queued));
+			}
+		}
+		resolveDependents(id, false);
+	}
+
+	for (QueuedPipe& queued : cancelled)
+		queueCallback(queued, false);
+
+	// Keep resource alive until the next context update as lock-free lookups might still use it
+	retiredResources.push_back(resources.remove(id));
+}
+
+void ResourceManager::startProcessor()
+{
+	if (processorRunning) return;
+
+	processorRunning = true;
+	for (uint32_t i = 0; i < workerCount; i++) {
+		workers.emplace_back(&ResourceManager::asyncPipeProcessor, this);
+	}
+}
+
+void ResourceManager::stopProcessor()
+{
+	if (!processorRunning) return;
+
+	{
+		std::lock_guard<std::mutex> lock(mtxPipes);
+		processorRunning = false;
+	}
+	cvNextPipe.notify_all();
+
+	for (std::thread& worker : workers) {
+		if (worker.joinable()) worker.join();
+	}
+	workers.clear();
 }
 
 void ResourceManager::asyncPipeProcessor() {
 
 	while (processorRunning) {
 
-		std::unique_lock lock(mtxProcessor);
+		// Wait for next pipe
+		QueuedPipe queued;
+		{
+			std::unique_lock<std::mutex> lock(mtxPipes);
+			cvNextPipe.wait(lock, [this]() { return !processorRunning || asyncPipesSize > 0; });
+			if (!processorRunning) return;
+			if (!dequeuePipe(queued)) continue;
+			queued.owner->_resourceState = ResourceState::LOADING;
+		}
 
-		// Try to dequeue next pipe
-		std::unique_ptr<ResourcePipe> pipe;
-		bool nextPipe = asyncPipes.try_dequeue(pipe);
+		// Execute pipe until it's done or needs the context thread
+		updateProcessorState(queued.owner->resourceName(), true);
+		PipeResult result = executePipe(queued);
+		updateProcessorState(queued.owner->resourceName(), false);
 
-		if (nextPipe) {
-			asyncPipesSize--;
+		// Park pipe for the context thread and continue with the next pipe instead of blocking
+		if (result == PipeResult::PARKED) {
+			std::lock_guard<std::mutex> lock(mtxContext);
+			contextPipes.push_back(std::move(queued));
+			nParkedPipes++;
+			continue;
+		}
 
-			ResourceRef<Resource> resource = getResource(pipe->owner());
-			if (!resource) {
-				// Pipe owning resource not available
-				Console::out::warning("Resource Manager", "Failed to asynchronously execute pipe, its owner resource with id " + std::to_string(pipe->owner()) + " is invalid");
-				continue;
-			}
+		finishPipe(queued, result == PipeResult::FINISHED);
+	}
 
-			// Update processor state
-			processorState.setLoading(resource->resourceName());
+}
 
-			// Execute each pipe task
-			resource->_resourceState = ResourceState::LOADING;
-			while (NextTask nextTask = pipe->next()) {
-				ResourceTask task = *nextTask;
+ResourceManager::PipeResult ResourceManager::executePipe(QueuedPipe& queued)
+{
+	while (const ResourceTask* next = queued.pipe->peek()) {
+		// Stop if resource was released meanwhile
+		if (queued.owner->_resourceState != ResourceState::LOADING) return PipeResult::FAILED;
 
-				bool success = false;
+		// Context thread tasks are executed by the context thread
+		if (next->flags & TaskFlags::UseContextThread) return PipeResult::PARKED;
 
-				// Execute task on context thread
-				if (task.flags & TaskFlags::UseContextThread) {
-					contextTask = task.func;		// A
-					contextNext = true;				// B
-					cvAwaitingContext.wait(lock);	// C
-					contextNext = false;			// B
-					contextTask = nullptr;			// A
-					success = contextResult;
-				}
-				// Execute task on this thread
-				else {
-					success = task.func();
-				}
+		ResourceTask task = *queued.pipe->next();
+		if (!task.func()) return PipeResult::FAILED;
+	}
+
+	return PipeResult::FINISHED;
+}
+
+void ResourceManager::finishPipe(QueuedPipe& queued, bool success)
+{
+	// Resource might have been released while loading
+	ResourceState expected = ResourceState::LOADING;
+	success = queued.owner->_resourceState.compare_exchange_strong(expected, success ? ResourceState::READY : ResourceState::FAILED) && success;
+	if (success) queued.owner->footprintChanged();
+
+	// Start or fail pipes waiting for resource
+	{
+		std::lock_guard<std::mutex> lock(mtxDependencies);
+		resolveDependents(queued.owner->resourceId(), success);
+	}
+
+	queueCallback(queued, success);
+}
+
+bool ResourceManager::enqueuePipe(QueuedPipe&& queued)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtxPipes);
+
+		// Reject pipe if resource was released while waiting for its dependencies
+		if (queued.owner->_resourceState != ResourceState::QUEUED) return false;
+
+		asyncPipes[static_cast<size_t>(queued.priority)].push_back(std::move(queued));
+		asyncPipesSize++;
+	}
+	cvNextPipe.notify_one();
+	return true;
+}
+
+bool ResourceManager::requeuePipe(QueuedPipe&& queued)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtxPipes);
+
+		// Reject pipe if resource was released meanwhile
+		if (queued.owner->_resourceState != ResourceState::LOADING) return false;
+
+		asyncPipes[static_cast<size_t>(queued.priority)].push_front(std::move(queued));
+		asyncPipesSize++;
+	}
+	cvNextPipe.notify_one();
+	return true;
+}
+
+bool ResourceManager::dequeuePipe(QueuedPipe& queued)
+{
+	// Pick oldest pipe of highest priority
+	for (auto it = asyncPipes.rbegin(); it != asyncPipes.rend(); it++) {
+		if (it->empty()) continue;
+
+		queued = std::move(it->front());
+		it->pop_front();
+		asyncPipesSize--;
+		return true;
+	}
+
+	return false;
+}
+
+void ResourceManager::updateProcessorState(const std::string& name, bool started)
+{
+	std::lock_guard<std::mutex> lock(mtxProcessorState);
+
+	if (started) {
+		processorState.nActiveWorkers++;
+		processorState.name = name;
+		processorState.progress = -1.0f;
+	}
+	else {
+		processorState.nActiveWorkers--;
+	}
+
+	processorState.loading = processorState.nActiveWorkers > 0;
+	if (!processorState.loading) {
+		processorState.name = "";
+		processorState.progress = -1.0f;
+	}
+}
+
+void ResourceManager::reportProgress(const std::string& name, float progress)
+{
+	std::lock_guard<std::mutex> lock(mtxProcessorState);
+
+	processorState.name = name;
+	processorState.progress = progress;
+}
+
+void ResourceManager::resolveDependents(ResourceID id, bool success)
+{
+	// Expects the dependency lock to be held, failures are propagated through the whole graph iteratively
+	std::vector<std::pair<ResourceID, bool>> resolved = { { id, success } };
+	std::vector<QueuedPipe> ready;
+	std::vector<QueuedPipe> failed;
+
+	do {
+		while (!resolved.empty()) {
+			auto [current, currentSuccess] = resolved.back();
+			resolved.pop_back();
+
+			auto it = dependents.find(current);
+			if (it == dependents.end()) continue;
 
-				if (!success) {
-					resource->_resourceState = ResourceState::FAILED;
+			std::vector<std::shared_ptr<WaitingPipe>> waitingPipes = std::move(it->second);
+			dependents.erase(it);
+
+			for (std::shared_ptr<WaitingPipe>& waiting : waitingPipes) {
+				// Pipe was queued or failed by another dependency already
+				if (waiting->resolved) continue;
+
+				// Wait for remaining dependencies
+				if (currentSuccess && --waiting->nPending > 0) continue;
+
+				waiting->resolved = true;
+				nWaiting--;
+
+				if (currentSuccess) {
+					ready.push_back(std::move(waiting->queued));
 					continue;
 				}
+
+				// Dependency failed, fail pipe and everything depending on its owner
+				ResourceState expected = ResourceState::QUEUED;
+				waiting->queued.owner->_resourceState.compare_exchange_strong(expected, ResourceState::FAILED);
+				resolved.push_back({ waiting->queued.owner->resourceId(), false });
+				failed.push_back(std::move(waiting->queued));
 			}
+		}
 
-			// Check if all tasks executed successfully
-			if (resource->_resourceState != ResourceState::FAILED)
-				resource->_resourceState = ResourceState::READY;
+		// Pipes whose owner was released meanwhile are rejected, fail them and everything depending on their owner
+		for (QueuedPipe& queued : ready) {
+			if (enqueuePipe(std::move(queued))) continue;
+
+			resolved.push_back({ queued.owner->resourceId(), false });
+			failed.push_back(std::move(queued));
 		}
-		else {
-			processorState.setSleeping();
-			cvNextPipe.wait(lock);
+		ready.clear();
+	} while (!resolved.empty());
+
+	for (QueuedPipe& queued : failed)
+		queueCallback(queued, false);
+}
+
+void ResourceManager::queueCallback(QueuedPipe& queued, bool success)
+{
+	if (!queued.pipe || !queued.pipe->callback) return;
+
+	std::lock_guard<std::mutex> lock(mtxCallbacks);
+	callbacks.emplace_back(std::move(queued.pipe->callback), success);
+}
+
+void ResourceManager::dispatchCallbacks()
+{
+	// Take callbacks first so they can queue further pipes
+	std::vector<std::pair<ResourceCallback, bool>> pending;
+	{
+		std::lock_guard<std::mutex> lock(mtxCallbacks);
+		pending.swap(callbacks);
+	}
+
+	for (auto& [callback, success] : pending)
+		callback(success);
+}
+
+ResourceRef<Resource> ResourceManager::findResource(ResourceID id) const
+{
+	const ResourceRef<Resource>* resource = resources.findRef(id);
+	return resource ? *resource : nullptr;
+}
+
+void ResourceManager::use(const ResourceRef<Resource>& resource)
+{
+	uint64_t currentFrame = frame.load(std::memory_order_relaxed);
+	if (resource->_resourceLastUsed.load(std::memory_order_relaxed) != currentFrame) resource->_resourceLastUsed.store(currentFrame, std::memory_order_relaxed);
+
+	// Recreate evicted resource transparently
+	if (claimReload(resource.get())) queueReload(resource);
+}
+
+bool ResourceManager::claimReload(Resource* resource) const
+{
+	// Plain load first, resources are rarely evicted and the compare exchange always takes the cache line exclusively
+	ResourceState expected = ResourceState::EVICTED;
+	if (resource->_resourceState.load(std::memory_order_relaxed) != expected) return false;
+	return resource->_resourceState.compare_exchange_strong(expected, ResourceState::QUEUED);
+}
+
+void ResourceManager::queueReload(const ResourceRef<Resource>& resource)
+{
+	memoryUsage.nReloads++;
+	exec(resource->reload(), ResourcePriority::IMMEDIATE);
+}
+
+void ResourceManager::requestReload(Resource* resource) const
+{
+	if (!claimReload(resource)) return;
+
+	std::lock_guard<std::mutex> lock(mtxReloads);
+	reloadRequests.push_back(resource->resourceId());
+}
+
+void ResourceManager::updateResidency()
+{
+	uint64_t currentFrame = ++frame;
+
+	// Resources released before this update aren't referenced by lookups anymore
+	retiredResources.clear();
+
+	// Sum up memory held by ready resources
+	ResourceFootprint used;
+	uint32_t nEvicted = 0;
+	resources.each([&](ResourceID, const ResourceRef<Resource>& resource) {
+		ResourceState state = resource->_resourceState;
+		if (state == ResourceState::EVICTED) nEvicted++;
+		if (state != ResourceState::READY) return;
+
+		// Only query footprints of resources that were loaded or changed since
+		if (resource->_resourceFootprintOutdated.load(std::memory_order_relaxed)) {
+			resource->_resourceFootprintOutdated = false;
+			resource->_resourceFootprint = resource->footprint();
 		}
 
+		used.cpu += resource->_resourceFootprint.cpu;
+		used.gpu += resource->_resourceFootprint.gpu;
+	});
+
+	auto exceeded = [this](const ResourceFootprint& used) {
+		return (memoryBudget.cpu && used.cpu > memoryBudget.cpu) || (memoryBudget.gpu && used.gpu > memoryBudget.gpu);
+	};
+
+	if (exceeded(used)) {
+		// Gather ready resources only referenced by the manager which weren't used this frame
+		std::vector<std::pair<uint64_t, Resource*>> candidates;
+		resources.each([&](ResourceID, const ResourceRef<Resource>& resource) {
+			if (resource->_resourceState != ResourceState::READY) return;
+			if (resource.use_count() > 1) return;
+			uint64_t lastUsed = resource->_resourceLastUsed.load(std::memory_order_relaxed);
+			if (lastUsed + 1 >= currentFrame) return;
+			candidates.emplace_back(lastUsed, resource.get());
+		});
+
+		// Evict least recently used resources first until budget is met
+		std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (auto [lastUsed, resource] : candidates) {
+			if (!exceeded(used)) break;
+
+			if (!resource->evict()) continue;
+
+			resource->_resourceState = ResourceState::EVICTED;
+			used.cpu -= resource->_resourceFootprint.cpu;
+			used.gpu -= resource->_resourceFootprint.gpu;
+			resource->_resourceFootprint = ResourceFootprint();
+			resource->footprintChanged();
+			nEvicted++;
+		}
 	}
 
+	// Publish memory usage
+	memoryUsage.budget = memoryBudget;
+	memoryUsage.used = used;
+	memoryUsage.nEvicted = nEvicted;
 }
\ No newline at end of file
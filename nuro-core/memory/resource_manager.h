@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 #include <atomic>
 #include <memory>
 #include <utility>
@@ -12,122 +15,317 @@
 #include <utils/console.h>
 #include <memory/resource.h>
 #include <memory/resource_pipe.h>
-#include <utils/concurrent_queue.h>
+#include <memory/resource_handle.h>
+#include <memory/resource_registry.h>
 
 template <typename T>
 using ResourceRef = std::shared_ptr<T>;
 
+// Priority of a queued resource pipe, higher priorities are executed first
+enum class ResourcePriority : uint32_t {
+	PREFETCH, // Resource might be needed soon
+	NORMAL, // Resource is needed
+	IMMEDIATE, // Resource is needed right now (e.g. currently visible)
+	COUNT
+};
+
 class ResourceManager
 {
 public:
 	ResourceManager();
 	~ResourceManager();
 
-	// Updates the resource manager from the context thread
+	// Updates the resource manager from the context thread, executing queued context thread tasks within the context budget, calling completion callbacks and enforcing the memory budget
 	void updateContext();
 
-	// Queues the execution of a resource pipe for asynchronous execution
-	bool exec(ResourcePipe&& pipe);
+	// Sets the cpu and gpu memory in bytes ready resources may hold (zero for unlimited), least recently used resources only referenced by the manager are evicted once exceeded
+	void setMemoryBudget(size_t cpuBytes, size_t gpuBytes);
+
+	// Memory held by ready resources
+	struct MemoryUsage {
+		ResourceFootprint budget; // Budget in bytes, zero if unlimited
+		ResourceFootprint used; // Memory held by ready resources in bytes
+		uint32_t nEvicted = 0; // Amount of resources currently evicted
+		uint32_t nReloads = 0; // Amount of evicted resources reloaded so far
+	};
+
+	// Returns the memory held by ready resources as of the last update
+	MemoryUsage readMemoryUsage() const {
+		return memoryUsage;
+	}
+
+	// Sets the time in milliseconds context thread tasks may take per update (at least one task is executed per update)
+	void setContextBudget(double milliseconds);
+
+	// Context thread task execution of the last update
+	struct ContextUsage {
+		double budget = 0.0; // Budget in milliseconds
+		double used = 0.0; // Time used in milliseconds
+		uint32_t nExecuted = 0; // Amount of tasks executed
+		uint32_t nPending = 0; // Amount of context thread tasks of parked pipes left for upcoming updates
+	};
+
+	// Returns the context thread task execution of the last update
+	ContextUsage readContextUsage() {
+		std::lock_guard<std::mutex> lock(mtxContext);
+		return contextUsage;
+	}
+
+	// Sets the amount of worker threads executing pipes concurrently, only possible until the first pipe was queued for asynchronous execution
+	bool setWorkerCount(uint32_t count);
+
+	// Queues the execution of a resource pipe for asynchronous execution with the given priority, waiting until all of its dependencies are ready (dependencies must not form cycles)
+	bool exec(ResourcePipe&& pipe, ResourcePriority priority = ResourcePriority::NORMAL);
 
 	// Executes a resource pipe synchronously, only possible until the first pipe was queued for asynchronous execution
 	bool execAsDependency(ResourcePipe&& pipe);
 
 	// Creates a new resource (lifetime managed by resource manager)
 	template <typename T, typename... Args>
-	std::pair<ResourceID, ResourceRef<T>> create(const std::string& name, Args&&... args) {
+	std::pair<ResourceHandle<T>, ResourceRef<T>> create(const std::string& name, Args&&... args) {
 		static_assert(std::is_base_of<Resource, T>::value, "Only classes that derive from Resource are valid for allocation");
 
-		// Create and return resource
-		ResourceID id = ++idCounter;
-		const auto& result = resources.emplace(id, std::make_shared<T>(std::forward<Args>(args)...));
-		auto& resource = result.first->second;
+		// Register resource
+		ResourceRef<T> resource = std::make_shared<T>(std::forward<Args>(args)...);
+		ResourceID id = resources.insert(resource);
+		if (!id) {
+			Console::out::warning("Resource Manager", "Failed to create resource '" + name + "', the resource registry is full");
+			return std::make_pair(ResourceHandle<T>(), nullptr);
+		}
+
+		// Initialize and return resource
 		resource->_resourceId = id;
 		resource->_resourceName = name;
-		return std::make_pair(id, std::static_pointer_cast<T>(resource));
+		resource->_resourceLastUsed = frame.load(std::memory_order_relaxed);
+		return std::make_pair(ResourceHandle<T>(id), resource);
 	}
 
-	// Retrieves an optional resource handle for a resource base by resource id, nullptr if none
+	// Returns the resource a typed handle refers to without touching its reference count, nullptr if it was released; safe from any thread, the pointer stays valid until the next context update
+	// An evicted resource is returned as is and reloaded starting with the next context update
+	template <typename T>
+	T* get(ResourceHandle<T> handle) const {
+		static_assert(std::is_base_of<Resource, T>::value, "Only classes that derive from Resource are retrievable");
+
+		Resource* resource = resources.find(handle.id);
+		if (resource) {
+			// Only write the shared cache line once per frame
+			uint64_t currentFrame = frame.load(std::memory_order_relaxed);
+			if (resource->_resourceLastUsed.load(std::memory_order_relaxed) != currentFrame) resource->_resourceLastUsed.store(currentFrame, std::memory_order_relaxed);
+			requestReload(resource);
+		}
+		return static_cast<T*>(resource);
+	}
+
+	// Retrieves an optional resource handle for a resource base by resource id, nullptr if none; reloads the resource if it was evicted (main thread only)
 	ResourceRef<Resource> getResource(ResourceID id) {
 		// Find resource
-		auto it = resources.find(id);
-		if (it != resources.end())
-			return it->second;
+		const ResourceRef<Resource>* resource = resources.findRef(id);
+		if (resource) {
+			use(*resource);
+			return *resource;
+		}
 
 		// Resource not found
 		return nullptr;
 	}
 
-	// Retrieves an optional handle for a derived type T of resource by resource id, nullptr if none
+	// Retrieves an optional handle for a derived type T of resource by resource id, nullptr if none; reloads the resource if it was evicted (main thread only)
 	template <typename T>
 	ResourceRef<T> getResourceAs(ResourceID id) {
 		static_assert(std::is_base_of<Resource, T>::value, "Only classes that derive from Resource are retrievable");
 
 		// Find resource
-		auto it = resources.find(id);
-		if (it != resources.end())
-			return std::static_pointer_cast<T>(it->second);
+		const ResourceRef<Resource>* resource = resources.findRef(id);
+		if (resource) {
+			use(*resource);
+			return std::static_pointer_cast<T>(*resource);
+		}
 
 		// Resource not found
 		return nullptr;
 	}
 
-	// Unregisters a resource, it will be released once its not used anymore
+	// Unregisters a resource and cancels its queued pipes firing their callbacks as failed, it will be released once its not used anymore
 	void release(ResourceID id);
 
 	// State of the async pipe processor
 	struct ProcessorState {
-		bool loading;
+		bool loading = false;
 		std::string name;
-
-		void setSleeping() { loading = false; name = ""; }
-		void setLoading(std::string name) { loading = true; this->name = name; }
+		uint32_t nActiveWorkers = 0;
+		float progress = -1.0f; // Progress of the named resource from zero to one, negative if unknown
 	};
 
 	// Returns the current state of the processor
-	const ProcessorState& readProcessorState() {
-		return processorState;
+	ProcessorState readProcessorState() {
+		std::lock_guard<std::mutex> lock(mtxProcessorState);
+		ProcessorState state = processorState;
+		state.loading = state.loading || nParkedPipes > 0;
+		return state;
 	}
 
+	// Reports the load progress from zero to one of a resource being processed, shown as the processor state (thread safe)
+	void reportProgress(const std::string& name, float progress);
+
 	// Returns the amount of pipes awaiting execution
 	uint32_t nQueuedPipes() {
 		return asyncPipesSize;
 	}
 
+	// Returns the amount of pipes waiting for their dependencies
+	uint32_t nWaitingPipes() {
+		return nWaiting;
+	}
+
 	//
 	// TEMPORARY!
 	//
 
-	const auto& readResources() {
+	const ResourceRegistry& readResources() {
 		return resources;
 	}
 
 private:
-	// Counter for unique resource ids throughout application lifetime
-	ResourceID idCounter;
-
 	// Registry mapping a resource id to its resource reference
-	std::unordered_map<ResourceID, ResourceRef<Resource>> resources;
+	ResourceRegistry resources;
+
+	// Released resources kept alive until the next context update, so pointers returned by get() stay valid until then
+	std::vector<ResourceRef<Resource>> retiredResources;
+
+	//
+	// RESIDENCY
+	//
+
+	// Current frame, counted by context updates
+	std::atomic<uint64_t> frame;
+
+	// Memory budget, zero if unlimited
+	ResourceFootprint memoryBudget;
+
+	// Memory held by ready resources as of the last update
+	MemoryUsage memoryUsage;
+
+	// Returns the reference of a resource without marking it as used, nullptr if none
+	ResourceRef<Resource> findResource(ResourceID id) const;
+
+	// Marks a resource as used in the current frame, reloading it if it was evicted
+	void use(const ResourceRef<Resource>& resource);
+
+	// Claims an evicted resource for reloading, returns false if it isn't evicted (thread safe)
+	bool claimReload(Resource* resource) const;
+
+	// Queues the pipe recreating a resource claimed for reloading
+	void queueReload(const ResourceRef<Resource>& resource);
+
+	// Claims an evicted resource for reloading and defers queueing its pipe to the next context update (thread safe)
+	void requestReload(Resource* resource) const;
+
+	// Ids of resources claimed for reloading from other threads
+	mutable std::vector<ResourceID> reloadRequests;
+	mutable std::mutex mtxReloads;
+
+	// Updates the memory usage and evicts least recently used resources until the budget is met
+	void updateResidency();
 
 	//
 	// RESOURCE PIPE PROCESSING
 	//
 
-	// Resource pipes queued for async execution
-	ConcurrentQueue<std::unique_ptr<ResourcePipe>> asyncPipes;
+	// Resource pipe queued for async execution together with its owner
+	struct QueuedPipe {
+		ResourceRef<Resource> owner;
+		std::unique_ptr<ResourcePipe> pipe;
+		ResourcePriority priority = ResourcePriority::NORMAL;
+	};
+
+	// Result of executing a pipe on a worker
+	enum class PipeResult {
+		FINISHED, // All tasks were executed successfully
+		FAILED, // A task failed or the resource was released
+		PARKED // Pipe waits for the context thread to execute its next task
+	};
+
+	// Queued resource pipes, one first in first out queue per priority
+	std::array<std::deque<QueuedPipe>, static_cast<size_t>(ResourcePriority::COUNT)> asyncPipes;
 	std::atomic<uint32_t> asyncPipesSize;
+	std::mutex mtxPipes;
+	std::condition_variable cvNextPipe;
 
-	// Processes pending async pipes
+	// Starts the worker threads if not running already
+	void startProcessor();
+
+	// Stops and joins the worker threads
+	void stopProcessor();
+
+	// Processes pending async pipes, executed by each worker
 	void asyncPipeProcessor();
 
+	// Executes the tasks of a pipe until it finishes, fails or reaches a context thread task
+	PipeResult executePipe(QueuedPipe& queued);
+
+	// Finishes a pipe, updating its owners state if it wasn't released meanwhile and resolving its dependents
+	void finishPipe(QueuedPipe& queued, bool success);
+
+	// Queues a pipe whose dependencies are ready for the workers, returns false and leaves the pipe untouched if its owner was released
+	bool enqueuePipe(QueuedPipe&& queued);
+
+	// Re-queues a pipe with remaining tasks for the workers, ahead of pipes with the same priority, returns false and leaves the pipe untouched if its owner was released
+	bool requeuePipe(QueuedPipe&& queued);
+
+	// Dequeues the queued pipe with the highest priority, returns false if none is available
+	bool dequeuePipe(QueuedPipe& queued);
+
 	std::atomic<bool> processorRunning;
-	std::thread processor;
-	std::mutex mtxProcessor;
+	uint32_t workerCount;
+	std::vector<std::thread> workers;
+
+	std::mutex mtxProcessorState;
 	ProcessorState processorState;
 
-	std::condition_variable cvNextPipe;
-	std::condition_variable cvAwaitingContext;
+	// Updates the processor state after a worker started or finished loading a resource
+	void updateProcessorState(const std::string& name, bool started);
+
+	//
+	// DEPENDENCIES
+	//
+
+	// Pipe waiting for its dependencies to be ready
+	struct WaitingPipe {
+		QueuedPipe queued;
+		uint32_t nPending = 0; // Amount of dependencies which aren't ready yet
+		bool resolved = false; // Pipe was queued or failed already
+	};
+
+	// Pipes waiting for a resource by the id of that resource
+	std::unordered_map<ResourceID, std::vector<std::shared_ptr<WaitingPipe>>> dependents;
+	std::atomic<uint32_t> nWaiting;
+	std::mutex mtxDependencies;
+
+	// Queues the pipes waiting for the resource with the given id once all their dependencies are ready or fails them and their dependents
+	void resolveDependents(ResourceID id, bool success);
+
+	// Completion callbacks awaiting their call on the context thread
+	std::vector<std::pair<ResourceCallback, bool>> callbacks;
+	std::mutex mtxCallbacks;
+
+	// Queues the completion callback of a pipe if it has one
+	void queueCallback(QueuedPipe& queued, bool success);
+
+	// Calls all queued completion callbacks
+	void dispatchCallbacks();
+
+	//
+	// CONTEXT THREAD TASKS
+	//
+
+	// Pipes parked until the context thread executed their next task
+	std::deque<QueuedPipe> contextPipes;
+	std::atomic<uint32_t> nParkedPipes;
+	std::mutex mtxContext;
+
+	// Time context thread tasks may take per update in milliseconds, set from any thread
+	std::atomic<double> contextBudget;
 
-	std::atomic<bool> contextNext;
-	std::atomic<bool> contextResult;
-	ResourceTask::TaskFunc contextTask;
+	// Context thread task execution of the last update
+	ContextUsage contextUsage;
 };
\ No newline at end of file
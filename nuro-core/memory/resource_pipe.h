@@ -2,6 +2,7 @@
 
 #include <queue>
 #include <atomic>
+#include <vector>
 #include <cstdint>
 #include <optional>
 #include <functional>
@@ -40,6 +41,9 @@ private:
 	// Only the resource manager should be able to access and execute the function associated with a task
 	friend class ResourceManager;
 
+	// Pipes count their context thread tasks by flags
+	friend class ResourcePipe;
+
 	// Function that defines the task to be executed, returns success
 	TaskFunc func;
 
@@ -49,10 +53,18 @@ private:
 
 using NextTask = std::optional<ResourceTask>;
 
+// Callback fired on the context thread once a pipe finished, receives if the pipe succeeded
+using ResourceCallback = std::function<void(bool success)>;
+
 class ResourcePipe {
 public:
 
-	ResourcePipe(ResourcePipe&& other) noexcept : ownerId(other.ownerId), tasks(std::move(other.tasks)) {
+	ResourcePipe(ResourcePipe&& other) noexcept : ownerId(other.ownerId),
+		tasks(std::move(other.tasks)),
+		nContextTasks(other.nContextTasks),
+		dependencies(std::move(other.dependencies)),
+		callback(std::move(other.callback))
+	{
 		other.ownerId = 0;
 	};
 
@@ -60,6 +72,9 @@ public:
 		if (this != &other) {
 			ownerId = other.ownerId;
 			tasks = std::move(other.tasks);
+			nContextTasks = other.nContextTasks;
+			dependencies = std::move(other.dependencies);
+			callback = std::move(other.callback);
 			other.ownerId = 0;
 		}
 		return *this;
@@ -70,6 +85,7 @@ public:
 
 	// Adds a resource task to the pipe
 	ResourcePipe& operator>>(ResourceTask&& task) {
+		if (task.flags & TaskFlags::UseContextThread) nContextTasks++;
 		tasks.emplace(task);
 		return *this;
 	}
@@ -79,9 +95,28 @@ public:
 		if (tasks.empty()) return std::nullopt;
 		NextTask task = std::move(tasks.front());
 		tasks.pop();
+		if (task->flags & TaskFlags::UseContextThread) nContextTasks--;
 		return task;
 	}
 
+	// Returns the next task in the pipe without removing it, nullptr if there is none
+	const ResourceTask* peek() const {
+		if (tasks.empty()) return nullptr;
+		return &tasks.front();
+	}
+
+	// Makes the pipe wait for the resource with the given id to be ready before executing, the pipe fails if the dependency fails or wasn't queued before
+	ResourcePipe& dependsOn(uint32_t resourceId) {
+		dependencies.push_back(resourceId);
+		return *this;
+	}
+
+	// Sets the callback fired on the context thread once the pipe finished, it's fired as failed if the owner is released before
+	ResourcePipe& onComplete(ResourceCallback _callback) {
+		callback = std::move(_callback);
+		return *this;
+	}
+
 	// Returns the id of the resource owning the pipe
 	uint32_t owner() {
 		return ownerId;
@@ -90,11 +125,23 @@ public:
 private:
 	// Resource pipe should always be related to a resource and thus is only constructible by a resource base
 	friend class Resource;
-	explicit ResourcePipe(uint32_t ownerId) : ownerId(ownerId), tasks() {};
+	explicit ResourcePipe(uint32_t ownerId) : ownerId(ownerId), tasks(), nContextTasks(0), dependencies(), callback() {};
+
+	// Only the resource manager should be able to resolve the dependencies and callback of a pipe
+	friend class ResourceManager;
 
 	// Resource id of the resource owning this pipe
 	uint32_t ownerId;
 
 	// Queue of tasks to be executed
 	std::queue<ResourceTask> tasks;
+
+	// Amount of queued tasks executed on the context thread
+	uint32_t nContextTasks;
+
+	// Ids of the resources which have to be ready before the pipe is executed
+	std::vector<uint32_t> dependencies;
+
+	// Callback fired once the pipe finished
+	ResourceCallback callback;
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "resource_registry.h"
+
+ResourceRegistry::ResourceRegistry() : chunks(),
+freeIndices(),
+nextIndex(0),
+count(0),
+mtx()
+{
+	for (auto& chunk : chunks)
+		chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+ResourceRegistry::~ResourceRegistry()
+{
+	for (auto& chunk : chunks)
+		delete[] chunk.load(std::memory_order_relaxed);
+}
+
+ResourceID ResourceRegistry::insert(std::shared_ptr<Resource> resource)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+
+	// Reuse a freed slot or take the next unused one
+	uint32_t index;
+	if (!freeIndices.empty()) {
+		index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else {
+		if (nextIndex > INDEX_MASK) return 0;
+		index = nextIndex;
+
+		// Allocate slot chunk on first use
+		std::atomic<Slot*>& chunk = chunks[index / CHUNK_SIZE];
+		if (!chunk.load(std::memory_order_relaxed))
+			chunk.store(new Slot[CHUNK_SIZE], std::memory_order_release);
+
+		nextIndex++;
+	}
+
+	Slot& slot = chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed)[index % CHUNK_SIZE];
+	ResourceID id = (slot.generation << INDEX_BITS) | index;
+
+	// Publish resource before its id so readers matching the id always see it
+	slot.owner = std::move(resource);
+	slot.resource.store(slot.owner.get(), std::memory_order_release);
+	slot.id.store(id, std::memory_order_release);
+
+	count++;
+	return id;
+}
+
+std::shared_ptr<Resource> ResourceRegistry::remove(ResourceID id)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+
+	Slot* slot = slotOf(id);
+	if (!slot || slot->id.load(std::memory_order_relaxed) != id) return nullptr;
+
+	// Invalidate id before clearing the resource so readers never see a foreign resource
+	slot->id.store(0, std::memory_order_release);
+	slot->resource.store(nullptr, std::memory_order_release);
+	std::shared_ptr<Resource> owner = std::move(slot->owner);
+
+	// Bump generation, skipping zero so ids are never zero
+	slot->generation = (slot->generation + 1) & GENERATION_MASK;
+	if (!slot->generation) slot->generation = 1;
+
+	freeIndices.push_back(id & INDEX_MASK);
+	count--;
+	return owner;
+}
+
+Resource* ResourceRegistry::find(ResourceID id) const
+{
+	const Slot* slot = slotOf(id);
+	if (!slot || slot->id.load(std::memory_order_acquire) != id) return nullptr;
+
+	// Validate the id again, the slot might have been reused while reading
+	Resource* resource = slot->resource.load(std::memory_order_acquire);
+	if (slot->id.load(std::memory_order_acquire) != id) return nullptr;
+	return resource;
+}
+
+const std::shared_ptr<Resource>* ResourceRegistry::findRef(ResourceID id) const
+{
+	const Slot* slot = slotOf(id);
+	if (!slot || slot->id.load(std::memory_order_acquire) != id) return nullptr;
+	return &slot->owner;
+}
+
+uint32_t ResourceRegistry::size() const
+{
+	return count;
+}
+
+ResourceRegistry::Slot* ResourceRegistry::slotOf(ResourceID id) const
+{
+	if (!id) return nullptr;
+
+	uint32_t index = id & INDEX_MASK;
+	Slot* chunk = chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+	if (!chunk) return nullptr;
+	return &chunk[index % CHUNK_SIZE];
+}
\ No newline at end of file
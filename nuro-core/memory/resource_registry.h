@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include <memory/resource.h>
+
+// Generational slot map of resources; lookups are lock-free and safe from any thread, insertion and removal are serialized
+class ResourceRegistry
+{
+public:
+	// Bits of a resource id addressing its slot, the remaining bits hold the slots generation
+	static constexpr uint32_t INDEX_BITS = 20;
+	static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	// Slots are allocated in chunks which never move once published
+	static constexpr uint32_t CHUNK_SIZE = 1024;
+	static constexpr uint32_t MAX_CHUNKS = (INDEX_MASK + 1) / CHUNK_SIZE;
+
+	ResourceRegistry();
+	~ResourceRegistry();
+
+	ResourceRegistry(const ResourceRegistry&) = delete;
+	ResourceRegistry& operator=(const ResourceRegistry&) = delete;
+
+	// Inserts a resource and returns its id (never zero), zero if the registry is full
+	ResourceID insert(std::shared_ptr<Resource> resource);
+
+	// Removes the resource with the given id and returns its reference, all handles to it become invalid
+	std::shared_ptr<Resource> remove(ResourceID id);
+
+	// Returns the resource with the given id without touching its reference count, nullptr if none
+	Resource* find(ResourceID id) const;
+
+	// Returns the owning reference of the resource with the given id, nullptr if none (main thread only)
+	const std::shared_ptr<Resource>* findRef(ResourceID id) const;
+
+	// Returns the amount of registered resources
+	uint32_t size() const;
+
+	// Calls the given function with the id and reference of each registered resource (main thread only)
+	template <typename Func>
+	void each(Func&& func) const {
+		uint32_t end = nextIndex;
+		for (uint32_t index = 0; index < end; index++) {
+			const Slot& slot = chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+			ResourceID id = slot.id.load(std::memory_order_acquire);
+			if (id) func(id, slot.owner);
+		}
+	}
+
+private:
+	struct Slot {
+		std::atomic<ResourceID> id{ 0 }; // Id of the resource occupying the slot, zero if empty
+		std::atomic<Resource*> resource{ nullptr }; // Resource occupying the slot
+		std::shared_ptr<Resource> owner; // Reference keeping the resource alive
+		uint32_t generation = 1; // Generation of the next resource occupying the slot
+	};
+
+	// Returns the slot addressed by the given id, nullptr if its chunk wasn't allocated
+	Slot* slotOf(ResourceID id) const;
+
+	std::array<std::atomic<Slot*>, MAX_CHUNKS> chunks;
+
+	// Slots freed by removed resources
+	std::vector<uint32_t> freeIndices;
+
+	// Index of the first slot never used so far
+	uint32_t nextIndex;
+
+	std::atomic<uint32_t> count;
+	std::mutex mtx;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "staging_ring.h"
+
+#include <glad/glad.h>
+
+#include <utils/console.h>
+
+StagingRing::StagingRing() : _backendId(0),
+mapped(nullptr),
+_capacity(0),
+head(0),
+idCounter(0),
+regions(),
+mtx()
+{
+}
+
+StagingRing::~StagingRing()
+{
+	// Backend resources are released by destroy() while the context is still alive
+}
+
+void StagingRing::create(size_t capacity)
+{
+	if (_backendId) return;
+
+	// Create immutable staging buffer storage which stays mapped for its whole lifetime
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &_backendId);
+	glBindBuffer(GL_COPY_READ_BUFFER, _backendId);
+	glBufferStorage(GL_COPY_READ_BUFFER, capacity, nullptr, flags);
+	mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, capacity, flags));
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+	// Mapping failed, uploads fall back to direct transfers
+	if (!mapped) {
+		Console::out::warning("Staging Ring", "Couldn't map staging buffer, uploads will not be staged");
+		glDeleteBuffers(1, &_backendId);
+		_backendId = 0;
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	_capacity = capacity;
+	head = 0;
+}
+
+void StagingRing::destroy()
+{
+	if (!_backendId) return;
+
+	std::lock_guard<std::mutex> lock(mtx);
+
+	// Wait for pending copies before releasing the memory they read from
+	for (Region& region : regions) {
+		if (!region.fence) continue;
+		GLsync fence = static_cast<GLsync>(region.fence);
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+		glDeleteSync(fence);
+	}
+	regions.clear();
+
+	// Unmap and delete staging buffer
+	glBindBuffer(GL_COPY_READ_BUFFER, _backendId);
+	glUnmapBuffer(GL_COPY_READ_BUFFER);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glDeleteBuffers(1, &_backendId);
+
+	_backendId = 0;
+	mapped = nullptr;
+	_capacity = 0;
+	head = 0;
+}
+
+StagingRing::Allocation StagingRing::allocate(size_t size, size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+
+	if (!mapped || size == 0 || size >= _capacity) return Allocation();
+
+	// Restart at the beginning once the ring is empty
+	if (regions.empty()) head = 0;
+
+	// Find free range behind head, wrapping around if the end of the ring is too small
+	size_t offset = (head + alignment - 1) / alignment * alignment;
+	if (!regions.empty()) {
+		size_t tail = regions.front().offset;
+		if (head >= tail) {
+			// Free ranges are [head, capacity) and [0, tail)
+			if (offset + size > _capacity) {
+				if (size >= tail) return Allocation();
+				offset = 0;
+			}
+		}
+		else {
+			// Free range is [head, tail), never fill it completely to keep head and tail distinguishable
+			if (offset + size >= tail) return Allocation();
+		}
+	}
+	else if (offset + size > _capacity) {
+		offset = 0;
+	}
+
+	// Reserve region
+	Region region;
+	region.id = ++idCounter;
+	region.offset = offset;
+	region.size = size;
+	regions.push_back(region);
+	head = offset + size;
+
+	Allocation allocation;
+	allocation.id = region.id;
+	allocation.offset = offset;
+	allocation.size = size;
+	allocation.data = mapped + offset;
+	return allocation;
+}
+
+void StagingRing::submit(Allocation& allocation)
+{
+	if (!allocation.valid()) return;
+
+	std::lock_guard<std::mutex> lock(mtx);
+
+	// Fence all copy commands issued so far
+	if (Region* region = findRegion(allocation)) {
+		region->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		region->released = true;
+	}
+	allocation = Allocation();
+}
+
+void StagingRing::discard(Allocation& allocation)
+{
+	if (!allocation.valid()) return;
+
+	std::lock_guard<std::mutex> lock(mtx);
+
+	if (Region* region = findRegion(allocation))
+		region->released = true;
+	allocation = Allocation();
+}
+
+void StagingRing::reclaim()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+
+	// Regions are reused in allocation order, stop at the first one still in use
+	while (!regions.empty()) {
+		Region& region = regions.front();
+		if (!region.released) break;
+
+		if (region.fence) {
+			GLsync fence = static_cast<GLsync>(region.fence);
+			GLenum status = glClientWaitSync(fence, 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+			glDeleteSync(fence);
+		}
+
+		regions.pop_front();
+	}
+}
+
+uint32_t StagingRing::backendId() const
+{
+	return _backendId;
+}
+
+size_t StagingRing::capacity() const
+{
+	return _capacity;
+}
+
+size_t StagingRing::used()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+
+	if (regions.empty()) return 0;
+
+	size_t tail = regions.front().offset;
+	if (head > tail) return head - tail;
+	return _capacity - tail + head;
+}
+
+StagingRing::Region* StagingRing::findRegion(const Allocation& allocation)
+{
+	// Region ids are consecutive in allocation order
+	if (regions.empty() || allocation.id < regions.front().id) return nullptr;
+
+	size_t index = allocation.id - regions.front().id;
+	if (index >= regions.size()) return nullptr;
+	return &regions[index];
+}
\ No newline at end of file
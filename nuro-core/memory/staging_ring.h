@@ -0,0 +1,85 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+class StagingRing
+{
+public:
+	// Staging memory reserved within the ring
+	struct Allocation {
+		uint64_t id = 0; // Unique id of the allocation, zero if invalid
+		size_t offset = 0; // Offset of the allocation within the staging buffer
+		size_t size = 0; // Size of the allocation in bytes
+		uint8_t* data = nullptr; // Persistently mapped memory of the allocation
+
+		// Returns if the allocation holds staging memory
+		bool valid() const {
+			return id != 0;
+		}
+	};
+
+	StagingRing();
+	~StagingRing();
+
+	// Creates the persistently mapped staging buffer with the given capacity in bytes (context thread only)
+	void create(size_t capacity);
+
+	// Waits for all pending copies and destroys the staging buffer (context thread only)
+	void destroy();
+
+	// Reserves staging memory which can be written from any thread, returns an invalid allocation if the ring is full
+	Allocation allocate(size_t size, size_t alignment = 16);
+
+	// Fences an allocation after copy commands reading from it were issued, its memory is reused once the copies finished (context thread only)
+	void submit(Allocation& allocation);
+
+	// Gives up an allocation that will never be copied from (thread safe)
+	void discard(Allocation& allocation);
+
+	// Reclaims the memory of all allocations whose copies finished (context thread only)
+	void reclaim();
+
+	// Returns the backend id of the staging buffer
+	uint32_t backendId() const;
+
+	// Returns the capacity of the staging buffer in bytes
+	size_t capacity() const;
+
+	// Returns the amount of bytes currently in use
+	size_t used();
+
+private:
+	// Reserved region of the ring, regions are ordered by allocation
+	struct Region {
+		uint64_t id = 0;
+		size_t offset = 0;
+		size_t size = 0;
+		void* fence = nullptr; // Fence signaled once the copies reading from the region finished
+		bool released = false; // Region was discarded or copied from and can be reused once its fence signaled
+	};
+
+	// Returns the region of an allocation, nullptr if it was reclaimed already
+	Region* findRegion(const Allocation& allocation);
+
+	// Backend id of staging buffer
+	uint32_t _backendId;
+
+	// Persistently mapped staging buffer memory
+	uint8_t* mapped;
+
+	// Capacity of staging buffer
+	size_t _capacity;
+
+	// Offset the next allocation starts at
+	size_t head;
+
+	// Counter for unique allocation ids
+	uint64_t idCounter;
+
+	// Reserved regions from oldest to newest
+	std::deque<Region> regions;
+	std::mutex mtx;
+};
\ No newline at end of file
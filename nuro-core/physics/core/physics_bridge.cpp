@@ -5,6 +5,7 @@
 
 #include <utils/console.h>
 #include <transform/transform.h>
+#include <rendering/model/mesh.h>
 #include <physics/rigidbody/rigidbody.h>
 #include <physics/utils/px_translator.h>
 
@@ -25,11 +26,16 @@ void PhysicsBridge::constructBoxCollider(Registry& reg, Entity ent) {
 	TransformComponent& transform = get<TransformComponent>(reg, ent);
 	BoxColliderComponent& boxCollider = get<BoxColliderComponent>(reg, ent);
 
-	// Create box collider
+	// Create box collider, fitted to the entities mesh if its bounds are available
+	const MeshBounds::Bounds* bounds = try_meshBounds(reg, ent);
 	boxCollider.size = transform.scale;
+	if (bounds) boxCollider.size = (bounds->maxPoint - bounds->minPoint) * 0.5f * transform.scale;
 	boxCollider.material = defaultMaterial;
 	boxCollider.shape = createBoxShape(physics, boxCollider.material, boxCollider.size);
 
+	// Center box collider on the meshes bounds
+	if (bounds) boxCollider.shape->setLocalPose(PxTransform(PxTranslator::convert(bounds->center * transform.scale)));
+
 	// Attach shape to rigidbody if existing
 	try_rbAttachShape(reg, ent, boxCollider.shape);
 }
@@ -51,11 +57,16 @@ void PhysicsBridge::constructSphereCollider(Registry& reg, Entity ent)
 	SphereColliderComponent& sphereCollider = get<SphereColliderComponent>(reg, ent);
 	TransformComponent& transform = get<TransformComponent>(reg, ent);
 
-	// Create sphere collider
+	// Create sphere collider, fitted to the entities mesh if its bounds are available
+	const MeshBounds::Bounds* bounds = try_meshBounds(reg, ent);
 	sphereCollider.radius = glm::compMax(transform.scale);
+	if (bounds) sphereCollider.radius = bounds->radius * glm::compMax(transform.scale);
 	sphereCollider.material = defaultMaterial;
 	sphereCollider.shape = createSphereShape(physics, sphereCollider.material, sphereCollider.radius);
 
+	// Center sphere collider on the meshes bounds
+	if (bounds) sphereCollider.shape->setLocalPose(PxTransform(PxTranslator::convert(bounds->center * transform.scale)));
+
 	// Attach shape to rigidbody if existing
 	try_rbAttachShape(reg, ent, sphereCollider.shape);
 }
@@ -71,6 +82,20 @@ void PhysicsBridge::destroySphereCollider(Registry& reg, Entity ent) {
 	sphereCollider.shape->release();
 }
 
+const MeshBounds::Bounds* PhysicsBridge::try_meshBounds(Registry& reg, Entity ent)
+{
+	if (!has<MeshRendererComponent>(reg, ent)) return nullptr;
+
+	const Mesh* mesh = get<MeshRendererComponent>(reg, ent).mesh;
+	if (!mesh) return nullptr;
+
+	// Bounds of meshes which aren't uploaded yet are empty
+	const MeshBounds::Bounds& bounds = mesh->bounds();
+	if (bounds.radius <= 0.0f) return nullptr;
+
+	return &bounds;
+}
+
 void PhysicsBridge::constructRigidbody(Registry& reg, Entity ent) {
 	// Get components
 	RigidbodyComponent& rigidbody = get<RigidbodyComponent>(reg, ent);
@@ -4,6 +4,7 @@
 #include <PxPhysicsAPI.h>
 
 #include <ecs/ecs_collection.h>
+#include <rendering/culling/mesh_bounds.h>
 
 class PhysicsBridge
 {
@@ -61,6 +62,9 @@ private:
 		return registry.get<T>(entity);
 	}
 
+	// Returns the bounds of the entities mesh, nullptr if it has no mesh or its bounds aren't computed yet (e.g. async mesh not uploaded)
+	const MeshBounds::Bounds* try_meshBounds(Registry& reg, Entity ent);
+
 	// Attach given shape to entities rigidbody if it already has one
 	inline void try_rbAttachShape(Registry& reg, Entity ent, physx::PxShape* shape) {
 		if (has<RigidbodyComponent>(reg, ent)) {
@@ -3,6 +3,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <rendering/transformation/transformation.h>
+#include <rendering/model/mesh.h>
 #include <rendering/model/model.h>
 
 #include <utils/console.h>
@@ -26,6 +27,18 @@ void BoundingSphere::update(Model* model, glm::vec3 position, glm::quat rotation
 	radius = (metrics.furthest * 0.5f) * std::max({ scale.x, scale.y, scale.z });
 }
 
+void BoundingSphere::update(const Mesh& mesh, const glm::mat4& modelMatrix)
+{
+	const MeshBounds::Bounds& bounds = mesh.bounds();
+
+	// Transform meshes sphere center to world space
+	center = glm::vec3(modelMatrix * glm::vec4(bounds.center, 1.0f));
+
+	// Scale radius by the largest axis scale
+	float scale = std::max({ glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])) });
+	radius = bounds.radius * scale;
+}
+
 bool BoundingSphere::intersectsFrustum()
 {
 	// Always intersects
@@ -81,6 +94,20 @@ void BoundingAABB::update(Model* model, glm::vec3 position, glm::quat rotation,
 	max = _max;
 }
 
+void BoundingAABB::update(const Mesh& mesh, const glm::mat4& modelMatrix)
+{
+	const MeshBounds::Bounds& bounds = mesh.bounds();
+
+	// Transform meshes box center and project its half extents onto the world axes
+	glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((bounds.minPoint + bounds.maxPoint) * 0.5f, 1.0f));
+	glm::vec3 halfSize = (bounds.maxPoint - bounds.minPoint) * 0.5f;
+	glm::vec3 worldHalfSize = glm::abs(glm::vec3(modelMatrix[0])) * halfSize.x + glm::abs(glm::vec3(modelMatrix[1])) * halfSize.y + glm::abs(glm::vec3(modelMatrix[2])) * halfSize.z;
+
+	// Set the final bounding box
+	min = center - worldHalfSize;
+	max = center + worldHalfSize;
+}
+
 bool BoundingAABB::intersectsFrustum()
 {
 	// Always intersects
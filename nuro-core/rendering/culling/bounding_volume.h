@@ -5,12 +5,14 @@
 
 #include <rendering/gizmos/gizmos.h>
 
+class Mesh;
 class Model;
 
 class BoundingVolume
 {
 public:
 	virtual void update(Model* model, glm::vec3 position, glm::quat rotation, glm::vec3 scale) {};
+	virtual void update(const Mesh& mesh, const glm::mat4& modelMatrix) {};
 	virtual bool intersectsFrustum() { return false; };
 	virtual float getDistance(glm::vec3 point) { return 0.0f; }
 	virtual void draw(IMGizmo& imGizmoInstance, glm::vec4 color) {};
@@ -22,6 +24,7 @@ public:
 	BoundingSphere();
 
 	void update(Model* model, glm::vec3 position, glm::quat rotation, glm::vec3 scale);
+	void update(const Mesh& mesh, const glm::mat4& modelMatrix);
 	bool intersectsFrustum();
 	float getDistance(glm::vec3 point);
 	void draw(IMGizmo& imGizmoInstance, glm::vec4 color);
@@ -36,6 +39,7 @@ public:
 	BoundingAABB();
 
 	void update(Model* model, glm::vec3 position, glm::quat rotation, glm::vec3 scale);
+	void update(const Mesh& mesh, const glm::mat4& modelMatrix);
 	bool intersectsFrustum();
 	float getDistance(glm::vec3 point);
 	void draw(IMGizmo& imGizmoInstance, glm::vec4 color);
@@ -0,0 +1,179 @@
+#include "mesh_bounds.h"
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESH_BOUNDS_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace MeshBounds {
+
+	// Reads the position at the given index
+	static glm::vec3 _position(const uint8_t* positions, size_t index, size_t stride)
+	{
+		glm::vec3 position;
+		std::memcpy(&position, positions + index * stride, sizeof(glm::vec3));
+		return position;
+	}
+
+#ifdef MESH_BOUNDS_SSE
+	// Loads four positions starting at the given index and transposes them into their x, y and z components
+	// Each load reads one float past its position, which is still within the following position
+	static void _loadBlock(const uint8_t* positions, size_t index, size_t stride, __m128& x, __m128& y, __m128& z)
+	{
+		const uint8_t* cursor = positions + index * stride;
+		__m128 p0 = _mm_loadu_ps(reinterpret_cast<const float*>(cursor));
+		__m128 p1 = _mm_loadu_ps(reinterpret_cast<const float*>(cursor + stride));
+		__m128 p2 = _mm_loadu_ps(reinterpret_cast<const float*>(cursor + stride * 2));
+		__m128 p3 = _mm_loadu_ps(reinterpret_cast<const float*>(cursor + stride * 3));
+		_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+		x = p0;
+		y = p1;
+		z = p2;
+	}
+
+	// Returns the squared lengths of four vectors given by their components
+	static __m128 _lengthSquared(__m128 x, __m128 y, __m128 z)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	}
+
+	// Horizontal reductions of four lanes
+	static float _minLanes(__m128 v)
+	{
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(v);
+	}
+
+	static float _maxLanes(__m128 v)
+	{
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(v);
+	}
+
+	static float _sumLanes(__m128 v)
+	{
+		v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(v);
+	}
+#endif
+
+	Bounds compute(const void* positions, size_t count, size_t stride)
+	{
+		Bounds bounds;
+		if (count == 0) return bounds;
+
+		const uint8_t* data = static_cast<const uint8_t*>(positions);
+
+		glm::vec3 minPoint(FLT_MAX);
+		glm::vec3 maxPoint(-FLT_MAX);
+		glm::vec3 sum(0.0f);
+		float furthestSquared = 0.0f;
+		size_t i = 0;
+
+#ifdef MESH_BOUNDS_SSE
+		// Blocks stop before the last position so no load reads past the end of the positions
+		if (count > 4) {
+			__m128 minX = _mm_set1_ps(FLT_MAX), minY = minX, minZ = minX;
+			__m128 maxX = _mm_set1_ps(-FLT_MAX), maxY = maxX, maxZ = maxX;
+			__m128 sumX = _mm_setzero_ps(), sumY = sumX, sumZ = sumX;
+			__m128 furthest = _mm_setzero_ps();
+
+			for (; i + 4 < count; i += 4) {
+				__m128 x, y, z;
+				_loadBlock(data, i, stride, x, y, z);
+
+				minX = _mm_min_ps(minX, x); minY = _mm_min_ps(minY, y); minZ = _mm_min_ps(minZ, z);
+				maxX = _mm_max_ps(maxX, x); maxY = _mm_max_ps(maxY, y); maxZ = _mm_max_ps(maxZ, z);
+				sumX = _mm_add_ps(sumX, x); sumY = _mm_add_ps(sumY, y); sumZ = _mm_add_ps(sumZ, z);
+				furthest = _mm_max_ps(furthest, _lengthSquared(x, y, z));
+			}
+
+			minPoint = glm::vec3(_minLanes(minX), _minLanes(minY), _minLanes(minZ));
+			maxPoint = glm::vec3(_maxLanes(maxX), _maxLanes(maxY), _maxLanes(maxZ));
+			sum = glm::vec3(_sumLanes(sumX), _sumLanes(sumY), _sumLanes(sumZ));
+			furthestSquared = _maxLanes(furthest);
+		}
+#endif
+
+		// Remaining positions
+		for (; i < count; i++) {
+			glm::vec3 position = _position(data, i, stride);
+			minPoint = glm::min(minPoint, position);
+			maxPoint = glm::max(maxPoint, position);
+			sum += position;
+			furthestSquared = glm::max(furthestSquared, glm::dot(position, position));
+		}
+
+		bounds.minPoint = minPoint;
+		bounds.maxPoint = maxPoint;
+		bounds.center = (minPoint + maxPoint) * 0.5f;
+		bounds.centroid = sum / static_cast<float>(count);
+		bounds.furthest = glm::sqrt(furthestSquared);
+
+		// Sphere radius is the largest distance from the box center, needing a second pass
+		glm::vec3 center = bounds.center;
+		float radiusSquared = 0.0f;
+		i = 0;
+
+#ifdef MESH_BOUNDS_SSE
+		if (count > 4) {
+			__m128 centerX = _mm_set1_ps(center.x);
+			__m128 centerY = _mm_set1_ps(center.y);
+			__m128 centerZ = _mm_set1_ps(center.z);
+			__m128 radius = _mm_setzero_ps();
+
+			for (; i + 4 < count; i += 4) {
+				__m128 x, y, z;
+				_loadBlock(data, i, stride, x, y, z);
+				radius = _mm_max_ps(radius, _lengthSquared(_mm_sub_ps(x, centerX), _mm_sub_ps(y, centerY), _mm_sub_ps(z, centerZ)));
+			}
+
+			radiusSquared = _maxLanes(radius);
+		}
+#endif
+
+		for (; i < count; i++) {
+			glm::vec3 offset = _position(data, i, stride) - center;
+			radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+		}
+
+		bounds.radius = glm::sqrt(radiusSquared);
+
+		return bounds;
+	}
+
+	bool intersectsFrustum(const Bounds& bounds, const glm::mat4& mvp)
+	{
+		// Rows of the model-view-projection, frustum planes in object space are sums and differences of them
+		glm::vec4 rowX(mvp[0][0], mvp[1][0], mvp[2][0], mvp[3][0]);
+		glm::vec4 rowY(mvp[0][1], mvp[1][1], mvp[2][1], mvp[3][1]);
+		glm::vec4 rowZ(mvp[0][2], mvp[1][2], mvp[2][2], mvp[3][2]);
+		glm::vec4 rowW(mvp[0][3], mvp[1][3], mvp[2][3], mvp[3][3]);
+
+		const glm::vec4 planes[6] = {
+			rowW + rowX, rowW - rowX,
+			rowW + rowY, rowW - rowY,
+			rowW + rowZ, rowW - rowZ
+		};
+
+		// Sphere is outside if it's fully behind any plane
+		for (const glm::vec4& plane : planes) {
+			glm::vec3 normal(plane);
+			float length = glm::length(normal);
+			if (length <= FLT_EPSILON) continue;
+
+			float distance = glm::dot(normal, bounds.center) + plane.w;
+			if (distance < -bounds.radius * length) return false;
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
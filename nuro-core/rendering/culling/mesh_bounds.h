@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Object space bounding volumes of meshes, used for culling, shadow caster selection and physics proxies
+namespace MeshBounds
+{
+	struct Bounds
+	{
+		// Minimum position (bounding box)
+		glm::vec3 minPoint = glm::vec3(0.0f);
+
+		// Maximum position (bounding box)
+		glm::vec3 maxPoint = glm::vec3(0.0f);
+
+		// Center of the bounding sphere (midpoint of min/max points)
+		glm::vec3 center = glm::vec3(0.0f);
+
+		// Radius of the bounding sphere
+		float radius = 0.0f;
+
+		// Geometric center (average of all positions)
+		glm::vec3 centroid = glm::vec3(0.0f);
+
+		// Maximum distance of a position from object space center
+		float furthest = 0.0f;
+	};
+
+	// Computes the bounds of positions laid out with the given stride in bytes, reducing four positions at a time with simd where available
+	Bounds compute(const void* positions, size_t count, size_t stride);
+
+	// Returns if the bounding sphere intersects the view frustum of the given model-view-projection
+	bool intersectsFrustum(const Bounds& bounds, const glm::mat4& mvp);
+};
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <rendering/model/mesh.h>
 #include <rendering/model/model.h>
@@ -71,11 +72,11 @@ void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 	staticData.fillShader->bind();
 
 	// Enable blending
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::enable(GL_BLEND);
+	GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
+	GLState::enable(GL_DEPTH_TEST);
 
 	for (int32_t i = 0; i < shapeRenderStack.size(); i++)
 	{
@@ -87,8 +88,8 @@ void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 		glm::mat4 mvpMatrix = viewProjection * modelMatrix;
 
 		// Set material uniforms
-		staticData.fillShader->setMatrix4("mvpMatrix", mvpMatrix);
-		staticData.fillShader->setVec4("color", glm::vec4(gizmo.state.color, gizmo.state.opacity));
+		staticData.fillShader->setMatrix4(UniformId<"mvpMatrix">, mvpMatrix);
+		staticData.fillShader->setVec4(UniformId<"color">, glm::vec4(gizmo.state.color, gizmo.state.opacity));
 
 		// Set polygon mode for gizmo render
 		if (gizmo.wireframe)
@@ -102,20 +103,20 @@ void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 
 		// Render mesh
 		const Mesh* mesh = queryMesh(gizmo.shape);
-		glBindVertexArray(mesh->vao());
-		glDrawElements(GL_LINES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+		GLState::bindVertexArray(mesh->vao());
+		glDrawElementsBaseVertex(GL_LINES, mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(mesh->firstIndex()) * sizeof(uint32_t)), mesh->baseVertex());
 
 		// Optional foreground pass without depth testing and reduced opacity
 		if (gizmo.state.foreground) {
-			staticData.fillShader->setVec4("color", glm::vec4(gizmo.state.color, 0.035f));
-			glDisable(GL_DEPTH_TEST);
-			glDrawElements(GL_LINES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-			glEnable(GL_DEPTH_TEST);
+			staticData.fillShader->setVec4(UniformId<"color">, glm::vec4(gizmo.state.color, 0.035f));
+			GLState::disable(GL_DEPTH_TEST);
+			glDrawElementsBaseVertex(GL_LINES, mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(mesh->firstIndex()) * sizeof(uint32_t)), mesh->baseVertex());
+			GLState::enable(GL_DEPTH_TEST);
 		}
 	}
 
 	// Disable blending
-	glDisable(GL_BLEND);
+	GLState::disable(GL_BLEND);
 
 	// Restore polygon mode
 	glPolygonMode(GL_FRONT_AND_BACK, polygonState[0]);
@@ -130,14 +131,14 @@ void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 	staticData.iconShader->bind();
 
 	// Enable blending
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::enable(GL_BLEND);
+	GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Fill polygons
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
 	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
+	GLState::enable(GL_DEPTH_TEST);
 
 	for (int32_t i = 0; i < iconRenderStack.size(); i++)
 	{
@@ -152,8 +153,8 @@ void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 		if (glm::distance(gizmo.position, gizmo.cameraTransform.position) > renderRadius) continue;
 
 		// Bind gizmo icon texture
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, gizmo.iconTexture);
+		GLState::activeTexture(GL_TEXTURE0);
+		GLState::bindTexture(GL_TEXTURE_2D, gizmo.iconTexture);
 
 		// Get cameras position and direction
 		glm::vec3 gizmoPosition = Transformation::swap(gizmo.position);
@@ -199,23 +200,23 @@ void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 		};
 
 		// Set static material uniforms
-		staticData.iconShader->setMatrix4("mvpMatrix", mvpMatrix);
-		staticData.iconShader->setVec3("tint", glm::vec3(1.0f));
+		staticData.iconShader->setMatrix4(UniformId<"mvpMatrix">, mvpMatrix);
+		staticData.iconShader->setVec3(UniformId<"tint">, glm::vec3(1.0f));
 
 		// Render with full opacity and depth test
-		staticData.iconShader->setFloat("alpha", alpha(1.0f, gizmoPosition, cameraPosition));
-		glBindVertexArray(mesh->vao());
-		glDrawElements(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+		staticData.iconShader->setFloat(UniformId<"alpha">, alpha(1.0f, gizmoPosition, cameraPosition));
+		GLState::bindVertexArray(mesh->vao());
+		glDrawElementsBaseVertex(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(mesh->firstIndex()) * sizeof(uint32_t)), mesh->baseVertex());
 
 		// Render with transparency but without depth test
-		staticData.iconShader->setFloat("alpha", alpha(0.06f, gizmoPosition, cameraPosition));
-		glDisable(GL_DEPTH_TEST);
-		glDrawElements(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
-		glEnable(GL_DEPTH_TEST);
+		staticData.iconShader->setFloat(UniformId<"alpha">, alpha(0.06f, gizmoPosition, cameraPosition));
+		GLState::disable(GL_DEPTH_TEST);
+		glDrawElementsBaseVertex(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(mesh->firstIndex()) * sizeof(uint32_t)), mesh->baseVertex());
+		GLState::enable(GL_DEPTH_TEST);
 	}
 
 	// Disable blending
-	glDisable(GL_BLEND);
+	GLState::disable(GL_BLEND);
 }
 
 void IMGizmo::plane(const glm::vec3& position, const glm::vec3& scale, const glm::quat& rotation)
@@ -15,10 +15,16 @@
 class IMaterial
 {
 public:
+	// Returned by materials without a material table entry
+	static constexpr uint32_t NO_MATERIAL_SLOT = UINT32_MAX;
+
 	virtual ~IMaterial() {}
 
 	virtual void bind() const = 0;
 	virtual uint32_t getId() const = 0;
 	virtual ResourceRef<Shader> getShader() const = 0;
 	virtual uint32_t getShaderId() const = 0;
+
+	// Returns the entry of a material table shared by all materials of the shader, NO_MATERIAL_SLOT if the material relies on its own bind
+	virtual uint32_t getMaterialSlot() const { return NO_MATERIAL_SLOT; }
 };
\ No newline at end of file
@@ -7,8 +7,10 @@
 
 #include "lit_material.h"
 
+#include <cstring>
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <transform/transform.h>
 #include <rendering/shadows/shadow_map.h>
@@ -24,13 +26,12 @@ PostProcessing::Profile* LitMaterial::profile = nullptr;
 bool LitMaterial::castShadows = true;
 ShadowDisk* LitMaterial::mainShadowDisk = nullptr;
 ShadowMap* LitMaterial::mainShadowMap = nullptr;
-
-std::string uniformArray(const std::string& identifier, size_t arrayIndex)
-{
-	size_t pos = identifier.find("[]");
-	if (pos == std::string::npos) return identifier;
-	return identifier.substr(0, pos) + "[" + std::to_string(arrayIndex) + "]" + identifier.substr(pos + 2);
-}
+uint32_t LitMaterial::frameBuffer = 0;
+uint32_t LitMaterial::viewBuffer = 0;
+uint32_t LitMaterial::materialTable = 0;
+uint32_t LitMaterial::materialTableCapacity = 0;
+uint32_t LitMaterial::nMaterialSlots = 0;
+std::vector<uint32_t> LitMaterial::freeMaterialSlots;
 
 LitMaterial::LitMaterial() : baseColor(glm::vec4(1.0f)),
 tiling(glm::vec2(1.0f, 1.0f)),
@@ -51,16 +52,30 @@ emissiveMap(nullptr),
 heightMap(nullptr),
 id(0),
 shader(ShaderPool::get("lit")),
-shaderId(0)
+shaderId(0),
+materialSlot(0),
+directTextures(),
+materialData(),
+materialDataUploaded(false),
+materialDataDirty(true),
+syncedTextures(),
+syncedGenerations()
 {
 	instances++;
 
 	id = instances;
 	shaderId = shader->backendId();
 
-	shader->bind();
+	// Create shared buffers and reserve the materials table entry
+	createSharedBuffers();
+	materialSlot = allocateMaterialSlot();
+
 	syncStaticUniforms();
-	syncLightUniforms();
+}
+
+LitMaterial::~LitMaterial()
+{
+	freeMaterialSlots.push_back(materialSlot);
 }
 
 void LitMaterial::bind() const
@@ -68,104 +83,31 @@ void LitMaterial::bind() const
 	// Bad temporary code
 	if (!shader || !viewport || !cameraTransform || !profile || !mainShadowDisk || !mainShadowMap) return;
 
-	syncLightUniforms();
-
-	// World parameters
-	shader->setMatrix4("lightSpaceMatrix", mainShadowMap->getLightSpace());
-	shader->setVec3("configuration.cameraPosition", Transformation::swap(Transform::getPosition(*cameraTransform, Space::WORLD)));
-
-	// General configuration
-	shader->setFloat("configuration.gamma", profile->color.gamma);
-	shader->setVec2("configuration.viewportResolution", viewport->getResolution());
-
-	// Shadow parameters
-	shader->setBool("configuration.castShadows", castShadows);
-
-	shader->setFloat("configuration.shadowMapResolutionWidth", static_cast<float>(mainShadowMap->getResolutionWidth()));
-	shader->setFloat("configuration.shadowMapResolutionHeight", static_cast<float>(mainShadowMap->getResolutionHeight()));
-
-	shader->setFloat("configuration.shadowDiskWindowSize", static_cast<float>(mainShadowDisk->getWindowSize()));
-	shader->setFloat("configuration.shadowDiskFilterSize", static_cast<float>(mainShadowDisk->getFilterSize()));
-	shader->setFloat("configuration.shadowDiskRadius", static_cast<float>(mainShadowDisk->getRadius()));
+	// Select material table entry, material textures are referenced by it
+	syncMaterialData();
+	shader->setInt(UniformId<"materialIndex">, static_cast<int32_t>(materialSlot));
 
 	// Bind shadow maps
 	mainShadowDisk->bind(SHADOW_DISK_UNIT);
 	mainShadowMap->bind(SHADOW_MAP_UNIT);
 
 	// SSAO
-	shader->setBool("configuration.enableSSAO", profile->ambientOcclusion.enabled);
 	if (profile->ambientOcclusion.enabled) {
-		glActiveTexture(GL_TEXTURE0 + SSAO_UNIT);
-		glBindTexture(GL_TEXTURE_2D, ssaoInput);
-	}
-
-	// Set material data
-	shader->setVec4("material.baseColor", baseColor);
-	shader->setVec2("material.tiling", tiling);
-	shader->setVec2("material.offset", offset);
-	shader->setBool("material.emission", emission);
-	shader->setFloat("material.emissionIntensity", emissionIntensity);
-	shader->setVec3("material.emissionColor", emissionColor);
-
-	// Set textures
-	shader->setBool("material.enableAlbedoMap", albedoMap != nullptr);
-	if (albedoMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + ALBEDO_UNIT);
-		glBindTexture(GL_TEXTURE_2D, albedoMap->backendId());
-	}
-
-	shader->setBool("material.enableRoughnessMap", roughnessMap != nullptr);
-	if (roughnessMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + ROUGHNESS_UNIT);
-		glBindTexture(GL_TEXTURE_2D, roughnessMap->backendId());
-	}
-	else
-	{
-		shader->setFloat("material.roughness", roughness);
-	}
-
-	shader->setBool("material.enableMetallicMap", metallicMap != nullptr);
-	if (metallicMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + METALLIC_UNIT);
-		glBindTexture(GL_TEXTURE_2D, metallicMap->backendId());
-	}
-	else
-	{
-		shader->setFloat("material.metallic", metallic);
-	}
-
-	shader->setBool("material.enableNormalMap", normalMap != nullptr);
-	if (normalMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + NORMAL_UNIT);
-		glBindTexture(GL_TEXTURE_2D, normalMap->backendId());
-	}
-	shader->setFloat("material.normalMapIntensity", normalMapIntensity);
-
-	shader->setBool("material.enableOcclusionMap", false);
-	if (occlusionMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + OCCLUSION_UNIT);
-		glBindTexture(GL_TEXTURE_2D, occlusionMap->backendId());
+		GLState::activeTexture(GL_TEXTURE0 + SSAO_UNIT);
+		GLState::bindTexture(GL_TEXTURE_2D, ssaoInput);
 	}
 
-	shader->setBool("material.enableEmissiveMap", emissiveMap != nullptr);
-	if (emissiveMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + EMISSIVE_UNIT);
-		glBindTexture(GL_TEXTURE_2D, emissiveMap->backendId());
-	}
+	// Texture arrays are shared by all materials, redundant binds are filtered
+	if (!Texture::bindless()) {
+		TextureArrayPool::bind(TEXTURE_ARRAYS_UNIT);
 
-	shader->setBool("material.enableHeightMap", heightMap != nullptr);
-	if (heightMap)
-	{
-		glActiveTexture(GL_TEXTURE0 + HEIGHT_UNIT);
-		glBindTexture(GL_TEXTURE_2D, heightMap->backendId());
+		// Bind textures that couldn't be packed
+		for (uint32_t map = 0; map < TEXTURE_MAP_COUNT; map++) {
+			if (!directTextures[map]) continue;
+			GLState::activeTexture(GL_TEXTURE0 + DIRECT_TEXTURES_UNIT + map);
+			GLState::bindTexture(GL_TEXTURE_2D, directTextures[map]);
+		}
 	}
-	shader->setFloat("material.heightMapScale", heightMapScale);
 }
 
 uint32_t LitMaterial::getId() const
@@ -183,37 +125,52 @@ uint32_t LitMaterial::getShaderId() const
 	return shaderId;
 }
 
-void LitMaterial::syncStaticUniforms() const
+uint32_t LitMaterial::getMaterialSlot() const
 {
-	//
-	// Sync static texture units
-	//
+	syncMaterialData();
+
+	// Directly bound textures are only bound by this materials own bind
+	for (uint32_t map = 0; map < TEXTURE_MAP_COUNT; map++) {
+		if (directTextures[map]) return NO_MATERIAL_SLOT;
+	}
+
+	return materialSlot;
+}
 
-	shader->setInt("material.albedoMap", ALBEDO_UNIT);
-	shader->setInt("material.normalMap", NORMAL_UNIT);
-	shader->setInt("material.roughnessMap", ROUGHNESS_UNIT);
-	shader->setInt("material.metallicMap", METALLIC_UNIT);
-	shader->setInt("material.ambientOcclusionMap", OCCLUSION_UNIT);
-	shader->setInt("material.emissiveMap", EMISSIVE_UNIT);
-	shader->setInt("material.heightMap", HEIGHT_UNIT);
-	shader->setInt("configuration.shadowDisk", SHADOW_DISK_UNIT);
-	shader->setInt("configuration.shadowMap", SHADOW_MAP_UNIT);
-	shader->setInt("configuration.ssaoBuffer", SSAO_UNIT);
+void LitMaterial::syncStaticUniforms() const
+{
+	// Sync each variant, uniforms are set on the bound one
+	for (size_t i = 0; i < static_cast<size_t>(Shader::Variant::COUNT); i++) {
+		Shader::Variant variant = static_cast<Shader::Variant>(i);
+		if (!shader->hasVariant(variant)) continue;
+		shader->bind(variant);
+
+		//
+		// Sync static texture units
+		//
+
+		shader->setInt("shadowDisk", SHADOW_DISK_UNIT);
+		shader->setInt("shadowMap", SHADOW_MAP_UNIT);
+		shader->setInt("ssaoBuffer", SSAO_UNIT);
+		for (uint32_t unit = 0; unit < TextureArrayPool::MAX_ARRAYS; unit++)
+			shader->setInt("materialTextureArrays[" + std::to_string(unit) + "]", TEXTURE_ARRAYS_UNIT + unit);
+		for (uint32_t map = 0; map < TEXTURE_MAP_COUNT; map++)
+			shader->setInt("materialTextures[" + std::to_string(map) + "]", DIRECT_TEXTURES_UNIT + map);
+	}
+	shader->bind();
 
 	//
-	// Sync scene
+	// Sync uniform block bindings
 	//
-	// 
-	
-	// Fog settings
-	shader->setInt("fog.type", 0); // No fog
-	// shader->setInt("fog.type", 3);
-	// shader->setVec3("fog.color", glm::vec3(1.0f, 1.0f, 1.0f));
-	// shader->setFloat("fog.data[0]", 0.01);
+
+	shader->setUniformBlockBinding("FrameData", FRAME_DATA_BINDING);
+	shader->setUniformBlockBinding("ViewData", VIEW_DATA_BINDING);
 }
 
-void LitMaterial::syncLightUniforms() const
+void LitMaterial::syncFrameData()
 {
+	FrameData frameData = {};
+
 	//
 	// Sync lights
 	//
@@ -229,37 +186,34 @@ void LitMaterial::syncLightUniforms() const
 	size_t nPointLights = 0;
 	size_t nSpotlights = 0;
 
-	// Limitations
-	size_t maxDirectionalLights = 1;
-	size_t maxPointLights = 15;
-	size_t maxSpotlights = 8;
-
 	// Setup all directional lights
 	for (auto [entity, transform, directionalLight] : directionalLights.each()) {
 		glm::vec3 directionalDirection = glm::vec3(-0.7f, -0.8f, 1.0f);
 		glm::vec3 directionalPosition = glm::vec3(4.0f, 5.0f, -7.0f);
 
 		if (!directionalLight.enabled) continue;
-		shader->setFloat(uniformArray("directionalLights[].intensity", nDirectionalLights), directionalLight.intensity);
-		shader->setVec3(uniformArray("directionalLights[].direction", nDirectionalLights), Transformation::swap(directionalDirection));
-		shader->setVec3(uniformArray("directionalLights[].color", nDirectionalLights), directionalLight.color);
-		shader->setVec3(uniformArray("directionalLights[].position", nDirectionalLights), Transformation::swap(directionalPosition));
+		DirectionalLightData& data = frameData.directionalLights[nDirectionalLights];
+		data.intensity = directionalLight.intensity;
+		data.direction = Transformation::swap(directionalDirection);
+		data.color = directionalLight.color;
+		data.position = Transformation::swap(directionalPosition);
 
 		nDirectionalLights++;
-		if (nDirectionalLights >= maxDirectionalLights) break;
+		if (nDirectionalLights >= MAX_DIRECTIONAL_LIGHTS) break;
 	}
 
 	// Setup all point lights
 	for (auto [entity, transform, pointLight] : pointLights.each()) {
 		if (!pointLight.enabled) continue;
-		shader->setVec3(uniformArray("pointLights[].position", nPointLights), Transformation::swap(Transform::getPosition(transform, Space::WORLD)));
-		shader->setVec3(uniformArray("pointLights[].color", nPointLights), pointLight.color);
-		shader->setFloat(uniformArray("pointLights[].intensity", nPointLights), pointLight.intensity);
-		shader->setFloat(uniformArray("pointLights[].range", nPointLights), pointLight.range);
-		shader->setFloat(uniformArray("pointLights[].falloff", nPointLights), pointLight.falloff);
+		PointLightData& data = frameData.pointLights[nPointLights];
+		data.position = Transformation::swap(Transform::getPosition(transform, Space::WORLD));
+		data.color = pointLight.color;
+		data.intensity = pointLight.intensity;
+		data.range = pointLight.range;
+		data.falloff = pointLight.falloff;
 
 		nPointLights++;
-		if (nPointLights >= maxPointLights) break;
+		if (nPointLights >= MAX_POINT_LIGHTS) break;
 	}
 
 	// Setup all spotlights
@@ -267,34 +221,238 @@ void LitMaterial::syncLightUniforms() const
 		glm::vec3 spotlightDirection = glm::vec3(0.0f, 0.0f, 1.0f);
 
 		if (!spotlight.enabled) continue;
-		shader->setVec3(uniformArray("spotlights[].position", nSpotlights), Transformation::swap(Transform::getPosition(transform, Space::WORLD)));
-		shader->setVec3(uniformArray("spotlights[].direction", nSpotlights), Transformation::swap(spotlightDirection));
-		shader->setVec3(uniformArray("spotlights[].color", nSpotlights), spotlight.color);
-		shader->setFloat(uniformArray("spotlights[].intensity", nSpotlights), spotlight.intensity);
-		shader->setFloat(uniformArray("spotlights[].range", nSpotlights), spotlight.range);
-		shader->setFloat(uniformArray("spotlights[].falloff", nSpotlights), spotlight.falloff);
-		shader->setFloat(uniformArray("spotlights[].innerCos", nSpotlights), glm::cos(glm::radians(spotlight.innerAngle * 0.5f)));
-		shader->setFloat(uniformArray("spotlights[].outerCos", nSpotlights), glm::cos(glm::radians(spotlight.outerAngle * 0.5f)));
+		SpotlightData& data = frameData.spotlights[nSpotlights];
+		data.position = Transformation::swap(Transform::getPosition(transform, Space::WORLD));
+		data.direction = Transformation::swap(spotlightDirection);
+		data.color = spotlight.color;
+		data.intensity = spotlight.intensity;
+		data.range = spotlight.range;
+		data.falloff = spotlight.falloff;
+		data.innerCos = glm::cos(glm::radians(spotlight.innerAngle * 0.5f));
+		data.outerCos = glm::cos(glm::radians(spotlight.outerAngle * 0.5f));
 
 		nSpotlights++;
-		if (nSpotlights >= maxSpotlights) break;
+		if (nSpotlights >= MAX_SPOTLIGHTS) break;
 	}
 
 	// Lighting parameters
-	shader->setInt("configuration.numDirectionalLights", nDirectionalLights);
-	shader->setInt("configuration.numPointLights", nPointLights);
-	shader->setInt("configuration.numSpotLights", nSpotlights);
+	frameData.numDirectionalLights = static_cast<int32_t>(nDirectionalLights);
+	frameData.numPointLights = static_cast<int32_t>(nPointLights);
+	frameData.numSpotLights = static_cast<int32_t>(nSpotlights);
+
+	//
+	// Sync scene
+	//
+
+	// Fog settings
+	frameData.fog.type = 0; // No fog
+	// frameData.fog.type = 3;
+	// frameData.fog.color = glm::vec3(1.0f, 1.0f, 1.0f);
+	// frameData.fog.data[0] = 0.01f;
+
+	//
+	// Sync shadow parameters
+	//
+
+	if (mainShadowMap) {
+		frameData.shadowMapResolutionWidth = static_cast<float>(mainShadowMap->getResolutionWidth());
+		frameData.shadowMapResolutionHeight = static_cast<float>(mainShadowMap->getResolutionHeight());
+	}
+
+	if (mainShadowDisk) {
+		frameData.shadowDiskWindowSize = static_cast<float>(mainShadowDisk->getWindowSize());
+		frameData.shadowDiskFilterSize = static_cast<float>(mainShadowDisk->getFilterSize());
+		frameData.shadowDiskRadius = static_cast<float>(mainShadowDisk->getRadius());
+	}
+
+	uploadFrameData(frameData);
+}
+
+void LitMaterial::syncViewData()
+{
+	// Bad temporary code
+	if (!viewport || !cameraTransform || !profile || !mainShadowMap) return;
+
+	createSharedBuffers();
+
+	ViewData viewData = {};
+	viewData.lightSpaceMatrix = mainShadowMap->getLightSpace();
+	viewData.cameraPosition = Transformation::swap(Transform::getPosition(*cameraTransform, Space::WORLD));
+	viewData.gamma = profile->color.gamma;
+	viewData.viewportResolution = viewport->getResolution();
+	viewData.solidMode = 0;
+	viewData.castShadows = castShadows ? 1 : 0;
+	viewData.enableSSAO = profile->ambientOcclusion.enabled ? 1 : 0;
+
+	// Orphan and upload view data
+	glBindBuffer(GL_UNIFORM_BUFFER, viewBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewData), &viewData, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, VIEW_DATA_BINDING, viewBuffer);
 }
 
-void LitMaterial::setSampleDirectionalLight() const
+void LitMaterial::setSampleDirectionalLight()
 {
-	shader->setInt("configuration.numDirectionalLights", 1);
-	shader->setInt("configuration.numPointLights", 0);
-	shader->setInt("configuration.numSpotLights", 0);
-
-	size_t index = 0;
-	shader->setFloat(uniformArray("directionalLights[].intensity", index), 1.0f);
-	shader->setVec3(uniformArray("directionalLights[].direction", index), Transformation::swap(glm::vec3(-0.5f, -0.5f, 0.5f)));
-	shader->setVec3(uniformArray("directionalLights[].color", index), glm::vec3(1.0f, 1.0f, 1.0f));
-	shader->setVec3(uniformArray("directionalLights[].position", index), Transformation::swap(glm::vec3(0.0f, 0.0f, 0.0f)));
+	FrameData frameData = {};
+	frameData.numDirectionalLights = 1;
+	frameData.numPointLights = 0;
+	frameData.numSpotLights = 0;
+
+	DirectionalLightData& data = frameData.directionalLights[0];
+	data.intensity = 1.0f;
+	data.direction = Transformation::swap(glm::vec3(-0.5f, -0.5f, 0.5f));
+	data.color = glm::vec3(1.0f, 1.0f, 1.0f);
+	data.position = Transformation::swap(glm::vec3(0.0f, 0.0f, 0.0f));
+
+	uploadFrameData(frameData);
 }
+
+void LitMaterial::createSharedBuffers()
+{
+	if (frameBuffer) return;
+
+	glGenBuffers(1, &frameBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+
+	glGenBuffers(1, &viewBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, viewBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewData), nullptr, GL_DYNAMIC_DRAW);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, frameBuffer);
+	glBindBufferBase(GL_UNIFORM_BUFFER, VIEW_DATA_BINDING, viewBuffer);
+}
+
+void LitMaterial::uploadFrameData(const FrameData& frameData)
+{
+	createSharedBuffers();
+
+	// Orphan and upload frame data
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &frameData, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, frameBuffer);
+}
+
+uint32_t LitMaterial::allocateMaterialSlot()
+{
+	if (!freeMaterialSlots.empty()) {
+		uint32_t slot = freeMaterialSlots.back();
+		freeMaterialSlots.pop_back();
+		return slot;
+	}
+
+	// Grow the material table, copying the entries of existing materials
+	if (nMaterialSlots == materialTableCapacity) {
+		uint32_t capacity = materialTableCapacity ? materialTableCapacity * 2 : INITIAL_MATERIAL_TABLE_SIZE;
+
+		uint32_t buffer = 0;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(MaterialData), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		if (materialTable) {
+			glBindBuffer(GL_COPY_READ_BUFFER, materialTable);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, nMaterialSlots * sizeof(MaterialData));
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			glDeleteBuffers(1, &materialTable);
+		}
+
+		materialTable = buffer;
+		materialTableCapacity = capacity;
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_TABLE_BINDING, materialTable);
+	}
+
+	return nMaterialSlots++;
+}
+
+bool LitMaterial::textureReference(const ResourceRef<Texture>& texture, TextureMaps map, glm::uvec2& reference) const
+{
+	reference = glm::uvec2(0);
+	directTextures[map] = 0;
+	if (!texture) return false;
+
+	// Bindless handle split into its lower and upper half
+	if (Texture::bindless()) {
+		uint64_t handle = texture->bindlessHandle();
+		reference = glm::uvec2(static_cast<uint32_t>(handle), static_cast<uint32_t>(handle >> 32));
+		return handle != 0;
+	}
+
+	// Texture array and layer of the textures packed copy, packing adds to the textures footprint
+	bool packed = TextureArrayPool::packed(texture->backendId());
+	TextureArrayPool::Layer layer = TextureArrayPool::acquire(texture->backendId());
+	if (layer.valid()) {
+		if (!packed) texture->footprintChanged();
+		reference = glm::uvec2(layer.array, layer.layer);
+		return true;
+	}
+
+	// Bind the texture directly to the unit of its map if it couldn't be packed
+	directTextures[map] = texture->backendId();
+	reference = glm::uvec2(DIRECT_TEXTURE, map);
+	return true;
+}
+
+void LitMaterial::markDirty()
+{
+	materialDataDirty = true;
+}
+
+bool LitMaterial::texturesChanged() const
+{
+	const ResourceRef<Texture>* maps[TEXTURE_MAP_COUNT] = { &albedoMap, &roughnessMap, &metallicMap, &normalMap, &occlusionMap, &emissiveMap, &heightMap };
+
+	bool changed = false;
+	for (uint32_t map = 0; map < TEXTURE_MAP_COUNT; map++) {
+		const Texture* texture = maps[map]->get();
+		uint32_t generation = texture ? texture->generation() : 0;
+		if (texture == syncedTextures[map] && generation == syncedGenerations[map]) continue;
+
+		syncedTextures[map] = texture;
+		syncedGenerations[map] = generation;
+		changed = true;
+	}
+	return changed;
+}
+
+void LitMaterial::syncMaterialData() const
+{
+	// Skip rebuilding the material data on clean binds, texture changes are checked first to remember their state
+	bool changed = texturesChanged();
+	if (materialDataUploaded && !materialDataDirty && !changed) return;
+	materialDataDirty = false;
+
+	MaterialData data = {};
+	data.baseColor = baseColor;
+	data.tiling = tiling;
+	data.offset = offset;
+	data.emissionColor = emissionColor;
+	data.emissionIntensity = emissionIntensity;
+	data.roughness = roughness;
+	data.metallic = metallic;
+	data.normalMapIntensity = normalMapIntensity;
+	data.heightMapScale = heightMapScale;
+	data.emission = emission ? 1 : 0;
+	data.enableAlbedoMap = textureReference(albedoMap, ALBEDO_MAP, data.albedoMap) ? 1 : 0;
+	data.enableRoughnessMap = textureReference(roughnessMap, ROUGHNESS_MAP, data.roughnessMap) ? 1 : 0;
+	data.enableMetallicMap = textureReference(metallicMap, METALLIC_MAP, data.metallicMap) ? 1 : 0;
+	data.enableNormalMap = textureReference(normalMap, NORMAL_MAP, data.normalMap) ? 1 : 0;
+	data.enableOcclusionMap = 0;
+	data.enableEmissiveMap = textureReference(emissiveMap, EMISSIVE_MAP, data.emissiveMap) ? 1 : 0;
+	data.enableHeightMap = textureReference(heightMap, HEIGHT_MAP, data.heightMap) ? 1 : 0;
+
+	// Marking dirty doesn't imply a change, so identical data isn't uploaded again
+	if (materialDataUploaded && std::memcmp(&data, &materialData, sizeof(MaterialData)) == 0) return;
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialTable);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, materialSlot * sizeof(MaterialData), sizeof(MaterialData), &data);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	materialData = data;
+	materialDataUploaded = true;
+}
\ No newline at end of file
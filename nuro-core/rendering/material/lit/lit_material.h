@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <cstdint>
 #include <glm/glm.hpp>
 
@@ -9,6 +10,7 @@
 #include <ecs/ecs_collection.h>
 #include <memory/resource_manager.h>
 #include <rendering/texture/texture.h>
+#include <rendering/texture/texture_array_pool.h>
 #include <rendering/postprocessing/post_processing.h>
 
 class ShadowDisk;
@@ -18,12 +20,20 @@ class LitMaterial : public IMaterial
 {
 public:
 	LitMaterial();
+	~LitMaterial() override;
 
+	LitMaterial(const LitMaterial&) = delete;
+	LitMaterial& operator=(const LitMaterial&) = delete;
+
+	// Selects the materials entry of the material table, uploading it first if any parameter or texture changed
 	void bind() const override;
 	uint32_t getId() const override;
 	ResourceRef<Shader> getShader() const override;
 	uint32_t getShaderId() const override;
 
+	// Uploads the materials entry of the material table if needed, NO_MATERIAL_SLOT while a texture is bound directly
+	uint32_t getMaterialSlot() const override;
+
 	glm::vec4 baseColor;
 	glm::vec2 tiling;
 	glm::vec2 offset;
@@ -43,9 +53,20 @@ public:
 	ResourceRef<Texture> emissiveMap;
 	ResourceRef<Texture> heightMap;
 
+	// Marks the material data as changed, has to be called after changing any parameter or texture above once the material was bound
+	void markDirty();
+
+	// Sets texture units and uniform block bindings of all shader variants
 	void syncStaticUniforms() const;
-	void syncLightUniforms() const;
-	void setSampleDirectionalLight() const;
+
+	// Uploads lights, fog and shadow parameters shared by all lit materials, once per frame
+	static void syncFrameData();
+
+	// Uploads camera, viewport and shadow configuration of the current view from the render data below, once per view
+	static void syncViewData();
+
+	// Replaces the lights of the frame data by a single sample directional light until the next frame data sync
+	static void setSampleDirectionalLight();
 
 public:
 	// Instance counter
@@ -64,21 +85,202 @@ public:
 	static ShadowMap* mainShadowMap; // tmp until global shadow system
 
 private:
+	// Uniform buffer binding points of the lit shaders blocks
+	enum UniformBufferBindings
+	{
+		FRAME_DATA_BINDING,
+		VIEW_DATA_BINDING
+	};
+
+	// Storage buffer binding of the material table, following the draw data of indirect draws
+	static constexpr uint32_t MATERIAL_TABLE_BINDING = 1;
+
+	// Amount of entries the material table is created with, grown by doubling once full
+	static constexpr uint32_t INITIAL_MATERIAL_TABLE_SIZE = 64;
+
+	static constexpr size_t MAX_DIRECTIONAL_LIGHTS = 1;
+	static constexpr size_t MAX_POINT_LIGHTS = 15;
+	static constexpr size_t MAX_SPOTLIGHTS = 8;
+
+	// Light and fog layouts as read by the lit shader (std140)
+	struct DirectionalLightData
+	{
+		glm::vec3 direction;
+		float intensity;
+		glm::vec3 color;
+		float padding0;
+		glm::vec3 position;
+		float padding1;
+	};
+
+	struct PointLightData
+	{
+		glm::vec3 position;
+		float intensity;
+		glm::vec3 color;
+		float range;
+		float falloff;
+		float padding[3];
+	};
+
+	struct SpotlightData
+	{
+		glm::vec3 position;
+		float intensity;
+		glm::vec3 direction;
+		float range;
+		glm::vec3 color;
+		float falloff;
+		float innerCos;
+		float outerCos;
+		float padding[2];
+	};
+
+	struct FogData
+	{
+		glm::vec3 color;
+		int32_t type;
+		glm::vec2 data;
+		float padding[2];
+	};
+
+	// Per frame block (std140)
+	struct FrameData
+	{
+		DirectionalLightData directionalLights[MAX_DIRECTIONAL_LIGHTS];
+		PointLightData pointLights[MAX_POINT_LIGHTS];
+		SpotlightData spotlights[MAX_SPOTLIGHTS];
+		FogData fog;
+		int32_t numDirectionalLights;
+		int32_t numPointLights;
+		int32_t numSpotLights;
+		float shadowMapResolutionWidth;
+		float shadowMapResolutionHeight;
+		float shadowDiskWindowSize;
+		float shadowDiskFilterSize;
+		float shadowDiskRadius;
+	};
+
+	// Per view block (std140)
+	struct ViewData
+	{
+		glm::mat4 lightSpaceMatrix;
+		glm::vec3 cameraPosition;
+		float gamma;
+		glm::vec2 viewportResolution;
+		int32_t solidMode;
+		int32_t castShadows;
+		int32_t enableSSAO;
+		int32_t padding[3];
+	};
+
+	// Material table entry (std430)
+	// Textures are referenced by their bindless handle, or by texture array and layer without bindless textures (DIRECT_TEXTURE and texture map if bound directly)
+	struct MaterialData
+	{
+		glm::vec4 baseColor;
+		glm::vec2 tiling;
+		glm::vec2 offset;
+		glm::vec3 emissionColor;
+		float emissionIntensity;
+		float roughness;
+		float metallic;
+		float normalMapIntensity;
+		float heightMapScale;
+		int32_t emission;
+		int32_t enableAlbedoMap;
+		int32_t enableRoughnessMap;
+		int32_t enableMetallicMap;
+		int32_t enableNormalMap;
+		int32_t enableOcclusionMap;
+		int32_t enableEmissiveMap;
+		int32_t enableHeightMap;
+		glm::uvec2 albedoMap;
+		glm::uvec2 roughnessMap;
+		glm::uvec2 metallicMap;
+		glm::uvec2 normalMap;
+		glm::uvec2 occlusionMap;
+		glm::uvec2 emissiveMap;
+		glm::uvec2 heightMap;
+		uint32_t padding[2];
+	};
+
+	// Uniform buffers shared by all lit materials
+	static uint32_t frameBuffer;
+	static uint32_t viewBuffer;
+
+	// Storage buffer holding the material data of all lit materials
+	static uint32_t materialTable;
+	static uint32_t materialTableCapacity;
+
+	// Amount of material table entries handed out so far, including released ones
+	static uint32_t nMaterialSlots;
+
+	// Released material table entries
+	static std::vector<uint32_t> freeMaterialSlots;
+
+	// Creates the shared uniform buffers if they don't exist yet
+	static void createSharedBuffers();
+
+	// Uploads the given frame data to the shared frame buffer
+	static void uploadFrameData(const FrameData& frameData);
+
+	// Reserves an entry of the material table, growing it if it's full
+	static uint32_t allocateMaterialSlot();
+
+	// Texture maps of a material, indexing the units of textures that are bound directly
+	enum TextureMaps
+	{
+		ALBEDO_MAP,
+		ROUGHNESS_MAP,
+		METALLIC_MAP,
+		NORMAL_MAP,
+		OCCLUSION_MAP,
+		EMISSIVE_MAP,
+		HEIGHT_MAP,
+		TEXTURE_MAP_COUNT
+	};
+
+	// Texture array index of references to textures bound directly, their layer is the texture map
+	static constexpr uint32_t DIRECT_TEXTURE = UINT32_MAX;
+
+	// Returns the reference the lit shader samples the given texture map by, false if there is no texture
+	// Textures that can't be packed into a texture array are remembered to be bound directly
+	bool textureReference(const ResourceRef<Texture>& texture, TextureMaps map, glm::uvec2& reference) const;
+
+	// Returns if any texture map was replaced, reloaded or evicted since the last upload
+	bool texturesChanged() const;
+
+	// Uploads the material data if the material was marked dirty or any texture changed since the last upload
+	void syncMaterialData() const;
+
 	enum TextureUnits
 	{
-		ALBEDO_UNIT,
-		NORMAL_UNIT,
-		ROUGHNESS_UNIT,
-		METALLIC_UNIT,
-		OCCLUSION_UNIT,
-		EMISSIVE_UNIT,
-		HEIGHT_UNIT,
 		SHADOW_DISK_UNIT,
 		SHADOW_MAP_UNIT,
-		SSAO_UNIT
+		SSAO_UNIT,
+		TEXTURE_ARRAYS_UNIT, // First of the units texture arrays are bound to without bindless textures
+		DIRECT_TEXTURES_UNIT = TEXTURE_ARRAYS_UNIT + TextureArrayPool::MAX_ARRAYS // First of the units of textures that couldn't be packed, one per texture map
 	};
 
 	uint32_t id;
 	ResourceRef<Shader> shader;
 	uint32_t shaderId;
+
+	// Entry of the material table holding the material data
+	uint32_t materialSlot;
+
+	// Textures of each map that couldn't be packed and are bound directly, zero if packed
+	mutable uint32_t directTextures[TEXTURE_MAP_COUNT];
+
+	// Material data of the last upload
+	mutable MaterialData materialData;
+	mutable bool materialDataUploaded;
+
+	// Set by markDirty until the next upload
+	mutable bool materialDataDirty;
+
+	// Texture and generation of each map at the last upload
+	mutable const Texture* syncedTextures[TEXTURE_MAP_COUNT];
+	mutable uint32_t syncedGenerations[TEXTURE_MAP_COUNT];
 };
\ No newline at end of file
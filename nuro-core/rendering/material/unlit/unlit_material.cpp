@@ -24,8 +24,7 @@ void UnlitMaterial::bind() const
 {
 	if (!shader) return;
 
-	shader->bind();
-
+	// Uniforms are set on the variant the caller bound
 	shader->setVec4("baseColor", baseColor);
 
 	shader->setVec2("tiling", tiling);
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <rendering/model/model.h>
+
+// Binary format of cooked models, laid out as header, mesh table, vertex data and index data
+namespace CookedModel
+{
+	// Identifies cooked model files ("NMDL")
+	constexpr uint32_t MAGIC = 0x4C444D4E;
+
+	// Version of the format, cooked models of other versions are re-cooked
+	constexpr uint32_t VERSION = 4;
+
+	// Extension appended to the source path of a model for its cooked file
+	constexpr const char* EXTENSION = ".nmdl";
+
+	// Alignment of the vertex and index data blocks of each mesh
+	constexpr uint64_t ALIGNMENT = 16;
+
+	// Header flag set if the meshes were optimized on import
+	constexpr uint32_t FLAG_OPTIMIZED = 1 << 0;
+
+	static_assert(std::is_trivially_copyable<Model::VertexData>::value, "Vertex data must be trivially copyable to be cooked");
+	static_assert(std::is_trivially_copyable<Model::Metrics>::value, "Model metrics must be trivially copyable to be cooked");
+	static_assert(std::is_trivially_copyable<Model::OptimizationStats>::value, "Optimization stats must be trivially copyable to be cooked");
+	static_assert(std::is_trivially_copyable<MeshBounds::Bounds>::value, "Mesh bounds must be trivially copyable to be cooked");
+
+	struct Header
+	{
+		uint32_t magic = MAGIC;
+		uint32_t version = VERSION;
+
+		// Size of a single vertex, cooked models with a different vertex layout are re-cooked
+		uint32_t vertexStride = sizeof(Model::VertexData);
+
+		// Amount of entries in the mesh table
+		uint32_t nMeshes = 0;
+
+		// Import settings the model was cooked with, cooked models with other settings are re-cooked
+		uint32_t flags = 0;
+		uint32_t nLodRatios = 0;
+		float lodRatios[Mesh::MAX_LODS - 1] = {};
+		uint32_t padding = 0;
+
+		// Size and last write time of the source the model was cooked from
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+
+		// Metrics of the model
+		Model::Metrics metrics;
+
+		// Vertex cache statistics of the import time optimization
+		Model::OptimizationStats optimizationStats;
+	};
+
+	struct MeshEntry
+	{
+		// Offsets of the meshes vertex and index data from the start of the file
+		uint64_t vertexOffset = 0;
+		uint64_t indexOffset = 0;
+
+		uint32_t nVertices = 0;
+		uint32_t nIndices = 0;
+		uint32_t materialIndex = 0;
+
+		// Levels of detail as ranges of the meshes indices
+		uint32_t nLods = 1;
+		Mesh::Lod lods[Mesh::MAX_LODS] = {};
+
+		// Object space bounding volumes of the meshes vertices
+		MeshBounds::Bounds volume;
+	};
+};
\ No newline at end of file
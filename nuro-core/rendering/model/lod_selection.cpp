@@ -0,0 +1,54 @@
+#include "lod_selection.h"
+
+#include <cfloat>
+#include <glad/glad.h>
+
+#include <rendering/model/mesh.h>
+
+namespace LodSelection {
+
+	float projectedScale(const glm::mat4& mvp)
+	{
+		// Clip space w of the origin, objects at or behind the camera plane always get full detail
+		float w = mvp[3][3];
+		if (w <= FLT_EPSILON) return FLT_MAX;
+
+		// Rows mapping object space offsets to clip space x and y, using the larger one
+		glm::vec3 rowX(mvp[0][0], mvp[1][0], mvp[2][0]);
+		glm::vec3 rowY(mvp[0][1], mvp[1][1], mvp[2][1]);
+		return glm::max(glm::length(rowX), glm::length(rowY)) / w;
+	}
+
+	uint32_t select(const Mesh& mesh, const glm::mat4& mvp, uint32_t currentLod, float bias)
+	{
+		if (mesh.nLods() <= 1) return 0;
+
+		float scale = projectedScale(mvp);
+		float tolerance = SCREEN_ERROR * bias;
+
+		// Levels up to the current one stay selected until their error clearly exceeds the tolerance, coarser ones need to clearly be within it
+		uint32_t lod = 0;
+		for (uint32_t i = 1; i < mesh.nLods(); i++) {
+			float margin = i <= currentLod ? 1.0f + HYSTERESIS : 1.0f - HYSTERESIS;
+			if (mesh.lod(i).error * scale > tolerance * margin) break;
+			lod = i;
+		}
+
+		return lod;
+	}
+
+	void draw(const Mesh& mesh, uint32_t lod)
+	{
+		const Mesh::Lod& range = mesh.lod(lod);
+		uintptr_t firstIndex = static_cast<uintptr_t>(mesh.firstIndex()) + range.indexOffset;
+		glDrawElementsBaseVertex(GL_TRIANGLES, range.nIndices, GL_UNSIGNED_INT, (void*)(firstIndex * sizeof(uint32_t)), mesh.baseVertex());
+	}
+
+	void drawInstanced(const Mesh& mesh, uint32_t lod, uint32_t nInstances)
+	{
+		const Mesh::Lod& range = mesh.lod(lod);
+		uintptr_t firstIndex = static_cast<uintptr_t>(mesh.firstIndex()) + range.indexOffset;
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.nIndices, GL_UNSIGNED_INT, (void*)(firstIndex * sizeof(uint32_t)), nInstances, mesh.baseVertex());
+	}
+
+}
\ No newline at end of file
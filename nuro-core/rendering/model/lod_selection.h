@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Mesh;
+
+// Per frame level of detail selection by projected geometric error
+namespace LodSelection
+{
+	// Projected error in normalized device coordinates a level of detail may cause (about a pixel at 1080p)
+	constexpr float SCREEN_ERROR = 0.002f;
+
+	// Relative margin around the switching thresholds keeping levels from flickering
+	constexpr float HYSTERESIS = 0.2f;
+
+	// Returns the scale from object space to normalized device coordinates at the origin of the given model-view-projection
+	float projectedScale(const glm::mat4& mvp);
+
+	// Returns the coarsest level of detail of the mesh within the screen error, larger biases allow coarser levels
+	uint32_t select(const Mesh& mesh, const glm::mat4& mvp, uint32_t currentLod, float bias = 1.0f);
+
+	// Draws the given level of detail of the currently bound mesh
+	void draw(const Mesh& mesh, uint32_t lod);
+
+	// Draws the given amount of instances of the given level of detail of the currently bound mesh
+	void drawInstanced(const Mesh& mesh, uint32_t lod, uint32_t nInstances);
+};
\ No newline at end of file
@@ -1,12 +1,27 @@
 #include "mesh.h"
 
-Mesh::Mesh() : _vao(0),
+#include <algorithm>
+
+uint32_t Mesh::instances = 0;
+
+Mesh::Mesh() : _id(0),
+_vao(0),
 _vbo(0),
 _ebo(0),
 _nVertices(0),
 _nIndices(0),
-_materialIndex(0)
+_materialIndex(0),
+_baseVertex(0),
+_firstIndex(0),
+_lods(),
+_nLods(1),
+_bounds(),
+_packed(false),
+_positionOrigin(0.0f),
+_positionExtent(1.0f)
 {
+	instances++;
+	_id = instances;
 }
 
 void Mesh::setData(uint32_t _vao, uint32_t _vbo, uint32_t _ebo, uint32_t _nVertices, uint32_t _nIndices, uint32_t _materialIndex)
@@ -17,6 +32,42 @@ void Mesh::setData(uint32_t _vao, uint32_t _vbo, uint32_t _ebo, uint32_t _nVerti
 	this->_nVertices = _nVertices;
 	this->_nIndices = _nIndices;
 	this->_materialIndex = _materialIndex;
+	this->_baseVertex = 0;
+	this->_firstIndex = 0;
+
+	// Full detail level covers all indices until other levels are set
+	_lods[0] = Lod();
+	_lods[0].nIndices = _nIndices;
+	_nLods = 1;
+}
+
+void Mesh::setRange(uint32_t _baseVertex, uint32_t _firstIndex)
+{
+	this->_baseVertex = _baseVertex;
+	this->_firstIndex = _firstIndex;
+}
+
+void Mesh::setLods(const Lod* lods, uint32_t nLods)
+{
+	_nLods = std::clamp(nLods, 1u, MAX_LODS);
+	for (uint32_t i = 0; i < _nLods; i++) _lods[i] = lods[i];
+}
+
+void Mesh::setBounds(const MeshBounds::Bounds& _bounds)
+{
+	this->_bounds = _bounds;
+}
+
+void Mesh::setPacking(bool _packed, glm::vec3 _positionOrigin, glm::vec3 _positionExtent)
+{
+	this->_packed = _packed;
+	this->_positionOrigin = _positionOrigin;
+	this->_positionExtent = _positionExtent;
+}
+
+uint32_t Mesh::id() const
+{
+	return _id;
 }
 
 uint32_t Mesh::vao() const
@@ -47,4 +98,44 @@ uint32_t Mesh::indiceCount() const
 uint32_t Mesh::materialIndex() const
 {
 	return _materialIndex;
+}
+
+uint32_t Mesh::baseVertex() const
+{
+	return _baseVertex;
+}
+
+uint32_t Mesh::firstIndex() const
+{
+	return _firstIndex;
+}
+
+uint32_t Mesh::nLods() const
+{
+	return _nLods;
+}
+
+const Mesh::Lod& Mesh::lod(uint32_t index) const
+{
+	return _lods[std::min(index, _nLods - 1)];
+}
+
+const MeshBounds::Bounds& Mesh::bounds() const
+{
+	return _bounds;
+}
+
+bool Mesh::packed() const
+{
+	return _packed;
+}
+
+glm::vec3 Mesh::positionOrigin() const
+{
+	return _positionOrigin;
+}
+
+glm::vec3 Mesh::positionExtent() const
+{
+	return _positionExtent;
 }
\ No newline at end of file
@@ -1,17 +1,54 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
+#include <rendering/culling/mesh_bounds.h>
+
 class Mesh
 {
 public:
 	Mesh();
 
+	// Instance counter
+	static uint32_t instances;
+
+	// Maximum amount of levels of detail of a mesh, including the full detail level
+	static constexpr uint32_t MAX_LODS = 4;
+
+	// Range of a level of detail within the meshes index buffer
+	struct Lod
+	{
+		// Offset of the levels first index
+		uint32_t indexOffset = 0;
+
+		// Amount of indices of the level
+		uint32_t nIndices = 0;
+
+		// Object space geometric deviation from the full detail level
+		float error = 0.0f;
+	};
+
 	// Sets the meshes existing backend buffers and metrics
 	void setData(uint32_t vao, uint32_t vbo, uint32_t ebo, uint32_t nVertices, uint32_t nIndices, uint32_t materialIndex);
+
+	// Sets the offsets of the meshes vertices and indices within the shared buffers they live in
+	void setRange(uint32_t baseVertex, uint32_t firstIndex);
+
+	// Sets the meshes levels of detail ordered from full to lowest detail, the first level is set by setData
+	void setLods(const Lod* lods, uint32_t nLods);
+
+	// Sets the meshes object space bounding volumes
+	void setBounds(const MeshBounds::Bounds& bounds);
+
+	// Sets if the meshes vertices use the packed vertex format and the bounds its positions are quantized within
+	void setPacking(bool packed, glm::vec3 positionOrigin = glm::vec3(0.0f), glm::vec3 positionExtent = glm::vec3(1.0f));
 	
+	// Returns the meshes unique id, stable while meshes share backend buffers
+	uint32_t id() const;
+
 	// Returns the meshes vertex array object
 	uint32_t vao() const;
 
@@ -30,7 +67,33 @@ public:
 	// Returns the meshes material index related to the parent model
 	uint32_t materialIndex() const;
 
+	// Returns the offset of the meshes first vertex within its vertex buffer
+	uint32_t baseVertex() const;
+
+	// Returns the offset of the meshes first index within its element buffer
+	uint32_t firstIndex() const;
+
+	// Returns the meshes amount of levels of detail
+	uint32_t nLods() const;
+
+	// Returns the meshes level of detail at the given index, clamped to the lowest detail level
+	const Lod& lod(uint32_t index) const;
+
+	// Returns the meshes object space bounding volumes
+	const MeshBounds::Bounds& bounds() const;
+
+	// Returns if the meshes vertices use the packed vertex format
+	bool packed() const;
+
+	// Returns the origin of the bounds the meshes positions are quantized within
+	glm::vec3 positionOrigin() const;
+
+	// Returns the extent of the bounds the meshes positions are quantized within
+	glm::vec3 positionExtent() const;
+
 private:
+	uint32_t _id;
+
 	uint32_t _vao;
 	uint32_t _vbo;
 	uint32_t _ebo;
@@ -38,4 +101,16 @@ private:
 	uint32_t _nVertices;
 	uint32_t _nIndices;
 	uint32_t _materialIndex;
+
+	uint32_t _baseVertex;
+	uint32_t _firstIndex;
+
+	std::array<Lod, MAX_LODS> _lods;
+	uint32_t _nLods;
+
+	MeshBounds::Bounds _bounds;
+
+	bool _packed;
+	glm::vec3 _positionOrigin;
+	glm::vec3 _positionExtent;
 };
\ No newline at end of file
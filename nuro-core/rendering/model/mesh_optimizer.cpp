@@ -0,0 +1,589 @@
+#include "mesh_optimizer.h"
+
+#include <cmath>
+#include <vector>
+#include <unordered_set>
+#include <cstring>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace MeshOptimizer {
+
+	// Marks empty hash table slots and unused vertices
+	constexpr uint32_t INVALID = UINT32_MAX;
+
+	// Forsyth scoring parameters
+	constexpr uint32_t SCORE_CACHE_SIZE = 32;
+	constexpr float CACHE_DECAY_POWER = 1.5f;
+	constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	// Maximum amount of edge collapse passes when simplifying
+	constexpr uint32_t MAX_SIMPLIFY_PASSES = 32;
+
+	// Fifo post transform cache simulation using insertion timestamps
+	struct FifoCache
+	{
+		std::vector<uint32_t> timestamps;
+		uint32_t time;
+		uint32_t size;
+
+		FifoCache(size_t nVertices, uint32_t size) : timestamps(nVertices, 0),
+			time(size + 1),
+			size(size)
+		{
+		};
+
+		// Returns 1 if the vertex missed the cache and had to be transformed
+		uint32_t access(uint32_t vertex)
+		{
+			if (time - timestamps[vertex] <= size) return 0;
+			timestamps[vertex] = time++;
+			return 1;
+		}
+
+		// Returns the misses of the given triangle
+		uint32_t access(const uint32_t* triangle)
+		{
+			return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+		}
+
+		// Invalidates all cached vertices
+		void reset()
+		{
+			time += size + 1;
+		}
+	};
+
+	// Symmetric 4x4 matrix accumulating area weighted planes
+	struct Quadric
+	{
+		float a00 = 0.0f, a01 = 0.0f, a02 = 0.0f, a03 = 0.0f;
+		float a11 = 0.0f, a12 = 0.0f, a13 = 0.0f;
+		float a22 = 0.0f, a23 = 0.0f;
+		float a33 = 0.0f;
+		float weight = 0.0f;
+
+		// Adds the plane with the given unit normal and distance
+		void addPlane(const glm::vec3& n, float d, float w)
+		{
+			a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z; a03 += w * n.x * d;
+			a11 += w * n.y * n.y; a12 += w * n.y * n.z; a13 += w * n.y * d;
+			a22 += w * n.z * n.z; a23 += w * n.z * d;
+			a33 += w * d * d;
+			weight += w;
+		}
+
+		Quadric& operator+=(const Quadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+			a11 += other.a11; a12 += other.a12; a13 += other.a13;
+			a22 += other.a22; a23 += other.a23;
+			a33 += other.a33;
+			weight += other.weight;
+			return *this;
+		}
+
+		// Returns the weighted mean squared distance of the point to the accumulated planes
+		float error(const glm::vec3& p) const
+		{
+			float rx = a00 * p.x + a01 * p.y + a02 * p.z + a03;
+			float ry = a01 * p.x + a11 * p.y + a12 * p.z + a13;
+			float rz = a02 * p.x + a12 * p.y + a22 * p.z + a23;
+			float rw = a03 * p.x + a13 * p.y + a23 * p.z + a33;
+			float e = rx * p.x + ry * p.y + rz * p.z + rw;
+			return weight > 0.0f ? std::abs(e) / weight : 0.0f;
+		}
+	};
+
+	// FNV-1a hash of the given bytes
+	static uint64_t _hashBytes(const uint8_t* data, size_t size)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Returns the position of the given vertex
+	static glm::vec3 _position(const uint8_t* positions, size_t stride, uint32_t vertex)
+	{
+		glm::vec3 position;
+		std::memcpy(&position, positions + vertex * stride, sizeof(glm::vec3));
+		return position;
+	}
+
+	// Returns the Forsyth score of a vertex by its position in the cache and its amount of remaining triangles
+	static float _vertexScore(int32_t cachePosition, uint32_t nRemaining)
+	{
+		if (nRemaining == 0) return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0) {
+			// Vertices of the last triangle get a fixed score so triangles sharing an edge with it don't win too easily
+			if (cachePosition < 3) score = LAST_TRIANGLE_SCORE;
+			else score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(SCORE_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+		}
+
+		// Boost vertices with few remaining triangles to get rid of lone triangles early
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(nRemaining), -VALENCE_BOOST_POWER);
+		return score;
+	}
+
+	float CacheStats::acmr() const
+	{
+		return nTriangles ? static_cast<float>(nTransforms) / static_cast<float>(nTriangles) : 0.0f;
+	}
+
+	float CacheStats::atvr() const
+	{
+		return nVertices ? static_cast<float>(nTransforms) / static_cast<float>(nVertices) : 0.0f;
+	}
+
+	CacheStats& CacheStats::operator+=(const CacheStats& other)
+	{
+		nTransforms += other.nTransforms;
+		nTriangles += other.nTriangles;
+		nVertices += other.nVertices;
+		return *this;
+	}
+
+	CacheStats analyzeVertexCache(const uint32_t* indices, size_t nIndices, size_t nVertices, uint32_t cacheSize)
+	{
+		CacheStats stats;
+		stats.nTriangles = static_cast<uint32_t>(nIndices / 3);
+
+		FifoCache cache(nVertices, cacheSize);
+		std::vector<bool> referenced(nVertices, false);
+		for (size_t i = 0; i < nIndices; i++) {
+			uint32_t vertex = indices[i];
+			stats.nTransforms += cache.access(vertex);
+			if (!referenced[vertex]) {
+				referenced[vertex] = true;
+				stats.nVertices++;
+			}
+		}
+
+		return stats;
+	}
+
+	size_t deduplicateVertices(void* vertices, size_t nVertices, size_t stride, uint32_t* indices, size_t nIndices)
+	{
+		if (nVertices == 0) return 0;
+
+		uint8_t* data = static_cast<uint8_t*>(vertices);
+
+		// Open addressing table of unique vertices, at most half full
+		size_t tableSize = 1;
+		while (tableSize < nVertices * 2) tableSize <<= 1;
+		std::vector<uint32_t> table(tableSize, INVALID);
+		std::vector<uint32_t> remap(nVertices);
+
+		size_t nUnique = 0;
+		for (size_t i = 0; i < nVertices; i++) {
+			const uint8_t* vertex = data + i * stride;
+			size_t slot = _hashBytes(vertex, stride) & (tableSize - 1);
+			while (table[slot] != INVALID && std::memcmp(data + table[slot] * stride, vertex, stride) != 0)
+				slot = (slot + 1) & (tableSize - 1);
+
+			// First occurence of vertex, compact it towards the front
+			if (table[slot] == INVALID) {
+				if (nUnique != i) std::memcpy(data + nUnique * stride, vertex, stride);
+				table[slot] = static_cast<uint32_t>(nUnique++);
+			}
+
+			remap[i] = table[slot];
+		}
+
+		for (size_t i = 0; i < nIndices; i++)
+			indices[i] = remap[indices[i]];
+
+		return nUnique;
+	}
+
+	void optimizeVertexCache(uint32_t* indices, size_t nIndices, size_t nVertices)
+	{
+		size_t nTriangles = nIndices / 3;
+		if (nTriangles == 0) return;
+
+		// Build vertex to triangle adjacency, the first nRemaining entries of each vertex are its triangles not emitted yet
+		std::vector<uint32_t> nRemaining(nVertices, 0);
+		for (size_t i = 0; i < nTriangles * 3; i++) nRemaining[indices[i]]++;
+
+		std::vector<uint32_t> offsets(nVertices + 1, 0);
+		for (size_t i = 0; i < nVertices; i++) offsets[i + 1] = offsets[i] + nRemaining[i];
+
+		std::vector<uint32_t> adjacency(nTriangles * 3);
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < nTriangles * 3; i++) adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+		// Initial scores
+		std::vector<int32_t> cachePositions(nVertices, -1);
+		std::vector<float> vertexScores(nVertices);
+		for (size_t i = 0; i < nVertices; i++) vertexScores[i] = _vertexScore(-1, nRemaining[i]);
+
+		std::vector<float> triangleScores(nTriangles);
+		for (size_t i = 0; i < nTriangles; i++)
+			triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+
+		std::vector<bool> emitted(nTriangles, false);
+		std::vector<uint32_t> output;
+		output.reserve(nTriangles * 3);
+
+		std::vector<uint32_t> cache, nextCache;
+		cache.reserve(SCORE_CACHE_SIZE + 3);
+		nextCache.reserve(SCORE_CACHE_SIZE + 3);
+
+		// Triangles not reachable through the cache are picked in input order
+		size_t cursor = 0;
+		int64_t best = 0;
+
+		while (best >= 0) {
+			uint32_t triangle = static_cast<uint32_t>(best);
+			const uint32_t* vertices = indices + triangle * 3;
+
+			// Emit triangle and remove it from the adjacency of its vertices
+			emitted[triangle] = true;
+			for (uint32_t k = 0; k < 3; k++) {
+				uint32_t vertex = vertices[k];
+				output.push_back(vertex);
+
+				uint32_t* triangles = adjacency.data() + offsets[vertex];
+				for (uint32_t j = 0; j < nRemaining[vertex]; j++) {
+					if (triangles[j] != triangle) continue;
+					triangles[j] = triangles[nRemaining[vertex] - 1];
+					nRemaining[vertex]--;
+					break;
+				}
+			}
+
+			// Move triangles vertices to the front of the cache
+			nextCache.clear();
+			nextCache.insert(nextCache.end(), vertices, vertices + 3);
+			for (uint32_t vertex : cache)
+				if (vertex != vertices[0] && vertex != vertices[1] && vertex != vertices[2]) nextCache.push_back(vertex);
+			std::swap(cache, nextCache);
+
+			// Update scores of cached vertices and of vertices falling out of the cache
+			for (size_t i = 0; i < cache.size(); i++) {
+				uint32_t vertex = cache[i];
+				cachePositions[vertex] = i < SCORE_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+				float score = _vertexScore(cachePositions[vertex], nRemaining[vertex]);
+				float delta = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				const uint32_t* triangles = adjacency.data() + offsets[vertex];
+				for (uint32_t j = 0; j < nRemaining[vertex]; j++) triangleScores[triangles[j]] += delta;
+			}
+			if (cache.size() > SCORE_CACHE_SIZE) cache.resize(SCORE_CACHE_SIZE);
+
+			// Pick best scoring triangle adjacent to the cache
+			best = -1;
+			float bestScore = -1.0f;
+			for (uint32_t vertex : cache) {
+				const uint32_t* triangles = adjacency.data() + offsets[vertex];
+				for (uint32_t j = 0; j < nRemaining[vertex]; j++) {
+					if (triangleScores[triangles[j]] <= bestScore) continue;
+					bestScore = triangleScores[triangles[j]];
+					best = triangles[j];
+				}
+			}
+
+			if (best < 0) {
+				while (cursor < nTriangles && emitted[cursor]) cursor++;
+				if (cursor < nTriangles) best = static_cast<int64_t>(cursor);
+			}
+		}
+
+		std::memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+	}
+
+	void optimizeOverdraw(uint32_t* indices, size_t nIndices, const void* positions, size_t nVertices, size_t stride, float threshold)
+	{
+		size_t nTriangles = nIndices / 3;
+		if (nTriangles == 0) return;
+
+		const uint8_t* positionData = static_cast<const uint8_t*>(positions);
+		FifoCache cache(nVertices, CACHE_SIZE);
+
+		// Hard cluster boundaries wherever the cache optimized order restarts, missing all vertices of a triangle
+		std::vector<uint32_t> hardBoundaries;
+		for (uint32_t i = 0; i < nTriangles; i++)
+			if (cache.access(indices + i * 3) == 3) hardBoundaries.push_back(i);
+		hardBoundaries.push_back(static_cast<uint32_t>(nTriangles));
+		if (hardBoundaries.front() != 0) hardBoundaries.insert(hardBoundaries.begin(), 0);
+
+		// Soft boundaries split hard clusters wherever the cache efficiency so far stays within threshold of the whole clusters
+		std::vector<uint32_t> clusters;
+		for (size_t c = 0; c + 1 < hardBoundaries.size(); c++) {
+			uint32_t start = hardBoundaries[c], end = hardBoundaries[c + 1];
+
+			cache.reset();
+			uint32_t clusterMisses = 0;
+			for (uint32_t i = start; i < end; i++) clusterMisses += cache.access(indices + i * 3);
+			float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+			cache.reset();
+			clusters.push_back(start);
+			uint32_t misses = 0, triangles = 0;
+			for (uint32_t i = start; i < end; i++) {
+				misses += cache.access(indices + i * 3);
+				triangles++;
+
+				if (i + 1 < end && static_cast<float>(misses) / static_cast<float>(triangles) <= threshold * clusterAcmr) {
+					clusters.push_back(i + 1);
+					cache.reset();
+					misses = 0;
+					triangles = 0;
+				}
+			}
+		}
+		clusters.push_back(static_cast<uint32_t>(nTriangles));
+
+		// Area weighted centroid and normal of each cluster and of the whole mesh
+		size_t nClusters = clusters.size() - 1;
+		std::vector<glm::vec3> clusterCentroids(nClusters, glm::vec3(0.0f));
+		std::vector<glm::vec3> clusterNormals(nClusters, glm::vec3(0.0f));
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+
+		for (size_t c = 0; c < nClusters; c++) {
+			float clusterArea = 0.0f;
+			for (uint32_t i = clusters[c]; i < clusters[c + 1]; i++) {
+				glm::vec3 a = _position(positionData, stride, indices[i * 3]);
+				glm::vec3 b = _position(positionData, stride, indices[i * 3 + 1]);
+				glm::vec3 d = _position(positionData, stride, indices[i * 3 + 2]);
+
+				glm::vec3 normal = glm::cross(b - a, d - a);
+				float area = glm::length(normal);
+
+				clusterCentroids[c] += (a + b + d) * (area / 3.0f);
+				clusterNormals[c] += normal;
+				clusterArea += area;
+			}
+
+			meshCentroid += clusterCentroids[c];
+			meshArea += clusterArea;
+			if (clusterArea > 0.0f) clusterCentroids[c] /= clusterArea;
+		}
+		if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+		// Draw clusters facing away from the meshes center first, they are most likely to occlude the others
+		std::vector<float> sortKeys(nClusters);
+		for (size_t c = 0; c < nClusters; c++) {
+			float normalLength = glm::length(clusterNormals[c]);
+			sortKeys[c] = normalLength > 0.0f ? glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / normalLength) : 0.0f;
+		}
+
+		std::vector<uint32_t> order(nClusters);
+		for (size_t c = 0; c < nClusters; c++) order[c] = static_cast<uint32_t>(c);
+		std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<uint32_t> output;
+		output.reserve(nTriangles * 3);
+		for (uint32_t c : order)
+			output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+
+		std::memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+	}
+
+	size_t simplify(uint32_t* destination, const uint32_t* indices, size_t nIndices, const void* positions, size_t nVertices, size_t stride, size_t targetIndexCount, float* resultError)
+	{
+		const uint8_t* positionData = static_cast<const uint8_t*>(positions);
+		std::vector<uint32_t> result(indices, indices + nIndices / 3 * 3);
+		float error = 0.0f;
+
+		// Vertices sharing a position are represented by the first of them
+		std::vector<uint32_t> positionIds(nVertices);
+		std::vector<uint32_t> nWedges(nVertices, 0);
+		{
+			size_t tableSize = 1;
+			while (tableSize < nVertices * 2) tableSize <<= 1;
+			std::vector<uint32_t> table(tableSize, INVALID);
+
+			for (size_t i = 0; i < nVertices; i++) {
+				const uint8_t* position = positionData + i * stride;
+				size_t slot = _hashBytes(position, sizeof(glm::vec3)) & (tableSize - 1);
+				while (table[slot] != INVALID && std::memcmp(positionData + table[slot] * stride, position, sizeof(glm::vec3)) != 0)
+					slot = (slot + 1) & (tableSize - 1);
+
+				if (table[slot] == INVALID) table[slot] = static_cast<uint32_t>(i);
+				positionIds[i] = table[slot];
+				nWedges[table[slot]]++;
+			}
+		}
+
+		// Positions on open borders have an edge without opposite edge
+		std::vector<bool> borderPositions(nVertices, false);
+		{
+			auto edgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(a) << 32) | b; };
+
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(result.size());
+			for (size_t i = 0; i < result.size(); i += 3)
+				for (uint32_t k = 0; k < 3; k++)
+					edges.insert(edgeKey(positionIds[result[i + k]], positionIds[result[i + (k + 1) % 3]]));
+
+			for (uint64_t edge : edges) {
+				uint32_t a = static_cast<uint32_t>(edge >> 32), b = static_cast<uint32_t>(edge);
+				if (edges.count(edgeKey(b, a))) continue;
+				borderPositions[a] = true;
+				borderPositions[b] = true;
+			}
+		}
+
+		// Vertices on borders and attribute seams never move
+		std::vector<bool> locked(nVertices);
+		for (size_t i = 0; i < nVertices; i++)
+			locked[i] = borderPositions[positionIds[i]] || nWedges[positionIds[i]] > 1;
+
+		// Accumulate the planes of each vertices triangles
+		std::vector<Quadric> quadrics(nVertices);
+		for (size_t i = 0; i < result.size(); i += 3) {
+			glm::vec3 p0 = _position(positionData, stride, result[i]);
+			glm::vec3 p1 = _position(positionData, stride, result[i + 1]);
+			glm::vec3 p2 = _position(positionData, stride, result[i + 2]);
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			if (area <= 0.0f) continue;
+
+			normal /= area;
+			float distance = -glm::dot(normal, p0);
+			for (uint32_t k = 0; k < 3; k++) quadrics[result[i + k]].addPlane(normal, distance, area);
+		}
+
+		// Collapse of a vertex onto a neighbouring vertex
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			float cost;
+		};
+
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(nVertices);
+		std::vector<bool> touched(nVertices);
+		std::vector<uint32_t> offsets(nVertices + 1);
+		std::vector<uint32_t> adjacency;
+
+		auto collapseCost = [&](uint32_t from, uint32_t to) {
+			Quadric quadric = quadrics[from];
+			quadric += quadrics[to];
+			return quadric.error(_position(positionData, stride, to));
+		};
+
+		// Returns true if moving the vertex would flip one of its remaining triangles
+		auto collapseFlips = [&](const Collapse& collapse) {
+			glm::vec3 target = _position(positionData, stride, collapse.to);
+			for (uint32_t j = offsets[collapse.from]; j < offsets[collapse.from + 1]; j++) {
+				const uint32_t* triangle = result.data() + adjacency[j] * 3;
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) continue;
+
+				glm::vec3 before[3], after[3];
+				for (uint32_t k = 0; k < 3; k++) {
+					before[k] = _position(positionData, stride, triangle[k]);
+					after[k] = triangle[k] == collapse.from ? target : before[k];
+				}
+
+				glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				if (glm::dot(normalBefore, normalAfter) <= 0.0f) return true;
+			}
+			return false;
+		};
+
+		for (uint32_t pass = 0; pass < MAX_SIMPLIFY_PASSES && result.size() > targetIndexCount; pass++) {
+			size_t nTriangles = result.size() / 3;
+
+			// Build vertex to triangle adjacency of the current triangles
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (uint32_t index : result) offsets[index + 1]++;
+			for (size_t i = 0; i < nVertices; i++) offsets[i + 1] += offsets[i];
+			adjacency.resize(result.size());
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < result.size(); i++) adjacency[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+
+			// Candidate collapses of unlocked vertices along each edge
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (uint32_t k = 0; k < 3; k++) {
+					uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+					if (!locked[a]) collapses.push_back({ a, b, collapseCost(a, b) });
+					if (!locked[b]) collapses.push_back({ b, a, collapseCost(b, a) });
+				}
+			}
+			if (collapses.empty()) break;
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+			// Only the cheaper half is considered per pass so expensive collapses wait for cheaper ones to settle
+			size_t nCandidates = (collapses.size() + 1) / 2;
+			size_t trianglesToRemove = nTriangles - targetIndexCount / 3;
+			size_t trianglesRemoved = 0;
+
+			for (size_t i = 0; i < nVertices; i++) remap[i] = static_cast<uint32_t>(i);
+			std::fill(touched.begin(), touched.end(), false);
+
+			for (size_t i = 0; i < nCandidates && trianglesRemoved < trianglesToRemove; i++) {
+				const Collapse& collapse = collapses[i];
+				if (touched[collapse.from] || touched[collapse.to]) continue;
+				if (collapseFlips(collapse)) continue;
+
+				// Neighbourhood of the collapse can't change again within this pass
+				for (uint32_t j = offsets[collapse.from]; j < offsets[collapse.from + 1]; j++) {
+					const uint32_t* triangle = result.data() + adjacency[j] * 3;
+					for (uint32_t k = 0; k < 3; k++) touched[triangle[k]] = true;
+					if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) trianglesRemoved++;
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to] += quadrics[collapse.from];
+				error = std::max(error, std::sqrt(collapse.cost));
+			}
+			if (trianglesRemoved == 0) break;
+
+			// Apply collapses and drop degenerate triangles
+			size_t nWritten = 0;
+			for (size_t i = 0; i < result.size(); i += 3) {
+				uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+				if (a == b || b == c || a == c) continue;
+				result[nWritten++] = a;
+				result[nWritten++] = b;
+				result[nWritten++] = c;
+			}
+			result.resize(nWritten);
+		}
+
+		std::memcpy(destination, result.data(), result.size() * sizeof(uint32_t));
+		if (resultError) *resultError = error;
+		return result.size();
+	}
+
+	size_t optimizeVertexFetch(void* vertices, size_t nVertices, size_t stride, uint32_t* indices, size_t nIndices)
+	{
+		uint8_t* data = static_cast<uint8_t*>(vertices);
+
+		// Number vertices in order of first use
+		std::vector<uint32_t> remap(nVertices, INVALID);
+		uint32_t nUsed = 0;
+		for (size_t i = 0; i < nIndices; i++) {
+			uint32_t& target = remap[indices[i]];
+			if (target == INVALID) target = nUsed++;
+			indices[i] = target;
+		}
+
+		// Move vertices to their new positions
+		std::vector<uint8_t> reordered(static_cast<size_t>(nUsed) * stride);
+		for (size_t i = 0; i < nVertices; i++)
+			if (remap[i] != INVALID) std::memcpy(reordered.data() + remap[i] * stride, data + i * stride, stride);
+		std::memcpy(data, reordered.data(), reordered.size());
+
+		return nUsed;
+	}
+
+}
\ No newline at end of file
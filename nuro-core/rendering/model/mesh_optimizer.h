@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Import time optimizations of indexed triangle meshes
+namespace MeshOptimizer
+{
+	// Size of the simulated post transform vertex cache
+	constexpr uint32_t CACHE_SIZE = 16;
+
+	// Post transform vertex cache statistics of an index buffer
+	struct CacheStats
+	{
+		// Amount of simulated vertex shader invocations
+		uint32_t nTransforms = 0;
+
+		// Amount of triangles
+		uint32_t nTriangles = 0;
+
+		// Amount of referenced vertices
+		uint32_t nVertices = 0;
+
+		// Returns the average cache miss ratio (transformed vertices per triangle, 0.5 is optimal)
+		float acmr() const;
+
+		// Returns the average transform to vertex ratio (1.0 is optimal)
+		float atvr() const;
+
+		CacheStats& operator+=(const CacheStats& other);
+	};
+
+	// Simulates a fifo post transform vertex cache of the given size over the index buffer
+	CacheStats analyzeVertexCache(const uint32_t* indices, size_t nIndices, size_t nVertices, uint32_t cacheSize = CACHE_SIZE);
+
+	// Merges bitwise identical vertices of the given stride and remaps the indices, returns the new vertex count
+	size_t deduplicateVertices(void* vertices, size_t nVertices, size_t stride, uint32_t* indices, size_t nIndices);
+
+	// Reorders triangles for post transform vertex cache locality (Forsyth)
+	void optimizeVertexCache(uint32_t* indices, size_t nIndices, size_t nVertices);
+
+	// Reorders clusters of cache optimized triangles front to back to reduce overdraw, keeping the cache efficiency within threshold
+	void optimizeOverdraw(uint32_t* indices, size_t nIndices, const void* positions, size_t nVertices, size_t stride, float threshold = 1.05f);
+
+	// Simplifies the mesh towards the target index count by quadric error edge collapses, keeping open borders and attribute seams intact
+	// Writes the simplified indices to destination which must hold nIndices, returns their count and optionally the resulting object space error
+	size_t simplify(uint32_t* destination, const uint32_t* indices, size_t nIndices, const void* positions, size_t nVertices, size_t stride, size_t targetIndexCount, float* resultError = nullptr);
+
+	// Reorders vertices in order of first use for vertex fetch locality and drops unused vertices, returns the new vertex count
+	size_t optimizeVertexFetch(void* vertices, size_t nVertices, size_t stride, uint32_t* indices, size_t nIndices);
+};
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "model.h"
 
+#include <atomic>
 #include <vector>
+#include <tuple>
+#include <numeric>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <optional>
+#include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <glad/glad.h>
 
 #include <assimp/scene.h>
@@ -10,13 +19,21 @@
 
 #include <utils/fsutil.h>
 #include <utils/console.h>
+#include <utils/mapped_file.h>
 #include <utils/string_helper.h>
+#include <context/application_context.h>
+#include <rendering/model/cooked_model.h>
 #include <rendering/transformation/transformation.h>
 
 Model::Model() : sourcePath(),
+packVertices(false),
+optimizeMeshes(true),
+lodRatios({ 0.5f, 0.25f, 0.125f }),
 meshData(),
 meshes(),
-metrics()
+allocations(),
+metrics(),
+optimizationStats()
 {
 }
 
@@ -35,6 +52,25 @@ void Model::setSource(const FS::Path& _sourcePath)
 	sourcePath = _sourcePath;
 }
 
+void Model::setVertexPacking(bool _packVertices)
+{
+	packVertices = _packVertices;
+}
+
+void Model::setLodRatios(const std::vector<float>& _lodRatios)
+{
+	lodRatios.clear();
+	for (float ratio : _lodRatios) {
+		if (lodRatios.size() == Mesh::MAX_LODS - 1) break;
+		if (ratio > 0.0f && ratio < 1.0f) lodRatios.push_back(ratio);
+	}
+}
+
+void Model::setMeshOptimization(bool _optimizeMeshes)
+{
+	optimizeMeshes = _optimizeMeshes;
+}
+
 const Mesh* Model::queryMesh(uint32_t index)
 {
 	// Return queried mesh (Creates empty mesh if requested mesh is not existing yet)
@@ -51,6 +87,22 @@ Model::Metrics Model::getMetrics() const
 	return metrics;
 }
 
+Model::OptimizationStats Model::getOptimizationStats() const
+{
+	return optimizationStats;
+}
+
+ResourceFootprint Model::footprint() const
+{
+	// Models aren't evictable as their meshes are referenced directly, they only report their memory
+	ResourceFootprint footprint;
+	for (const MeshData& mesh : meshData) {
+		footprint.cpu += mesh.vertices.capacity() * sizeof(VertexData) + mesh.packedVertices.capacity() * sizeof(VertexFormat::PackedVertex) + mesh.indices.capacity() * sizeof(uint32_t);
+		footprint.gpu += mesh.nVertices * mesh.vertexSize() + mesh.nIndices * sizeof(uint32_t);
+	}
+	return footprint;
+}
+
 Mesh* Model::createStaticMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices)
 {
 	// Get mesh data metrics
@@ -58,68 +110,127 @@ Mesh* Model::createStaticMesh(std::vector<VertexData>& vertices, std::vector<uin
 	uint32_t nIndices = indices.size();
 	uint32_t materialIndex = 0;
 
-	// VAO, VBO and EBO backend ids
-	uint32_t vao, vbo, ebo;
-
-	// Generate VAO, VBO and EBO
-	glGenVertexArrays(1, &vao);
-	glGenBuffers(1, &vbo);
-	glGenBuffers(1, &ebo);
-
-	// Bind VAO
-	glBindVertexArray(vao);
-
-	// Bind VBO, allocate its memory send vertex data
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(VertexData), vertices.data(), GL_STATIC_DRAW);
-
-	// Bind EBO, allocate its memory and send indice data
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
-
-	// Set attributes for VAO
-	// Vertex position attribute (location = 0)
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
-	// Normal attribute (location = 1)
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
-	// Texture coordinates attribute (location = 2)
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, uv));
-	// Tangent attribute (location = 3)
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tangent));
-	// Bitangent attribute (location = 3)
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, bitangent));
-
-	// Unbind VAO, ABO and EBO
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	// Reserve geometry memory, static meshes are never released
+	GeometryArena& arena = ApplicationContext::geometryArena();
+	GeometryArena::Allocation allocation = arena.allocate(GeometryArena::Format::FLOAT, nVertices, nIndices);
+	if (!allocation.valid()) return new Mesh();
+
+	// Write vertex and indice data into the arenas buffers
+	glBindBuffer(GL_COPY_WRITE_BUFFER, arena.vbo(allocation));
+	glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.vertexOffset * sizeof(VertexData), nVertices * sizeof(VertexData), vertices.data());
+	glBindBuffer(GL_COPY_WRITE_BUFFER, arena.ebo(allocation));
+	glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.indexOffset * sizeof(uint32_t), nIndices * sizeof(uint32_t), indices.data());
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
 	// Create mesh container object
 	Mesh* mesh = new Mesh();
-	mesh->setData(vao, vbo, ebo, nVertices, nIndices, materialIndex);
+	mesh->setData(arena.vao(allocation), arena.vbo(allocation), arena.ebo(allocation), nVertices, nIndices, materialIndex);
+	mesh->setRange(allocation.vertexOffset, allocation.indexOffset);
+	mesh->setBounds(MeshBounds::compute(&vertices.data()->position, nVertices, sizeof(VertexData)));
 
 	// Return mesh
 	return mesh;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene)
+void Model::collectMeshes(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes) const
 {
 	for (uint32_t i = 0; i < node->mNumMeshes; i++)
 	{
-		meshData.push_back(processMesh(scene->mMeshes[node->mMeshes[i]], scene));
+		meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 	}
 	for (uint32_t i = 0; i < node->mNumChildren; i++)
 	{
-		processNode(node->mChildren[i], scene);
+		collectMeshes(node->mChildren[i], scene, meshes);
+	}
+}
+
+// Calculates per vertex tangents and bitangents from the uv derivatives of the adjacent triangles
+// Tangents are smoothed across vertices sharing position, normal and handedness like split vertices of uv seams
+static void calculateTangents(std::vector<Model::VertexData>& vertices, const std::vector<uint32_t>& indices)
+{
+	for (Model::VertexData& vertex : vertices) {
+		vertex.tangent = glm::vec3(0.0f);
+		vertex.bitangent = glm::vec3(0.0f);
+	}
+
+	// Accumulate area weighted triangle tangents
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		Model::VertexData& v0 = vertices[indices[i]];
+		Model::VertexData& v1 = vertices[indices[i + 1]];
+		Model::VertexData& v2 = vertices[indices[i + 2]];
+
+		glm::vec3 edge1 = v1.position - v0.position;
+		glm::vec3 edge2 = v2.position - v0.position;
+		glm::vec2 deltaUv1 = v1.uv - v0.uv;
+		glm::vec2 deltaUv2 = v2.uv - v0.uv;
+
+		float determinant = deltaUv1.x * deltaUv2.y - deltaUv2.x * deltaUv1.y;
+		if (std::abs(determinant) <= FLT_EPSILON) continue;
+
+		float r = 1.0f / determinant;
+		glm::vec3 tangent = (edge1 * deltaUv2.y - edge2 * deltaUv1.y) * r;
+		glm::vec3 bitangent = (edge2 * deltaUv1.x - edge1 * deltaUv2.x) * r;
+
+		v0.tangent += tangent; v1.tangent += tangent; v2.tangent += tangent;
+		v0.bitangent += bitangent; v1.bitangent += bitangent; v2.bitangent += bitangent;
+	}
+
+	// Returns if the accumulated tangent frame of a vertex is mirrored
+	auto flipped = [](const Model::VertexData& vertex) {
+		return glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f;
+	};
+
+	// Order vertices by position, normal and handedness so vertices sharing them are adjacent
+	std::vector<uint32_t> order(vertices.size());
+	std::iota(order.begin(), order.end(), 0);
+	auto key = [&](uint32_t i) {
+		const Model::VertexData& vertex = vertices[i];
+		return std::make_tuple(vertex.position.x, vertex.position.y, vertex.position.z, vertex.normal.x, vertex.normal.y, vertex.normal.z, flipped(vertex));
+	};
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return key(a) < key(b); });
+
+	// Sum the tangent frames of each group of shared vertices
+	for (size_t first = 0; first < order.size();) {
+		size_t last = first + 1;
+		while (last < order.size() && key(order[last]) == key(order[first])) last++;
+
+		if (last - first > 1) {
+			glm::vec3 tangent(0.0f);
+			glm::vec3 bitangent(0.0f);
+			for (size_t i = first; i < last; i++) {
+				tangent += vertices[order[i]].tangent;
+				bitangent += vertices[order[i]].bitangent;
+			}
+			for (size_t i = first; i < last; i++) {
+				vertices[order[i]].tangent = tangent;
+				vertices[order[i]].bitangent = bitangent;
+			}
+		}
+
+		first = last;
+	}
+
+	// Orthonormalize against the normal, keeping the handedness of the bitangent
+	for (Model::VertexData& vertex : vertices) {
+		glm::vec3 normal = vertex.normal;
+		glm::vec3 tangent = vertex.tangent - normal * glm::dot(normal, vertex.tangent);
+
+		// Fall back to any tangent perpendicular to the normal if the uvs are degenerated
+		if (glm::dot(tangent, tangent) <= FLT_EPSILON) {
+			glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+			tangent = glm::cross(axis, normal);
+		}
+		tangent = glm::normalize(tangent);
+
+		glm::vec3 bitangent = glm::cross(normal, tangent);
+		if (glm::dot(bitangent, vertex.bitangent) < 0.0f) bitangent = -bitangent;
+
+		vertex.tangent = tangent;
+		vertex.bitangent = bitangent;
 	}
 }
 
-Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
+Model::MeshData Model::processMesh(aiMesh* mesh, Metrics& meshMetrics, OptimizationStats& meshStats) const
 {
 	//
 	// INITIALIZE BUFFERS
@@ -141,8 +252,8 @@ Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
 			glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z), // POSITION
 			glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z), // NORMAL
 			mesh->mTextureCoords[0] ? glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f, 0.0f), // UV
-			glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z), // TANGENT
-			glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z) // BITANGENT
+			glm::vec3(0.0f), // TANGENT
+			glm::vec3(0.0f) // BITANGENT
 		);
 	}
 
@@ -164,6 +275,13 @@ Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
 		}
 	}
 
+	//
+	// HANDLE TANGENT SPACE
+	//
+
+	// Calculated per mesh instead of by the importer so it runs in parallel with the other meshes
+	calculateTangents(vertices, indices);
+
 	//
 	// HANDLE MESH MATERIAL
 	//
@@ -173,25 +291,94 @@ Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
 
 	// Implement texture name linking here
 
+	//
+	// OPTIMIZE MESH
+	//
+
+	if (optimizeMeshes) optimizeMesh(vertices, indices, meshStats);
+
 	//
 	// HANDLE MESH METRICS
 	//
 
-	// Update total materials metric if current material index as element count is the highest
-	metrics.nMaterials = std::max(metrics.nMaterials, materialIndex + 1);
+	// Compute the meshes bounding volumes
+	MeshBounds::Bounds volume = MeshBounds::compute(&vertices.data()->position, vertices.size(), sizeof(VertexData));
+
+	// Add mesh to its own metrics, merged into the models metrics once all meshes are processed
+	addMeshToMetrics(meshMetrics, volume, vertices.size(), mesh->mNumFaces, materialIndex);
+
+	//
+	// GENERATE LEVELS OF DETAIL
+	//
+
+	MeshData data(std::move(vertices), std::move(indices), materialIndex);
+	data.volume = volume;
+	generateLods(data);
+
+	return data;
+}
+
+void Model::optimizeMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, OptimizationStats& stats) const
+{
+	if (indices.empty()) return;
+
+	stats.before += MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	// Merge duplicate vertices, reorder triangles for the vertex cache and against overdraw, then lay out vertices in fetch order
+	size_t nVertices = MeshOptimizer::deduplicateVertices(vertices.data(), vertices.size(), sizeof(VertexData), indices.data(), indices.size());
+	MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), nVertices);
+	MeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), &vertices.data()->position, nVertices, sizeof(VertexData));
+	nVertices = MeshOptimizer::optimizeVertexFetch(vertices.data(), nVertices, sizeof(VertexData), indices.data(), indices.size());
+	vertices.resize(nVertices);
+
+	stats.after += MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+}
 
-	// Add mesh to metrics
-	addMeshToMetrics(vertices, mesh->mNumFaces);
+void Model::generateLods(MeshData& mesh) const
+{
+	std::vector<uint32_t>& indices = mesh.indices;
+	if (indices.empty()) return;
+
+	size_t nBaseIndices = indices.size();
+	std::vector<uint32_t> simplified(nBaseIndices);
+
+	// Each level is simplified from the previous one and appended to the index buffer
+	for (float ratio : lodRatios) {
+		if (mesh.nLods == Mesh::MAX_LODS) break;
+
+		Mesh::Lod previous = mesh.lods[mesh.nLods - 1];
+		size_t target = static_cast<size_t>(nBaseIndices * ratio) / 3 * 3;
+		if (target >= previous.nIndices) continue;
+
+		float error = 0.0f;
+		size_t nIndices = MeshOptimizer::simplify(simplified.data(), indices.data() + previous.indexOffset, previous.nIndices, &mesh.vertices.data()->position, mesh.vertices.size(), sizeof(VertexData), target, &error);
 
-	// Construct and return mesh data
-	return MeshData(std::move(vertices), std::move(indices), materialIndex);
+		// Stop once simplification stalls, usually on meshes made of locked borders and seams
+		if (nIndices == 0 || nIndices > previous.nIndices / 10 * 9) break;
+
+		MeshOptimizer::optimizeVertexCache(simplified.data(), nIndices, mesh.vertices.size());
+
+		Mesh::Lod& lod = mesh.lods[mesh.nLods++];
+		lod.indexOffset = static_cast<uint32_t>(indices.size());
+		lod.nIndices = static_cast<uint32_t>(nIndices);
+		lod.error = previous.error + error;
+		indices.insert(indices.end(), simplified.begin(), simplified.begin() + nIndices);
+	}
+
+	mesh.nIndices = static_cast<uint32_t>(indices.size());
 }
 
 bool Model::loadIoData()
 {
+	metrics = Metrics();
+	optimizationStats = OptimizationStats();
+
+	// Skip importing if the cooked model is up to date
+	if (loadCookedData()) return true;
+
 	// Read file
 	Assimp::Importer import;
-	const uint32_t importSettings = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+	const uint32_t importSettings = aiProcess_Triangulate | aiProcess_FlipUVs;
 	const aiScene* scene = import.ReadFile(sourcePath.string(), importSettings);
 
 	// Validate model
@@ -208,80 +395,369 @@ bool Model::loadIoData()
 		modelMaterials.push_back(scene->mMaterials[i]);
 	}*/
 
-	// Initiate recursive processing of model
-	processNode(scene->mRootNode, scene);
+	// Collect meshes of all nodes
+	std::vector<aiMesh*> sceneMeshes;
+	collectMeshes(scene->mRootNode, scene, sceneMeshes);
+
+	// Results of each mesh, reduced in scene order once all meshes are processed
+	struct ProcessedMesh {
+		std::optional<MeshData> data;
+		Metrics metrics;
+		OptimizationStats stats;
+	};
+	std::vector<ProcessedMesh> processed(sceneMeshes.size());
+
+	// Process meshes in parallel, reporting progress as meshes finish
+	ResourceManager& resourceManager = ApplicationContext::resourceManager();
+	std::atomic<uint32_t> nProcessed = 0;
+	float nMeshes = static_cast<float>(sceneMeshes.size());
+	resourceManager.reportProgress(resourceName(), 0.0f);
+
+	ApplicationContext::jobSystem().parallelFor(sceneMeshes.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			ProcessedMesh& mesh = processed[i];
+			mesh.data.emplace(processMesh(sceneMeshes[i], mesh.metrics, mesh.stats));
+			resourceManager.reportProgress(resourceName(), (nProcessed.fetch_add(1) + 1) / nMeshes);
+		}
+		});
+
+	// Reduce mesh data, metrics and statistics
+	meshData.reserve(processed.size());
+	for (ProcessedMesh& mesh : processed) {
+		meshData.push_back(std::move(*mesh.data));
+		mergeMetrics(mesh.metrics);
+		optimizationStats.before += mesh.stats.before;
+		optimizationStats.after += mesh.stats.after;
+	}
 
 	// Finalize the metrics
 	finalizeMetrics();
 
+	// Report optimization results
+	if (optimizeMeshes) {
+		std::ostringstream report;
+		report << std::fixed << std::setprecision(2);
+		report << "Optimized '" << sourcePath.filename().string() << "'";
+		report << ", ACMR " << optimizationStats.before.acmr() << " -> " << optimizationStats.after.acmr();
+		report << ", ATVR " << optimizationStats.before.atvr() << " -> " << optimizationStats.after.atvr();
+		Console::out::info("Model", report.str());
+	}
+
+	// Cook model for upcoming loads
+	cookMeshData();
+
+	// Stage mesh data for upload
+	stageMeshData();
+
 	return true;
 }
 
 void Model::freeIoData()
 {
+	// Give up staging memory of meshes which weren't uploaded
+	StagingRing& ring = ApplicationContext::stagingRing();
+	for (MeshData& mesh : meshData)
+		ring.discard(mesh.staging);
+
 	meshData.clear();
 }
 
+void Model::stageMeshData()
+{
+	for (MeshData& mesh : meshData)
+		stageMesh(mesh, mesh.vertices.data(), mesh.indices.data());
+}
+
+// Packs the given vertices into the target memory
+static void writePackedVertices(const VertexFormat::Bounds& bounds, const Model::VertexData* vertices, uint32_t nVertices, VertexFormat::PackedVertex* target)
+{
+	for (uint32_t i = 0; i < nVertices; i++) {
+		const Model::VertexData& vertex = vertices[i];
+		target[i] = VertexFormat::pack(bounds, vertex.position, vertex.normal, vertex.uv, vertex.tangent, vertex.bitangent);
+	}
+}
+
+void Model::stageMesh(MeshData& mesh, const VertexData* vertices, const uint32_t* indices)
+{
+	// Quantize positions within the meshes bounds if vertices are packed
+	mesh.packed = packVertices;
+	if (mesh.packed)
+		mesh.bounds = VertexFormat::computeBounds(&vertices->position, mesh.nVertices, sizeof(VertexData));
+
+	size_t verticesSize = mesh.nVertices * mesh.vertexSize();
+	size_t indicesSize = mesh.nIndices * sizeof(uint32_t);
+
+	StagingRing& ring = ApplicationContext::stagingRing();
+	mesh.staging = ring.allocate(verticesSize + indicesSize);
+
+	// Ring is full, mesh will be uploaded directly from cpu side buffers
+	if (!mesh.staging.valid()) {
+		if (mesh.packed) {
+			mesh.packedVertices.resize(mesh.nVertices);
+			writePackedVertices(mesh.bounds, vertices, mesh.nVertices, mesh.packedVertices.data());
+			mesh.vertices = std::vector<VertexData>();
+		}
+		else if (mesh.vertices.data() != vertices) {
+			mesh.vertices.assign(vertices, vertices + mesh.nVertices);
+		}
+
+		if (mesh.indices.data() != indices)
+			mesh.indices.assign(indices, indices + mesh.nIndices);
+		return;
+	}
+
+	// Write mesh data to staging memory and free it
+	if (mesh.packed)
+		writePackedVertices(mesh.bounds, vertices, mesh.nVertices, reinterpret_cast<VertexFormat::PackedVertex*>(mesh.staging.data));
+	else
+		std::memcpy(mesh.staging.data, vertices, verticesSize);
+	std::memcpy(mesh.staging.data + verticesSize, indices, indicesSize);
+	mesh.vertices = std::vector<VertexData>();
+	mesh.indices = std::vector<uint32_t>();
+}
+
+// Reads the size and last write time of a models source to detect outdated cooked models
+static bool readSourceStamp(const FS::Path& sourcePath, uint64_t& size, int64_t& time)
+{
+	std::optional<FS::FileTime> writeTime = FS::getLastWriteTime(sourcePath);
+	if (!writeTime) return false;
+
+	size = FS::fileSize(sourcePath);
+	time = static_cast<int64_t>(writeTime->time_since_epoch().count());
+	return true;
+}
+
+// Rounds the given offset up to the cooked data alignment
+static uint64_t alignCooked(uint64_t offset)
+{
+	return (offset + CookedModel::ALIGNMENT - 1) / CookedModel::ALIGNMENT * CookedModel::ALIGNMENT;
+}
+
+FS::Path Model::cookedPath() const
+{
+	FS::Path path = sourcePath;
+	path += CookedModel::EXTENSION;
+	return path;
+}
+
+void Model::writeCookSettings(CookedModel::Header& header) const
+{
+	header.flags = 0;
+	if (optimizeMeshes) header.flags |= CookedModel::FLAG_OPTIMIZED;
+
+	header.nLodRatios = static_cast<uint32_t>(lodRatios.size());
+	for (size_t i = 0; i < lodRatios.size(); i++) header.lodRatios[i] = lodRatios[i];
+}
+
+bool Model::matchesCookSettings(const CookedModel::Header& header) const
+{
+	CookedModel::Header settings;
+	writeCookSettings(settings);
+
+	if (header.flags != settings.flags || header.nLodRatios != settings.nLodRatios) return false;
+	return std::equal(settings.lodRatios, settings.lodRatios + settings.nLodRatios, header.lodRatios);
+}
+
+bool Model::loadCookedData()
+{
+	// Map cooked file
+	MappedFile file;
+	if (!file.open(cookedPath())) return false;
+	if (file.size() < sizeof(CookedModel::Header)) return false;
+
+	// Validate header
+	CookedModel::Header header;
+	std::memcpy(&header, file.data(), sizeof(CookedModel::Header));
+	if (header.magic != CookedModel::MAGIC || header.version != CookedModel::VERSION || header.vertexStride != sizeof(VertexData))
+		return false;
+
+	// Cooked model must match the import settings
+	if (!matchesCookSettings(header)) return false;
+
+	// Cooked model must be up to date with its source
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	if (!readSourceStamp(sourcePath, sourceSize, sourceTime) || header.sourceSize != sourceSize || header.sourceTime != sourceTime)
+		return false;
+
+	// Read and validate mesh table
+	size_t tableEnd = sizeof(CookedModel::Header) + static_cast<size_t>(header.nMeshes) * sizeof(CookedModel::MeshEntry);
+	if (tableEnd > file.size()) return false;
+
+	std::vector<CookedModel::MeshEntry> entries(header.nMeshes);
+	std::memcpy(entries.data(), file.data() + sizeof(CookedModel::Header), entries.size() * sizeof(CookedModel::MeshEntry));
+	for (const CookedModel::MeshEntry& entry : entries) {
+		if (entry.vertexOffset + static_cast<uint64_t>(entry.nVertices) * sizeof(VertexData) > file.size()) return false;
+		if (entry.indexOffset + static_cast<uint64_t>(entry.nIndices) * sizeof(uint32_t) > file.size()) return false;
+		if (entry.nLods == 0 || entry.nLods > Mesh::MAX_LODS) return false;
+		for (uint32_t i = 0; i < entry.nLods; i++)
+			if (static_cast<uint64_t>(entry.lods[i].indexOffset) + entry.lods[i].nIndices > entry.nIndices) return false;
+	}
+
+	// Stage mesh data straight from the mapping, cooked data is aligned for reading it in place
+	meshData.reserve(entries.size());
+	for (const CookedModel::MeshEntry& entry : entries) {
+		MeshData mesh(std::vector<VertexData>(), std::vector<uint32_t>(), entry.materialIndex);
+		mesh.nVertices = entry.nVertices;
+		mesh.nIndices = entry.nIndices;
+		mesh.nLods = entry.nLods;
+		std::copy(entry.lods, entry.lods + entry.nLods, mesh.lods.begin());
+		mesh.volume = entry.volume;
+
+		const VertexData* vertices = reinterpret_cast<const VertexData*>(file.data() + entry.vertexOffset);
+		const uint32_t* indices = reinterpret_cast<const uint32_t*>(file.data() + entry.indexOffset);
+		stageMesh(mesh, vertices, indices);
+
+		meshData.push_back(std::move(mesh));
+	}
+
+	metrics = header.metrics;
+	optimizationStats = header.optimizationStats;
+
+	return true;
+}
+
+void Model::cookMeshData()
+{
+	// Prepare header
+	CookedModel::Header header;
+	header.nMeshes = static_cast<uint32_t>(meshData.size());
+	writeCookSettings(header);
+	header.metrics = metrics;
+	header.optimizationStats = optimizationStats;
+	if (!readSourceStamp(sourcePath, header.sourceSize, header.sourceTime)) return;
+
+	// Lay out mesh data behind mesh table
+	std::vector<CookedModel::MeshEntry> entries(meshData.size());
+	uint64_t offset = alignCooked(sizeof(CookedModel::Header) + entries.size() * sizeof(CookedModel::MeshEntry));
+	for (size_t i = 0; i < meshData.size(); i++) {
+		CookedModel::MeshEntry& entry = entries[i];
+		entry.nVertices = meshData[i].nVertices;
+		entry.nIndices = meshData[i].nIndices;
+		entry.materialIndex = meshData[i].materialIndex;
+		entry.nLods = meshData[i].nLods;
+		std::copy(meshData[i].lods.begin(), meshData[i].lods.begin() + entry.nLods, entry.lods);
+		entry.volume = meshData[i].volume;
+
+		entry.vertexOffset = offset;
+		offset = alignCooked(offset + entry.nVertices * sizeof(VertexData));
+		entry.indexOffset = offset;
+		offset = alignCooked(offset + entry.nIndices * sizeof(uint32_t));
+	}
+
+	// Write to a temporary file first so readers never map a partially written model
+	// Models sharing a source may cook concurrently, so each writer gets its own temporary file named by its resource id
+	FS::Path path = cookedPath();
+	FS::Path temporaryPath = path;
+	temporaryPath += "." + std::to_string(resourceId()) + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			Console::out::warning("Model", "Couldn't cook model '" + sourcePath.filename().string() + "'");
+			return;
+		}
+
+		// Pads the file up to the given offset
+		auto padTo = [&file](uint64_t target) {
+			static const char zeros[CookedModel::ALIGNMENT] = {};
+			uint64_t position = static_cast<uint64_t>(file.tellp());
+			if (target > position) file.write(zeros, static_cast<std::streamsize>(target - position));
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(CookedModel::MeshEntry));
+		for (size_t i = 0; i < meshData.size(); i++) {
+			padTo(entries[i].vertexOffset);
+			file.write(reinterpret_cast<const char*>(meshData[i].vertices.data()), meshData[i].vertices.size() * sizeof(VertexData));
+			padTo(entries[i].indexOffset);
+			file.write(reinterpret_cast<const char*>(meshData[i].indices.data()), meshData[i].indices.size() * sizeof(uint32_t));
+		}
+
+		if (!file) {
+			Console::out::warning("Model", "Couldn't cook model '" + sourcePath.filename().string() + "'");
+			file.close();
+			FS::remove(temporaryPath);
+			return;
+		}
+	}
+
+	// Don't leave temporary files of failed renames behind
+	if (!FS::rename(temporaryPath, path)) FS::remove(temporaryPath);
+}
+
 bool Model::uploadBuffers()
 {
 	// Don't dispatch model if there is no data
 	if (meshData.empty()) return false;
 
+	StagingRing& ring = ApplicationContext::stagingRing();
+	GeometryArena& arena = ApplicationContext::geometryArena();
+
 	// Dispatch each mesh
 	for (uint32_t i = 0; i < meshData.size(); i++) {
 		// Get mesh data metrics
-		uint32_t nVertices = meshData[i].vertices.size();
-		uint32_t nIndices = meshData[i].indices.size();
+		uint32_t nVertices = meshData[i].nVertices;
+		uint32_t nIndices = meshData[i].nIndices;
 		uint32_t materialIndex = meshData[i].materialIndex;
+		bool packed = meshData[i].packed;
+		size_t vertexSize = meshData[i].vertexSize();
+		size_t verticesSize = nVertices * vertexSize;
+		size_t indicesSize = nIndices * sizeof(uint32_t);
+
+		// Reserve vertex and index ranges within the geometry arena
+		GeometryArena::Allocation allocation = arena.allocate(packed ? GeometryArena::Format::PACKED : GeometryArena::Format::FLOAT, nVertices, nIndices);
+		if (!allocation.valid()) {
+			Console::out::warning("Model", "Couldn't reserve geometry memory for model '" + sourcePath.filename().string() + "'");
+			return false;
+		}
+
+		uint32_t vbo = arena.vbo(allocation);
+		uint32_t ebo = arena.ebo(allocation);
+		size_t vertexOffset = allocation.vertexOffset * vertexSize;
+		size_t indexOffset = allocation.indexOffset * sizeof(uint32_t);
+
+		StagingRing::Allocation& staging = meshData[i].staging;
+		if (staging.valid()) {
+			// Copy vertex and indice data from staging memory into the arenas buffers on the gpu
+			glBindBuffer(GL_COPY_READ_BUFFER, ring.backendId());
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, staging.offset, vertexOffset, verticesSize);
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, staging.offset + verticesSize, indexOffset, indicesSize);
 
-		// VAO, VBO and EBO backend ids
-		uint32_t vao, vbo, ebo;
-
-		// Generate VAO, VBO and EBO
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glGenBuffers(1, &ebo);
-
-		// Bind VAO
-		glBindVertexArray(vao);
-
-		// Bind VBO, allocate its memory send vertex data
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(VertexData), meshData[i].vertices.data(), GL_STATIC_DRAW);
-
-		// Bind EBO, allocate its memory and send indice data
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * sizeof(uint32_t), meshData[i].indices.data(), GL_STATIC_DRAW);
-
-		// Set attributes for VAO
-		// Vertex position attribute (location = 0)
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
-		// Normal attribute (location = 1)
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
-		// Texture coordinates attribute (location = 2)
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, uv));
-		// Tangent attribute (location = 3)
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tangent));
-		// Bitangent attribute (location = 3)
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, bitangent));
-
-		// Unbind VAO, ABO and EBO
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+			// Staging memory is reused once the copies finished
+			ring.submit(staging);
+		}
+		else {
+			// Write vertex and indice data into the arenas buffers directly
+			const void* vertices = packed ? static_cast<const void*>(meshData[i].packedVertices.data()) : static_cast<const void*>(meshData[i].vertices.data());
+			glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset, verticesSize, vertices);
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indicesSize, meshData[i].indices.data());
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
 		// Mesh is not existing yet, create empty mesh
 		if (meshes.find(i) == meshes.end()) {
 			meshes[i] = Mesh();
 		}
 
+		// Release geometry of a previous upload
+		arena.free(allocations[i]);
+		allocations[i] = allocation;
+
 		// Update mesh
-		meshes[i].setData(vao, vbo, ebo, nVertices, nIndices, materialIndex);
+		meshes[i].setData(arena.vao(allocation), vbo, ebo, nVertices, meshData[i].lods[0].nIndices, materialIndex);
+		meshes[i].setRange(allocation.vertexOffset, allocation.indexOffset);
+		meshes[i].setLods(meshData[i].lods.data(), meshData[i].nLods);
+		meshes[i].setBounds(meshData[i].volume);
+		meshes[i].setPacking(packed, meshData[i].bounds.origin, meshData[i].bounds.extent);
 	}
 
 	return true;
@@ -289,34 +765,49 @@ bool Model::uploadBuffers()
 
 void Model::deleteBuffers()
 {
-	for (auto& [id, mesh] : meshes) {
-		uint32_t vao = mesh.vao(), vbo = mesh.vbo(), ebo = mesh.ebo();
-		glDeleteVertexArrays(1, &vao);
-		glDeleteBuffers(1, &vbo);
-		glDeleteBuffers(1, &ebo);
-	}
+	// Release geometry memory of all meshes
+	GeometryArena& arena = ApplicationContext::geometryArena();
+	for (auto& [id, allocation] : allocations)
+		arena.free(allocation);
+
+	allocations.clear();
 	meshes.clear();
 }
 
-void Model::addMeshToMetrics(const std::vector<VertexData>& vertices, uint32_t nFaces)
+void Model::addMeshToMetrics(Metrics& target, const MeshBounds::Bounds& volume, uint32_t nVertices, uint32_t nFaces, uint32_t materialIndex)
 {
-	// Add number of vertices and faces to metrics
-	metrics.nVertices += vertices.size();
-	metrics.nFaces += nFaces;
+	// Add mesh, number of vertices and faces to metrics
+	target.nMeshes++;
+	target.nVertices += nVertices;
+	target.nFaces += nFaces;
 
-	// Loop through all mesh vertices
-	for (const VertexData& vertex : vertices)
-	{
-		// Update min and max point
-		metrics.minPoint = glm::min(metrics.minPoint, vertex.position);
-		metrics.maxPoint = glm::max(metrics.maxPoint, vertex.position);
+	// Update total materials metric if current material index as element count is the highest
+	target.nMaterials = std::max(target.nMaterials, materialIndex + 1);
 
-		// Add vertex position to centroid
-		metrics.centroid += vertex.position;
+	// Empty meshes have no bounds
+	if (nVertices == 0) return;
 
-		// Calculate furthest distance
-		metrics.furthest = glm::max(metrics.furthest, glm::distance(glm::vec3(0.0f), vertex.position));
-	}
+	// Update min and max point
+	target.minPoint = glm::min(target.minPoint, volume.minPoint);
+	target.maxPoint = glm::max(target.maxPoint, volume.maxPoint);
+
+	// Add vertex positions to centroid
+	target.centroid += volume.centroid * static_cast<float>(nVertices);
+
+	// Update furthest distance
+	target.furthest = glm::max(target.furthest, volume.furthest);
+}
+
+void Model::mergeMetrics(const Metrics& meshMetrics)
+{
+	metrics.nMeshes += meshMetrics.nMeshes;
+	metrics.nVertices += meshMetrics.nVertices;
+	metrics.nFaces += meshMetrics.nFaces;
+	metrics.nMaterials = std::max(metrics.nMaterials, meshMetrics.nMaterials);
+	metrics.minPoint = glm::min(metrics.minPoint, meshMetrics.minPoint);
+	metrics.maxPoint = glm::max(metrics.maxPoint, meshMetrics.maxPoint);
+	metrics.centroid += meshMetrics.centroid;
+	metrics.furthest = glm::max(metrics.furthest, meshMetrics.furthest);
 }
 
 void Model::finalizeMetrics()
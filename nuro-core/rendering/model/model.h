@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <cstdint>
 #include <glm/glm.hpp>
@@ -7,12 +8,18 @@
 
 #include <utils/fsutil.h>
 #include <memory/resource.h>
+#include <memory/staging_ring.h>
+#include <memory/geometry_arena.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/model/mesh_optimizer.h>
 
 class aiScene;
 class aiNode;
 class aiMesh;
 
+namespace CookedModel { struct Header; };
+
 class Model : public Resource
 {
 public:
@@ -49,6 +56,15 @@ public:
 		float furthest = 0.0f;
 	};
 
+	struct OptimizationStats
+	{
+		// Vertex cache statistics of all meshes as imported
+		MeshOptimizer::CacheStats before;
+
+		// Vertex cache statistics of all meshes after optimization
+		MeshOptimizer::CacheStats after;
+	};
+
 	struct VertexData
 	{
 		glm::vec3 position;
@@ -73,12 +89,47 @@ public:
 		std::vector<uint32_t> indices;
 		uint32_t materialIndex;
 
+		uint32_t nVertices;
+		uint32_t nIndices;
+
+		// Staging memory holding the vertices followed by the indices, vertices and indices are freed once staged
+		StagingRing::Allocation staging;
+
+		// If the vertices are uploaded in the packed vertex format and the bounds positions are quantized within
+		bool packed;
+		VertexFormat::Bounds bounds;
+
+		// Packed vertices, only kept if the mesh couldn't be staged
+		std::vector<VertexFormat::PackedVertex> packedVertices;
+
+		// Levels of detail as ranges of the indices
+		std::array<Mesh::Lod, Mesh::MAX_LODS> lods;
+		uint32_t nLods;
+
+		// Object space bounding volumes of the vertices
+		MeshBounds::Bounds volume;
+
 		explicit MeshData(std::vector<VertexData>&& vertices, std::vector<uint32_t>&& indices, uint32_t materialIndex) :
 			vertices(std::move(vertices)),
 			indices(std::move(indices)),
-			materialIndex(materialIndex)
+			materialIndex(materialIndex),
+			nVertices(this->vertices.size()),
+			nIndices(this->indices.size()),
+			staging(),
+			packed(false),
+			bounds(),
+			packedVertices(),
+			lods(),
+			nLods(1),
+			volume()
 		{
+			lods[0].nIndices = nIndices;
 		};
+
+		// Returns the size of a single vertex as uploaded
+		size_t vertexSize() const {
+			return packed ? sizeof(VertexFormat::PackedVertex) : sizeof(VertexData);
+		}
 	};
 
 	// Default pipe for creating model
@@ -91,6 +142,15 @@ public:
 	// Sets the path of the models source
 	void setSource(const FS::Path& sourcePath);
 
+	// Sets if the models meshes are uploaded in the packed vertex format (disabled by default)
+	void setVertexPacking(bool packVertices);
+
+	// Sets the triangle ratios of the levels of detail generated for each mesh on import, at most Mesh::MAX_LODS - 1 (0.5, 0.25 and 0.125 by default)
+	void setLodRatios(const std::vector<float>& lodRatios);
+
+	// Sets if the models meshes are deduplicated and reordered for vertex cache, overdraw and vertex fetch efficiency on import (enabled by default)
+	void setMeshOptimization(bool optimizeMeshes);
+
 	// Returns models mesh at given index or creates an empty mesh at that index
 	const Mesh* queryMesh(uint32_t index);
 
@@ -100,6 +160,12 @@ public:
 	// Returns models metrics
 	Metrics getMetrics() const;
 
+	// Returns the vertex cache statistics before and after the models meshes were optimized
+	OptimizationStats getOptimizationStats() const;
+
+	// Returns the memory held by the model
+	ResourceFootprint footprint() const override;
+
 public:
 	// Creates a static mesh with the given vertices and indices
 	static Mesh* createStaticMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices);
@@ -109,14 +175,44 @@ private:
 	// MODEL CREATION
 	//
 
-	void processNode(aiNode* node, const aiScene* scene);
-	MeshData processMesh(aiMesh* mesh, const aiScene* scene);
+	// Collects the meshes of a node and its children in scene order
+	void collectMeshes(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes) const;
+
+	// Converts, optimizes and simplifies a mesh, writing its own metrics and statistics so meshes can be processed in parallel
+	MeshData processMesh(aiMesh* mesh, Metrics& meshMetrics, OptimizationStats& meshStats) const;
+
+	// Deduplicates and reorders the given vertices and indices, adding their vertex cache statistics
+	void optimizeMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, OptimizationStats& stats) const;
+
+	// Appends simplified levels of detail to the meshes indices
+	void generateLods(MeshData& mesh) const;
 
 	bool loadIoData();
 	void freeIoData();
 	bool uploadBuffers();
 	void deleteBuffers();
 
+	// Writes the vertices and indices of all meshes into the staging ring
+	void stageMeshData();
+
+	// Writes the given vertices and indices of a mesh into the staging ring, packing the vertices if enabled
+	void stageMesh(MeshData& mesh, const VertexData* vertices, const uint32_t* indices);
+
+	// Returns the path of the models cooked file
+	FS::Path cookedPath() const;
+
+	// Writes the models import settings to a cooked model header
+	void writeCookSettings(CookedModel::Header& header) const;
+
+	// Returns true if the cooked model header was cooked with the models import settings
+	bool matchesCookSettings(const CookedModel::Header& header) const;
+
+	// Loads mesh data and metrics from the models cooked file, returns false if there is no cooked file up to date with the source
+	bool loadCookedData();
+
+	// Writes the imported mesh data and metrics to the models cooked file for upcoming loads
+	void cookMeshData();
+
 	//
 	// MODEL DATA
 	//
@@ -124,12 +220,24 @@ private:
 	// Path of models source
 	FS::Path sourcePath;
 
+	// If meshes are uploaded in the packed vertex format
+	bool packVertices;
+
+	// If meshes are optimized on import
+	bool optimizeMeshes;
+
+	// Triangle ratios of the generated levels of detail
+	std::vector<float> lodRatios;
+
 	// Intermediate temporary representation of mesh data
 	std::vector<MeshData> meshData;
 
 	// Final dispatched meshes
 	std::unordered_map<uint32_t, Mesh> meshes;
 
+	// Geometry arena memory of the dispatched meshes
+	std::unordered_map<uint32_t, GeometryArena::Allocation> allocations;
+
 	//
 	// MODEL METRICS
 	//
@@ -137,8 +245,14 @@ private:
 	// Models metrics
 	Metrics metrics;
 
-	// Adds a mesh to the metrics using its vertices
-	void addMeshToMetrics(const std::vector<VertexData>& vertices, uint32_t nFaces);
+	// Vertex cache statistics of the import time optimization
+	OptimizationStats optimizationStats;
+
+	// Adds a mesh to the given metrics using its bounding volumes
+	static void addMeshToMetrics(Metrics& target, const MeshBounds::Bounds& volume, uint32_t nVertices, uint32_t nFaces, uint32_t materialIndex);
+
+	// Merges the metrics of a mesh into the models metrics
+	void mergeMetrics(const Metrics& meshMetrics);
 	
 	// Finalizes the metrics after all meshes have been added
 	void finalizeMetrics();
@@ -0,0 +1,115 @@
+#include "vertex_format.h"
+
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
+
+#include <rendering/model/mesh.h>
+#include <rendering/shader/shader.h>
+
+namespace VertexFormat {
+
+	// Encodes a unit vector into octahedral coordinates in [-1, 1]
+	static glm::vec2 _octEncode(glm::vec3 n)
+	{
+		n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z) + 1e-20f;
+		glm::vec2 p(n.x, n.y);
+		if (n.z < 0.0f) {
+			glm::vec2 sign(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+			p = (glm::vec2(1.0f) - glm::abs(glm::vec2(p.y, p.x))) * sign;
+		}
+		return p;
+	}
+
+	// Converts a value in [-1, 1] to a signed normalized 16 bit integer
+	static int16_t _snorm16(float value)
+	{
+		return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	// Converts a value in [0, 1] to an unsigned normalized 16 bit integer
+	static uint16_t _unorm16(float value)
+	{
+		return static_cast<uint16_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+	}
+
+	Bounds computeBounds(const void* positions, size_t count, size_t stride)
+	{
+		if (count == 0) return Bounds();
+
+		glm::vec3 minPoint(FLT_MAX);
+		glm::vec3 maxPoint(-FLT_MAX);
+		const uint8_t* cursor = static_cast<const uint8_t*>(positions);
+		for (size_t i = 0; i < count; i++, cursor += stride) {
+			glm::vec3 position;
+			std::memcpy(&position, cursor, sizeof(glm::vec3));
+			minPoint = glm::min(minPoint, position);
+			maxPoint = glm::max(maxPoint, position);
+		}
+
+		// Flat axes still need a valid extent
+		Bounds bounds;
+		bounds.origin = minPoint;
+		bounds.extent = glm::max(maxPoint - minPoint, glm::vec3(1e-6f));
+		return bounds;
+	}
+
+	PackedVertex pack(const Bounds& bounds, const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& tangent, const glm::vec3& bitangent)
+	{
+		PackedVertex vertex;
+
+		// Quantize position within bounds, storing the bitangent handedness in w
+		glm::vec3 normalized = (position - bounds.origin) / bounds.extent;
+		float handedness = glm::dot(glm::cross(normal, tangent), bitangent);
+		vertex.position[0] = _unorm16(normalized.x);
+		vertex.position[1] = _unorm16(normalized.y);
+		vertex.position[2] = _unorm16(normalized.z);
+		vertex.position[3] = handedness < 0.0f ? 0 : 65535;
+
+		// Octahedral normal and tangent
+		glm::vec2 encodedNormal = _octEncode(normal);
+		vertex.normal[0] = _snorm16(encodedNormal.x);
+		vertex.normal[1] = _snorm16(encodedNormal.y);
+
+		glm::vec2 encodedTangent = _octEncode(tangent);
+		vertex.tangent[0] = _snorm16(encodedTangent.x);
+		vertex.tangent[1] = _snorm16(encodedTangent.y);
+
+		// Half float texture coordinates
+		vertex.uv[0] = glm::packHalf1x16(uv.x);
+		vertex.uv[1] = glm::packHalf1x16(uv.y);
+
+		return vertex;
+	}
+
+	void setupPackedAttributes()
+	{
+		// Position and bitangent sign attribute (location = 0)
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+		// Octahedral normal attribute (location = 1)
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+		// Texture coordinates attribute (location = 2)
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, uv));
+		// Octahedral tangent attribute (location = 3)
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, tangent));
+		// Bitangent is reconstructed from normal, tangent and sign (location = 4)
+		glDisableVertexAttribArray(4);
+	}
+
+	void setDecodeUniforms(Shader& shader, const Mesh& mesh)
+	{
+		shader.setBool(UniformId<"packedVertices">, mesh.packed());
+		if (!mesh.packed()) return;
+
+		shader.setVec3(UniformId<"positionOrigin">, mesh.positionOrigin());
+		shader.setVec3(UniformId<"positionExtent">, mesh.positionExtent());
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Mesh;
+class Shader;
+
+namespace VertexFormat
+{
+	// Compact vertex layout decoded by the vertex shaders (20 instead of 56 bytes)
+	struct PackedVertex
+	{
+		uint16_t position[4]; // Position normalized within the meshes bounds, w holds the bitangent sign
+		int16_t normal[2]; // Octahedral encoded normal
+		int16_t tangent[2]; // Octahedral encoded tangent
+		uint16_t uv[2]; // Half float texture coordinates
+	};
+
+	static_assert(sizeof(PackedVertex) == 20, "Packed vertex layout must stay 20 bytes");
+
+	// Bounds positions are quantized within
+	struct Bounds
+	{
+		glm::vec3 origin = glm::vec3(0.0f);
+		glm::vec3 extent = glm::vec3(1.0f);
+	};
+
+	// Returns the quantization bounds of the given positions, reading every stride bytes
+	Bounds computeBounds(const void* positions, size_t count, size_t stride);
+
+	// Packs a vertex into the compact layout, the bitangent only contributes its handedness
+	PackedVertex pack(const Bounds& bounds, const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const glm::vec3& tangent, const glm::vec3& bitangent);
+
+	// Sets the vertex attributes of the compact layout for the currently bound vertex array and buffer
+	void setupPackedAttributes();
+
+	// Sets the uniforms the vertex shaders need to decode the vertices of the given mesh
+	void setDecodeUniforms(Shader& shader, const Mesh& mesh);
+};
\ No newline at end of file
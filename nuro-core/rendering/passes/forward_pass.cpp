@@ -2,8 +2,12 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
+#include <transform/transform.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/model/lod_selection.h>
 #include <memory/resource_manager.h>
 #include <rendering/skybox/skybox.h>
 #include <diagnostics/diagnostics.h>
@@ -12,6 +16,7 @@
 
 ForwardPass::ForwardPass(const Viewport& viewport) : drawSkybox(false),
 drawGizmos(false),
+indirectDraws(false),
 viewport(viewport),
 skybox(nullptr),
 gizmos(nullptr),
@@ -21,7 +26,9 @@ outputColor(0),
 outputDepth(0),
 multisampledFbo(0),
 multisampledRbo(0),
-multisampledColorBuffer(0)
+multisampledColorBuffer(0),
+indirectBatch(),
+instanceBatch()
 {
 }
 
@@ -29,11 +36,11 @@ void ForwardPass::create(const uint32_t msaaSamples)
 {
 	// Generate forward pass framebuffer
 	glGenFramebuffers(1, &outputFbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, outputFbo);
 
 	// Generate color output texture
 	glGenTextures(1, &outputColor);
-	glBindTexture(GL_TEXTURE_2D, outputColor);
+	GLState::bindTexture(GL_TEXTURE_2D, outputColor);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -50,11 +57,11 @@ void ForwardPass::create(const uint32_t msaaSamples)
 
 	// Generate multisampled framebuffer
 	glGenFramebuffers(1, &multisampledFbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
 
 	// Generate multisampled color buffer texture
 	glGenTextures(1, &multisampledColorBuffer);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisampledColorBuffer);
+	GLState::bindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisampledColorBuffer);
 	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, msaaSamples, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), GL_TRUE);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -73,24 +80,28 @@ void ForwardPass::create(const uint32_t msaaSamples)
 		Console::out::warning("Forward Pass", "Issue while generating multisampled framebuffer: " + std::to_string(fboStatus));
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Create buffers of the indirect and instanced paths
+	indirectBatch.create();
+	instanceBatch.create();
 }
 
 void ForwardPass::destroy() {
 	// Delete color output texture
-	glDeleteTextures(1, &outputColor);
+	GLState::deleteTextures(1, &outputColor);
 	outputColor = 0;
 
 	// Delete depth output texture
-	glDeleteTextures(1, &outputDepth);
+	GLState::deleteTextures(1, &outputDepth);
 	outputDepth = 0;
 
 	// Delete output framebuffer
-	glDeleteFramebuffers(1, &outputFbo);
+	GLState::deleteFramebuffers(1, &outputFbo);
 	outputFbo = 0;
 
 	// Delete multisampled color buffer texture
-	glDeleteTextures(1, &multisampledColorBuffer);
+	GLState::deleteTextures(1, &multisampledColorBuffer);
 	multisampledColorBuffer = 0;
 
 	// Delete multisampled renderbuffer
@@ -98,14 +109,18 @@ void ForwardPass::destroy() {
 	multisampledRbo = 0;
 
 	// Delete multisampled framebuffer
-	glDeleteFramebuffers(1, &multisampledFbo);
+	GLState::deleteFramebuffers(1, &multisampledFbo);
 	multisampledFbo = 0;
+
+	// Delete buffers of the indirect and instanced paths
+	indirectBatch.destroy();
+	instanceBatch.destroy();
 }
 
-uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection)
+uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection, ViewMatrices& viewMatrices)
 {
 	// Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
 
 	// Clear framebuffer
 	glClearColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
@@ -115,12 +130,12 @@ uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection,
 	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
 
 	// Set culling to back face
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
+	GLState::enable(GL_CULL_FACE);
+	GLState::cullFace(GL_BACK);
 
 	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::depthFunc(GL_LESS);
 
 	// INJECTED PRE PASS START
 	/*
@@ -135,25 +150,29 @@ uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection,
 	// Re-enable color writing after pre pass
 	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	// GL_EQUAL depth testing for upcoming forward pass to use pre pass depth data
-	glDepthFunc(GL_EQUAL);
+	GLState::depthFunc(GL_EQUAL);
 	*/
 	// INJECTED PRE PASS END
 
+	// Sort render queue front to back for current view
+	ECS::main().sortRenderQueue(view);
+
 	// Render each entity
-	renderMeshes();
+	if (indirectDraws) renderMeshesIndirect(viewMatrices);
+	else renderMeshes(viewMatrices);
 
 	// Disable culling before rendering skybox
-	glDisable(GL_CULL_FACE);
+	GLState::disable(GL_CULL_FACE);
 
 	// Render skybox to bound forward pass frame
 	if (drawSkybox && skybox) skybox->render(view, projection);
 
 	// Render gizmos, shapes only
-	if (drawGizmos && gizmos) gizmos->renderShapes(viewProjection);
+	if (drawGizmos && gizmos) gizmos->renderShapes(viewMatrices.getViewProjection());
 
 	// Bilt multisampled framebuffer to post processing framebuffer
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, multisampledFbo);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
+	GLState::bindFramebuffer(GL_READ_FRAMEBUFFER, multisampledFbo);
+	GLState::bindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
 	glBlitFramebuffer(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, 0, viewport.getWidth_gl(), viewport.getHeight_gl(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
 	return outputColor;
@@ -179,9 +198,9 @@ void ForwardPass::setClearColor(glm::vec4 _clearColor)
 	clearColor = _clearColor;
 }
 
-void ForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer)
+void ForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer, ViewMatrices& viewMatrices, uint32_t& currentVao)
 {
-	// Transform components model and mvp must have been calculated beforehand
+	// Transform components world matrices must have been evaluated beforehand
 
 	// Renderer must be enabled
 	if (!renderer.enabled) return;
@@ -189,40 +208,192 @@ void ForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponen
 	// Make sure mesh is available
 	if (!renderer.mesh) return;
 
+	// Skip meshes outside the view frustum
+	const glm::mat4& mvp = viewMatrices.mvp(transform);
+	if (!MeshBounds::intersectsFrustum(renderer.mesh->bounds(), mvp)) return;
+
+	// Select level of detail
+	uint32_t& lod = viewMatrices.lod(transform, ViewMatrices::LodPass::FORWARD);
+	lod = LodSelection::select(*renderer.mesh, mvp, lod);
+
 	// Set shader uniforms
 	ResourceRef<Shader> shader = renderer.material->getShader();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
-
-	// Bind mesh
-	glBindVertexArray(renderer.mesh->vao());
+	shader->setMatrix4(UniformId<"mvpMatrix">, mvp);
+	shader->setMatrix4(UniformId<"modelMatrix">, Transform::model(transform));
+	shader->setMatrix3(UniformId<"normalMatrix">, Transform::normal(transform));
+	VertexFormat::setDecodeUniforms(*shader, *renderer.mesh);
+
+	// Bind mesh, meshes of the same geometry arena page share their vertex array
+	if (renderer.mesh->vao() != currentVao) {
+		GLState::bindVertexArray(renderer.mesh->vao());
+		currentVao = renderer.mesh->vao();
+	}
 
 	// Render mesh
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	LodSelection::draw(*renderer.mesh, lod);
+
+	Diagnostics::addCurrentDrawCalls(1);
+	Diagnostics::addCurrentPolygons(renderer.mesh->lod(lod).nIndices / 3);
+	Diagnostics::addNEntitiesCPU(1);
 }
 
-void ForwardPass::renderMeshes()
+void ForwardPass::renderMeshes(ViewMatrices& viewMatrices)
 {
 	uint32_t currentShaderId = 0;
 	uint32_t currentMaterialId = 0;
+	uint32_t currentVao = 0;
+
+	// Collect instances of each entity, entities with shaders lacking the instanced variant are rendered directly
+	instanceBatch.clear();
+	for (auto [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+
+		ResourceRef<Shader> shader = renderer.material->getShader();
+		if (!shader->hasVariant(Shader::Variant::INSTANCED)) {
+			uint32_t shaderId = renderer.material->getShaderId();
+			if (shaderId != currentShaderId) {
+				shader->bind();
+				currentShaderId = shaderId;
+			}
+
+			uint32_t materialId = renderer.material->getId();
+			if (materialId != currentMaterialId) {
+				renderer.material->bind();
+				currentMaterialId = materialId;
+			}
+
+			renderMesh(transform, renderer, viewMatrices, currentVao);
+			continue;
+		}
 
-	// Render each entity
-	for (auto& [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+		// Renderer must be enabled and have a mesh
+		if (!renderer.enabled || !renderer.mesh) continue;
+
+		// Skip meshes outside the view frustum
+		const glm::mat4& mvp = viewMatrices.mvp(transform);
+		if (!MeshBounds::intersectsFrustum(renderer.mesh->bounds(), mvp)) continue;
+
+		// Select level of detail
+		uint32_t& lod = viewMatrices.lod(transform, ViewMatrices::LodPass::FORWARD);
+		lod = LodSelection::select(*renderer.mesh, mvp, lod);
 
-		uint32_t shaderId = renderer.material->getShaderId();
+		instanceBatch.add(renderer.material, *renderer.mesh, lod, Transform::model(transform), Transform::normal(transform));
+
+		Diagnostics::addCurrentPolygons(renderer.mesh->lod(lod).nIndices / 3);
+		Diagnostics::addNEntitiesGPU(1);
+	}
+
+	// Upload instance data
+	instanceBatch.upload();
+
+	// Render each run of instances with a single draw
+	currentShaderId = 0;
+	currentMaterialId = 0;
+	for (const InstanceBatch::Run& run : instanceBatch.getRuns()) {
+
+		ResourceRef<Shader> shader = run.material->getShader();
+		uint32_t shaderId = run.material->getShaderId();
 		if (shaderId != currentShaderId) {
-			renderer.material->getShader()->bind();
+			shader->bind(Shader::Variant::INSTANCED);
+			shader->setMatrix4(UniformId<"viewProjectionMatrix">, viewMatrices.getViewProjection());
 			currentShaderId = shaderId;
+			currentMaterialId = 0;
 		}
 
-		uint32_t materialId = renderer.material->getId();
+		uint32_t materialId = run.material->getId();
 		if (materialId != currentMaterialId) {
-			renderer.material->bind();
+			run.material->bind();
 			currentMaterialId = materialId;
 		}
 
-		renderMesh(transform, renderer);
+		if (run.mesh->vao() != currentVao) {
+			GLState::bindVertexArray(run.mesh->vao());
+			currentVao = run.mesh->vao();
+		}
 
+		VertexFormat::setDecodeUniforms(*shader, *run.mesh);
+		instanceBatch.draw(run);
+
+		Diagnostics::addCurrentDrawCalls(1);
 	}
+}
+
+void ForwardPass::renderMeshesIndirect(ViewMatrices& viewMatrices)
+{
+	uint32_t currentShaderId = 0;
+	uint32_t currentMaterialId = 0;
+	uint32_t currentVao = 0;
+
+	// Collect draws of each entity, entities with shaders lacking the indirect variant are rendered directly
+	indirectBatch.clear();
+	for (auto [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+
+		ResourceRef<Shader> shader = renderer.material->getShader();
+		if (!shader->hasVariant(Shader::Variant::INDIRECT)) {
+			uint32_t shaderId = renderer.material->getShaderId();
+			if (shaderId != currentShaderId) {
+				shader->bind();
+				currentShaderId = shaderId;
+			}
+
+			uint32_t materialId = renderer.material->getId();
+			if (materialId != currentMaterialId) {
+				renderer.material->bind();
+				currentMaterialId = materialId;
+			}
+
+			renderMesh(transform, renderer, viewMatrices, currentVao);
+			continue;
+		}
+
+		// Renderer must be enabled and have a mesh
+		if (!renderer.enabled || !renderer.mesh) continue;
+
+		// Skip meshes outside the view frustum
+		const glm::mat4& mvp = viewMatrices.mvp(transform);
+		if (!MeshBounds::intersectsFrustum(renderer.mesh->bounds(), mvp)) continue;
+
+		// Select level of detail
+		uint32_t& lod = viewMatrices.lod(transform, ViewMatrices::LodPass::FORWARD);
+		lod = LodSelection::select(*renderer.mesh, mvp, lod);
+
+		indirectBatch.add(renderer.material, *renderer.mesh, lod, Transform::model(transform), Transform::normal(transform));
+
+		Diagnostics::addCurrentPolygons(renderer.mesh->lod(lod).nIndices / 3);
+		Diagnostics::addNEntitiesGPU(1);
+	}
+
+	// Upload draw data and commands
+	indirectBatch.upload();
+
+	// Submit each bucket with a single draw
+	currentShaderId = 0;
+	currentMaterialId = 0;
+	for (const IndirectBatch::Bucket& bucket : indirectBatch.getBuckets()) {
+
+		if (bucket.shaderId != currentShaderId) {
+			ResourceRef<Shader> shader = bucket.material->getShader();
+			shader->bind(Shader::Variant::INDIRECT);
+			shader->setMatrix4(UniformId<"viewProjectionMatrix">, viewMatrices.getViewProjection());
+			currentShaderId = bucket.shaderId;
+			currentMaterialId = 0;
+		}
+
+		// Materials of a shared bucket only differ in their material table entries, binding any of them binds the shared state
+		uint32_t materialId = bucket.material->getId();
+		if (materialId != currentMaterialId) {
+			bucket.material->bind();
+			currentMaterialId = materialId;
+		}
+
+		if (bucket.vao != currentVao) {
+			GLState::bindVertexArray(bucket.vao);
+			currentVao = bucket.vao;
+		}
+
+		indirectBatch.draw(bucket);
+
+		Diagnostics::addCurrentDrawCalls(1);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 }
\ No newline at end of file
@@ -6,7 +6,10 @@
 
 #include <viewport/viewport.h>
 #include <ecs/ecs_collection.h>
+#include <transform/view_matrices.h>
 #include <rendering/gizmos/imgizmo.h>
+#include <rendering/passes/indirect_batch.h>
+#include <rendering/passes/instance_batch.h>
 
 class Skybox;
 
@@ -19,7 +22,7 @@ public:
 	void destroy(); // Destroys forward pass
 
 	// Forward passes all entity render targets and returns color output
-	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection);
+	uint32_t render(const glm::mat4& view, const glm::mat4& projection, ViewMatrices& viewMatrices);
 
 	uint32_t getDepthOutput(); // Returns depth output
 
@@ -30,6 +33,9 @@ public:
 	bool drawGizmos;
 
 	void setClearColor(glm::vec4 clearColor); // Clear color for forward pass
+
+	// Submits meshes in multi draw indirect buckets per material instead of one draw per mesh
+	bool indirectDraws;
 private:
 	const Viewport& viewport; // Viewport forward pass instance is linked to
 
@@ -46,6 +52,10 @@ private:
 	uint32_t multisampledRbo;		 // Anti-aliasing renderbuffer
 	uint32_t multisampledColorBuffer; // Anti-aliasing color buffer texture
 
-	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer);
-	void renderMeshes();
+	IndirectBatch indirectBatch; // Draw data and commands of the indirect path
+	InstanceBatch instanceBatch; // Per instance transforms of the instanced path
+
+	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer, ViewMatrices& viewMatrices, uint32_t& currentVao);
+	void renderMeshes(ViewMatrices& viewMatrices);
+	void renderMeshesIndirect(ViewMatrices& viewMatrices);
 };
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "indirect_batch.h"
+
+#include <glad/glad.h>
+
+#include <rendering/model/mesh.h>
+#include <rendering/material/imaterial.h>
+
+IndirectBatch::IndirectBatch() : drawData(),
+commands(),
+buckets(),
+bucketCommands(),
+sharedBuckets(),
+lookupShaderId(0),
+drawDataBuffer(0),
+drawDataCapacity(0),
+commandBuffer(0),
+commandCapacity(0)
+{
+}
+
+void IndirectBatch::create()
+{
+	glGenBuffers(1, &drawDataBuffer);
+	glGenBuffers(1, &commandBuffer);
+}
+
+void IndirectBatch::destroy()
+{
+	glDeleteBuffers(1, &drawDataBuffer);
+	drawDataBuffer = 0;
+	drawDataCapacity = 0;
+
+	glDeleteBuffers(1, &commandBuffer);
+	commandBuffer = 0;
+	commandCapacity = 0;
+
+	clear();
+}
+
+void IndirectBatch::clear()
+{
+	drawData.clear();
+	commands.clear();
+	buckets.clear();
+	sharedBuckets.clear();
+	lookupShaderId = 0;
+}
+
+void IndirectBatch::add(const IMaterial* material, const Mesh& mesh, uint32_t lod, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix)
+{
+	// Draws of materials with a material table entry only need to share shader and vertex array
+	uint32_t materialSlot = material->getMaterialSlot();
+	bool shared = materialSlot != IMaterial::NO_MATERIAL_SLOT;
+
+	// Draws are ordered by shader, shared buckets of the previous shader can't receive further draws
+	uint32_t shaderId = material->getShaderId();
+	if (shaderId != lookupShaderId) {
+		sharedBuckets.clear();
+		lookupShaderId = shaderId;
+	}
+
+	// Find the bucket of the draw, shared draws join the bucket of their vertex array and others the last bucket if it matches
+	uint32_t bucketIndex = static_cast<uint32_t>(buckets.size());
+	if (shared) {
+		auto it = sharedBuckets.find(mesh.vao());
+		if (it != sharedBuckets.end()) bucketIndex = it->second;
+		else sharedBuckets.emplace(mesh.vao(), bucketIndex);
+	}
+	else if (!buckets.empty() && !buckets.back().shared && buckets.back().material == material && buckets.back().vao == mesh.vao()) {
+		bucketIndex = bucketIndex - 1;
+	}
+
+	// Start a new bucket
+	if (bucketIndex == buckets.size()) {
+		Bucket bucket;
+		bucket.material = material;
+		bucket.shaderId = shaderId;
+		bucket.vao = mesh.vao();
+		bucket.shared = shared;
+		buckets.push_back(bucket);
+
+		// Keep command lists of former frames to reuse their memory
+		if (bucketCommands.size() < buckets.size()) bucketCommands.emplace_back();
+		bucketCommands[bucketIndex].clear();
+	}
+
+	// Add draw data
+	DrawData data;
+	data.modelMatrix = modelMatrix;
+	data.normalMatrix = glm::mat4(normalMatrix);
+	data.positionOrigin = glm::vec4(mesh.positionOrigin(), 0.0f);
+	data.positionExtent = glm::vec4(mesh.positionExtent(), 0.0f);
+	data.info = glm::uvec4(shared ? materialSlot : 0, mesh.packed() ? 1 : 0, 0, 0);
+
+	// Add command drawing the level of detail with the draw data
+	const Mesh::Lod& range = mesh.lod(lod);
+	Command command;
+	command.count = range.nIndices;
+	command.instanceCount = 1;
+	command.firstIndex = mesh.firstIndex() + range.indexOffset;
+	command.baseVertex = static_cast<int32_t>(mesh.baseVertex());
+	command.baseInstance = static_cast<uint32_t>(drawData.size());
+
+	drawData.push_back(data);
+	bucketCommands[bucketIndex].push_back(command);
+}
+
+void IndirectBatch::upload()
+{
+	// Concatenate the commands of each bucket
+	commands.clear();
+	for (size_t i = 0; i < buckets.size(); i++) {
+		buckets[i].firstCommand = static_cast<uint32_t>(commands.size());
+		buckets[i].nCommands = static_cast<uint32_t>(bucketCommands[i].size());
+		commands.insert(commands.end(), bucketCommands[i].begin(), bucketCommands[i].end());
+	}
+
+	if (commands.empty()) return;
+
+	// Upload draw data, reallocating the buffer if it's too small and orphaning it otherwise
+	size_t drawDataSize = drawData.size() * sizeof(DrawData);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataBuffer);
+	if (drawDataSize > drawDataCapacity) drawDataCapacity = drawDataSize * 2;
+	glBufferData(GL_SHADER_STORAGE_BUFFER, drawDataCapacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, drawDataSize, drawData.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, drawDataBuffer);
+
+	// Upload commands the same way, the indirect buffer stays bound for the draws
+	size_t commandSize = commands.size() * sizeof(Command);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	if (commandSize > commandCapacity) commandCapacity = commandSize * 2;
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, commandCapacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandSize, commands.data());
+}
+
+const std::vector<IndirectBatch::Bucket>& IndirectBatch::getBuckets() const
+{
+	return buckets;
+}
+
+void IndirectBatch::draw(const Bucket& bucket) const
+{
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(bucket.firstCommand) * sizeof(Command)), bucket.nCommands, 0);
+}
\ No newline at end of file
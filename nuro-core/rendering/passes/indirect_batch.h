@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Mesh;
+class IMaterial;
+
+// Per draw data and indirect draw commands of a frame, submitted in buckets with one multi draw each
+class IndirectBatch
+{
+public:
+	// Per draw data as read by the indirect shader variants (std430)
+	struct DrawData
+	{
+		glm::mat4 modelMatrix;
+		glm::mat4 normalMatrix; // Normal matrix in the upper 3x3
+		glm::vec4 positionOrigin;
+		glm::vec4 positionExtent;
+		glm::uvec4 info; // x: material table slot, y: packed vertices
+	};
+
+	// Indirect draw command as read by glMultiDrawElementsIndirect
+	struct Command
+	{
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t baseInstance; // Index of the draws first draw data
+	};
+
+	// Commands sharing a shader and vertex array, and a material unless all of them index the material table
+	struct Bucket
+	{
+		const IMaterial* material = nullptr; // Material of the first draw
+		uint32_t shaderId = 0;
+		uint32_t vao = 0;
+		bool shared = false; // Draws select their material table entry themselves
+		uint32_t firstCommand = 0;
+		uint32_t nCommands = 0;
+	};
+
+	// Storage buffer binding of the draw data
+	static constexpr uint32_t DRAW_DATA_BINDING = 0;
+
+	IndirectBatch();
+
+	void create();
+	void destroy();
+
+	// Clears all draws of the last frame
+	void clear();
+
+	// Adds a draw of the given level of detail; draws with a material table entry join the bucket of their shader and vertex array, others start a new bucket unless material and vertex array match the previous draw
+	void add(const IMaterial* material, const Mesh& mesh, uint32_t lod, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix);
+
+	// Concatenates the commands of all buckets, uploads draw data and commands and binds their buffers
+	void upload();
+
+	// Returns the buckets of the current draws
+	const std::vector<Bucket>& getBuckets() const;
+
+	// Submits the commands of a bucket, its vertex array and material must be bound; binding the first material suffices for shared buckets
+	void draw(const Bucket& bucket) const;
+
+private:
+	std::vector<DrawData> drawData;
+	std::vector<Command> commands;
+	std::vector<Bucket> buckets;
+
+	// Commands of each bucket until they are concatenated on upload
+	std::vector<std::vector<Command>> bucketCommands;
+
+	// Shared buckets of the current shader by vertex array
+	std::unordered_map<uint32_t, uint32_t> sharedBuckets;
+	uint32_t lookupShaderId;
+
+	// Storage buffer of the draw data
+	uint32_t drawDataBuffer;
+	size_t drawDataCapacity;
+
+	// Indirect buffer of the commands
+	uint32_t commandBuffer;
+	size_t commandCapacity;
+};
\ No newline at end of file
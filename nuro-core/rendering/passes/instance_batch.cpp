@@ -0,0 +1,106 @@
+#include "instance_batch.h"
+
+#include <cstddef>
+#include <glad/glad.h>
+
+#include <rendering/model/mesh.h>
+#include <rendering/model/lod_selection.h>
+
+InstanceBatch::InstanceBatch() : instances(),
+runs(),
+instanceBuffer(0),
+instanceCapacity(0)
+{
+}
+
+void InstanceBatch::create()
+{
+	glGenBuffers(1, &instanceBuffer);
+}
+
+void InstanceBatch::destroy()
+{
+	glDeleteBuffers(1, &instanceBuffer);
+	instanceBuffer = 0;
+	instanceCapacity = 0;
+
+	clear();
+}
+
+void InstanceBatch::clear()
+{
+	instances.clear();
+	runs.clear();
+}
+
+void InstanceBatch::add(const IMaterial* material, const Mesh& mesh, uint32_t lod, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix)
+{
+	// Start a new run if the instance can't be part of the last one
+	if (runs.empty() || runs.back().mesh != &mesh || runs.back().lod != lod || runs.back().material != material) {
+		Run run;
+		run.material = material;
+		run.mesh = &mesh;
+		run.lod = lod;
+		run.firstInstance = static_cast<uint32_t>(instances.size());
+		runs.push_back(run);
+	}
+	runs.back().nInstances++;
+
+	instances.push_back({ modelMatrix, normalMatrix });
+}
+
+void InstanceBatch::upload()
+{
+	if (instances.empty()) return;
+
+	// Upload instance data, reallocating the buffer if it's too small and orphaning it otherwise
+	size_t instanceSize = instances.size() * sizeof(InstanceData);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	if (instanceSize > instanceCapacity) instanceCapacity = instanceSize * 2;
+	glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, instanceSize, instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+const std::vector<InstanceBatch::Run>& InstanceBatch::getRuns() const
+{
+	return runs;
+}
+
+void InstanceBatch::draw(const Run& run) const
+{
+	// Point the instance attributes at the runs first instance
+	glBindVertexBuffer(INSTANCE_BINDING, instanceBuffer, static_cast<GLintptr>(run.firstInstance * sizeof(InstanceData)), sizeof(InstanceData));
+
+	// Vertex arrays are shared with non instanced draws, so instance attributes are only enabled while drawing instances
+	setAttributesEnabled(true);
+	LodSelection::drawInstanced(*run.mesh, run.lod, run.nInstances);
+	setAttributesEnabled(false);
+}
+
+void InstanceBatch::setupAttributes()
+{
+	// Model matrix columns
+	for (uint32_t i = 0; i < 4; i++) {
+		glVertexAttribFormat(MODEL_MATRIX_LOCATION + i, 4, GL_FLOAT, GL_FALSE, static_cast<uint32_t>(offsetof(InstanceData, modelMatrix) + i * sizeof(glm::vec4)));
+		glVertexAttribBinding(MODEL_MATRIX_LOCATION + i, INSTANCE_BINDING);
+	}
+
+	// Normal matrix columns
+	for (uint32_t i = 0; i < 3; i++) {
+		glVertexAttribFormat(NORMAL_MATRIX_LOCATION + i, 3, GL_FLOAT, GL_FALSE, static_cast<uint32_t>(offsetof(InstanceData, normalMatrix) + i * sizeof(glm::vec3)));
+		glVertexAttribBinding(NORMAL_MATRIX_LOCATION + i, INSTANCE_BINDING);
+	}
+
+	// Advance once per instance
+	glVertexBindingDivisor(INSTANCE_BINDING, 1);
+}
+
+void InstanceBatch::setAttributesEnabled(bool enabled)
+{
+	// Model and normal matrix columns are consecutive locations
+	for (uint32_t location = MODEL_MATRIX_LOCATION; location < NORMAL_MATRIX_LOCATION + 3; location++) {
+		if (enabled) glEnableVertexAttribArray(location);
+		else glDisableVertexAttribArray(location);
+	}
+}
\ No newline at end of file
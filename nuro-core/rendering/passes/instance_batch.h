@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class Mesh;
+class IMaterial;
+
+// Per instance transforms of a frame, consecutive draws of the same mesh, level of detail and material are collapsed into one instanced draw
+class InstanceBatch
+{
+public:
+	// Per instance data as read by the instanced shader variants through vertex attributes
+	struct InstanceData
+	{
+		glm::mat4 modelMatrix;
+		glm::mat3 normalMatrix;
+	};
+
+	// Consecutive instances sharing mesh, level of detail and material
+	struct Run
+	{
+		const IMaterial* material = nullptr;
+		const Mesh* mesh = nullptr;
+		uint32_t lod = 0;
+		uint32_t firstInstance = 0;
+		uint32_t nInstances = 0;
+	};
+
+	// Vertex buffer binding index the instance buffer is bound to
+	static constexpr uint32_t INSTANCE_BINDING = 15;
+
+	// First attribute location of the model matrix columns (5 to 8)
+	static constexpr uint32_t MODEL_MATRIX_LOCATION = 5;
+
+	// First attribute location of the normal matrix columns (9 to 11)
+	static constexpr uint32_t NORMAL_MATRIX_LOCATION = 9;
+
+	InstanceBatch();
+
+	void create();
+	void destroy();
+
+	// Clears all instances of the last frame
+	void clear();
+
+	// Adds an instance of the given level of detail, extending the last run if mesh, level of detail and material match
+	void add(const IMaterial* material, const Mesh& mesh, uint32_t lod, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix);
+
+	// Uploads the instance data
+	void upload();
+
+	// Returns the runs of the current instances
+	const std::vector<Run>& getRuns() const;
+
+	// Binds the instance data of a run to the bound vertex array and draws all its instances, the runs mesh must be bound
+	void draw(const Run& run) const;
+
+	// Sets up the format of the per instance attributes of the bound vertex array, reading from the instance buffer binding
+	// The attributes stay disabled, unbound enabled attributes would be sourced by non instanced draws too
+	static void setupAttributes();
+
+private:
+	// Enables or disables the per instance attributes of the bound vertex array
+	static void setAttributesEnabled(bool enabled);
+
+	std::vector<InstanceData> instances;
+	std::vector<Run> runs;
+
+	// Vertex buffer of the instance data
+	uint32_t instanceBuffer;
+	size_t instanceCapacity;
+};
\ No newline at end of file
@@ -2,10 +2,13 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <ecs/ecs_collection.h>
 #include <transform/transform.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/model/lod_selection.h>
 #include <rendering/shader/shader.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/transformation/transformation.h>
@@ -14,7 +17,9 @@ PrePass::PrePass(const Viewport& viewport) : viewport(viewport),
 fbo(0),
 depthOutput(0),
 normalOutput(0),
-prePassShader(ShaderPool::empty())
+prePassShader(ShaderPool::empty()),
+lodBias(2.0f),
+instanceBatch()
 {
 }
 
@@ -25,11 +30,11 @@ void PrePass::create()
 
 	// Generate framebuffer
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Generate depth output
 	glGenTextures(1, &depthOutput);
-	glBindTexture(GL_TEXTURE_2D, depthOutput);
+	GLState::bindTexture(GL_TEXTURE_2D, depthOutput);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 
 	// Set depth output parameters
@@ -43,7 +48,7 @@ void PrePass::create()
 
 	// Generate normal output
 	glGenTextures(1, &normalOutput);
-	glBindTexture(GL_TEXTURE_2D, normalOutput);
+	GLState::bindTexture(GL_TEXTURE_2D, normalOutput);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGB, GL_FLOAT, nullptr);
 
 	// Set normal output parameters
@@ -63,62 +68,116 @@ void PrePass::create()
 	}
 
 	// Unbind fbo
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Create instance buffer
+	instanceBatch.create();
 }
 
 void PrePass::destroy() {
 	// Delete depth output texture
-	glDeleteTextures(1, &depthOutput);
+	GLState::deleteTextures(1, &depthOutput);
 	depthOutput = 0;
 
 	// Delete normal output texture
-	glDeleteTextures(1, &normalOutput);
+	GLState::deleteTextures(1, &normalOutput);
 	normalOutput = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &fbo);
+	GLState::deleteFramebuffers(1, &fbo);
 	fbo = 0;
 
+	// Delete instance buffer
+	instanceBatch.destroy();
+
 	// Remove shaders
 	prePassShader = nullptr;
 }
 
-void PrePass::render(glm::mat4 viewProjection, glm::mat3 viewNormal)
+void PrePass::render(ViewMatrices& viewMatrices, glm::mat3 viewNormal)
 {
 	// Set viewport for upcoming pre pass
 	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
 
 	// Bind pre pass framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Clear color and depth buffer
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::depthFunc(GL_LESS);
 
 	// Cull backfaces
-	glCullFace(GL_BACK);
+	GLState::cullFace(GL_BACK);
+
+	// Meshes are instanced if the shader provides the instanced variant
+	bool instanced = prePassShader->hasVariant(Shader::Variant::INSTANCED);
 
 	// Bind pre pass shader
 	prePassShader->bind();
 
-	// Pre pass render each entity
-	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent>();
-	for (auto [entity, transform, renderer] : targets.each()) {
-		if (!renderer.mesh) return;
+	// Pre pass render each entity, the render queue keeps repeated meshes next to each other
+	uint32_t currentVao = 0;
+	instanceBatch.clear();
+	for (auto [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+		if (!renderer.mesh) continue;
+
+		// Skip meshes outside the view frustum
+		const glm::mat4& mvp = viewMatrices.mvp(transform);
+		if (!MeshBounds::intersectsFrustum(renderer.mesh->bounds(), mvp)) continue;
+
+		// Select level of detail
+		uint32_t& lod = viewMatrices.lod(transform, ViewMatrices::LodPass::PRE_PASS);
+		lod = LodSelection::select(*renderer.mesh, mvp, lod, lodBias);
 
-		// Bind mesh
-		glBindVertexArray(renderer.mesh->vao());
+		// Collect instance
+		if (instanced) {
+			instanceBatch.add(nullptr, *renderer.mesh, lod, Transform::model(transform), Transform::normal(transform));
+			continue;
+		}
+
+		// Bind mesh if its vertex array isn't bound already
+		if (renderer.mesh->vao() != currentVao) {
+			GLState::bindVertexArray(renderer.mesh->vao());
+			currentVao = renderer.mesh->vao();
+		}
 
 		// Set depth pre pass shader uniforms
-		prePassShader->setMatrix4("mvpMatrix", transform.mvp);
-		prePassShader->setMatrix3("viewNormalMatrix", viewNormal);
+		prePassShader->setMatrix4(UniformId<"mvpMatrix">, mvp);
+		prePassShader->setMatrix3(UniformId<"viewNormalMatrix">, viewNormal * Transform::normal(transform));
+		VertexFormat::setDecodeUniforms(*prePassShader, *renderer.mesh);
 
 		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+		LodSelection::draw(*renderer.mesh, lod);
+	}
+
+	if (!instanced) return;
+
+	// Upload instance data
+	instanceBatch.upload();
+
+	// Bind instanced pre pass shader
+	prePassShader->bind(Shader::Variant::INSTANCED);
+	prePassShader->setMatrix4(UniformId<"viewProjectionMatrix">, viewMatrices.getViewProjection());
+	prePassShader->setMatrix3(UniformId<"viewNormalMatrix">, viewNormal);
+
+	// Render each run of instances with a single draw
+	for (const InstanceBatch::Run& run : instanceBatch.getRuns()) {
+
+		// Bind mesh if its vertex array isn't bound already
+		if (run.mesh->vao() != currentVao) {
+			GLState::bindVertexArray(run.mesh->vao());
+			currentVao = run.mesh->vao();
+		}
+
+		// Set decode uniforms of the runs mesh
+		VertexFormat::setDecodeUniforms(*prePassShader, *run.mesh);
+
+		// Render instances
+		instanceBatch.draw(run);
 	}
 }
 
@@ -132,4 +191,9 @@ uint32_t PrePass::getNormalOutput()
 {
 	// Return pre pass normal output
 	return normalOutput;
+}
+
+void PrePass::setLodBias(float _lodBias)
+{
+	lodBias = _lodBias;
 }
\ No newline at end of file
@@ -5,7 +5,9 @@
 #include <glm/glm.hpp>
 
 #include <viewport/viewport.h>
+#include <transform/view_matrices.h>
 #include <memory/resource_manager.h>
+#include <rendering/passes/instance_batch.h>
 
 class Shader;
 
@@ -17,11 +19,14 @@ public:
 	void create();
 	void destroy();
 
-	void render(glm::mat4 viewProjection, glm::mat3 viewNormal);
+	void render(ViewMatrices& viewMatrices, glm::mat3 viewNormal);
 
 	uint32_t getDepthOutput();
 	uint32_t getNormalOutput();
 
+	// Sets the level of detail bias of the pre pass, larger biases select coarser levels than the forward pass
+	void setLodBias(float lodBias);
+
 private:
 	const Viewport& viewport;
 
@@ -30,4 +35,8 @@ private:
 	uint32_t normalOutput;
 
 	ResourceRef<Shader> prePassShader;
+
+	float lodBias;
+
+	InstanceBatch instanceBatch; // Per instance transforms of instanced draws
 };
\ No newline at end of file
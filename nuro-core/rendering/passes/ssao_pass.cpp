@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <rendering/shader/shader.h>
 #include <rendering/shader/shader_pool.h>
@@ -53,11 +54,11 @@ void SSAOPass::create(float aoScale, int32_t maxKernelSamples, float noiseResolu
 
 	// Generate framebuffer
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Generate ambient occlusion output texture
 	glGenTextures(1, &aoOutput);
-	glBindTexture(GL_TEXTURE_2D, aoOutput);
+	GLState::bindTexture(GL_TEXTURE_2D, aoOutput);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, viewport.getWidth_gl() * aoScale, viewport.getHeight_gl() * aoScale, 0, GL_RED, GL_FLOAT, nullptr);
 
 	// Set ambient occlusion output texture parameters
@@ -71,7 +72,7 @@ void SSAOPass::create(float aoScale, int32_t maxKernelSamples, float noiseResolu
 
 	// Generate blurred ambient occlusion output texture
 	glGenTextures(1, &blurredOutput);
-	glBindTexture(GL_TEXTURE_2D, blurredOutput);
+	GLState::bindTexture(GL_TEXTURE_2D, blurredOutput);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RED, GL_FLOAT, nullptr);
 
 	// Set blurred ambient occlusion output texture parameters
@@ -88,7 +89,7 @@ void SSAOPass::create(float aoScale, int32_t maxKernelSamples, float noiseResolu
 	}
 
 	// Unbind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void SSAOPass::destroy() {
@@ -98,15 +99,15 @@ void SSAOPass::destroy() {
 	noiseResolution = 0;
 
 	// Delete ambient occlusion output texture
-	glDeleteTextures(1, &aoOutput);
+	GLState::deleteTextures(1, &aoOutput);
 	aoOutput = 0;
 
 	// Delete blurred output texture
-	glDeleteTextures(1, &blurredOutput);
+	GLState::deleteTextures(1, &blurredOutput);
 	blurredOutput = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &fbo);
+	GLState::deleteFramebuffers(1, &fbo);
 	fbo = 0;
 
 	// Reset shaders
@@ -117,18 +118,18 @@ void SSAOPass::destroy() {
 	kernel.clear();
 
 	// Delete noise texture
-	glDeleteTextures(1, &noiseTexture);
+	GLState::deleteTextures(1, &noiseTexture);
 	noiseTexture = 0;
 }
 
 uint32_t SSAOPass::render(const glm::mat4& projection, const PostProcessing::Profile& profile, uint32_t depthInput, uint32_t normalInput)
 {
 	// Disable depth testing and culling
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_CULL_FACE);
+	GLState::disable(GL_DEPTH_TEST);
+	GLState::disable(GL_CULL_FACE);
 
 	// Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Perform ambient occlusion pass
 	ambientOcclusionPass(projection, profile, depthInput, normalInput);
@@ -138,8 +139,8 @@ uint32_t SSAOPass::render(const glm::mat4& projection, const PostProcessing::Pro
 	blurPass(profile);
 
 	// Re-Enable depth testing and culling
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::enable(GL_CULL_FACE);
 
 	// Return blurred output
 	// return blurredOutput;
@@ -181,16 +182,16 @@ void SSAOPass::ambientOcclusionPass(const glm::mat4& projection, const PostProce
 	aoPassShader->setFloat("power", profile.ambientOcclusion.power);
 
 	// Bind depth input
-	glActiveTexture(GL_TEXTURE0 + DEPTH_UNIT);
-	glBindTexture(GL_TEXTURE_2D, depthInput);
+	GLState::activeTexture(GL_TEXTURE0 + DEPTH_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, depthInput);
 
 	// Bind normal input
-	glActiveTexture(GL_TEXTURE0 + NORMAL_UNIT);
-	glBindTexture(GL_TEXTURE_2D, normalInput);
+	GLState::activeTexture(GL_TEXTURE0 + NORMAL_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, normalInput);
 
 	// Bind noise texture
-	glActiveTexture(GL_TEXTURE0 + NOISE_UNIT);
-	glBindTexture(GL_TEXTURE_2D, noiseTexture);
+	GLState::activeTexture(GL_TEXTURE0 + NOISE_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, noiseTexture);
 
 	// Bind and render to quad
 	GlobalQuad::bind();
@@ -209,8 +210,8 @@ void SSAOPass::blurPass(const PostProcessing::Profile& profile)
 	aoBlurShader->bind();
 
 	// Bind ao input
-	glActiveTexture(GL_TEXTURE0 + AO_UNIT);
-	glBindTexture(GL_TEXTURE_2D, aoOutput);
+	GLState::activeTexture(GL_TEXTURE0 + AO_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, aoOutput);
 
 	// Bind and render to quad
 	GlobalQuad::bind();
@@ -258,7 +259,7 @@ uint32_t SSAOPass::generateNoiseTexture()
 	// Generate noise texture with noise samples
 	uint32_t output = 0;
 	glGenTextures(1, &output);
-	glBindTexture(GL_TEXTURE_2D, output);
+	GLState::bindTexture(GL_TEXTURE_2D, output);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, static_cast<GLsizei>(noiseResolution), static_cast<GLsizei>(noiseResolution), 0, GL_RGB, GL_FLOAT, &noiseSamples[0]);
 
 	// Set noise texture parameters
@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/shader/shader.h>
 #include <rendering/primitives/global_quad.h>
@@ -53,11 +54,11 @@ void BloomPass::create(const uint32_t mipDepth)
 
 	// Generate framebuffer
 	glGenFramebuffers(1, &framebuffer);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
 	// Generate prefilter texture
 	glGenTextures(1, &prefilterOutput);
-	glBindTexture(GL_TEXTURE_2D, prefilterOutput);
+	GLState::bindTexture(GL_TEXTURE_2D, prefilterOutput);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, nullptr);
 
 	// Set prefilter texture parameters
@@ -81,7 +82,7 @@ void BloomPass::create(const uint32_t mipDepth)
 
 		// Generate mips texture
 		glGenTextures(1, &mip.texture);
-		glBindTexture(GL_TEXTURE_2D, mip.texture);
+		GLState::bindTexture(GL_TEXTURE_2D, mip.texture);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, iMipSize.x, iMipSize.y, 0, GL_RGBA, GL_FLOAT, nullptr);
 
 		// Set mip textures parameters
@@ -109,26 +110,26 @@ void BloomPass::create(const uint32_t mipDepth)
 	}
 
 	// Unbind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void BloomPass::destroy()
 {
 	// Delete prefilter texture
-	glDeleteTextures(1, &prefilterOutput);
+	GLState::deleteTextures(1, &prefilterOutput);
 	prefilterOutput = 0;
 
 	// Delete all mipmap texture
 	for (auto& mip : mipChain)
 	{
-		glDeleteTextures(1, &mip.texture);
+		GLState::deleteTextures(1, &mip.texture);
 	}
 
 	// Clear mipchain
 	mipChain.clear();
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &framebuffer);
+	GLState::deleteFramebuffers(1, &framebuffer);
 	framebuffer = 0;
 
 	// Remove shaders
@@ -140,7 +141,7 @@ void BloomPass::destroy()
 uint32_t BloomPass::render(const uint32_t hdrInput)
 {
 	// Bind bloom framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
 	// Perform prefiltering pass
 	uint32_t PREFILTERING_PASS_OUTPUT = prefilteringPass(hdrInput);
@@ -152,7 +153,7 @@ uint32_t BloomPass::render(const uint32_t hdrInput)
 	upsamplingPass();
 
 	// Unbind framebuffer to restore original viewport
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 	glViewport(0, 0, iViewportSize.x, iViewportSize.y);
 
 	// Return texture of first bloom mip (the texture being rendered to)
@@ -167,8 +168,8 @@ uint32_t BloomPass::prefilteringPass(const uint32_t hdrInput)
 	prefilterShader->setFloat("softThreshold", softThreshold);
 
 	// Bind input texture for prefilter pass
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, hdrInput);
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, hdrInput);
 
 	// Set prefilter target texture as framebuffer render target
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, prefilterOutput, 0);
@@ -188,8 +189,8 @@ void BloomPass::downsamplingPass(const uint32_t hdrInput)
 	downsamplingShader->setVec2("inversedResolution", inversedViewportSize);
 
 	// Bind input as initial texture input
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, hdrInput);
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, hdrInput);
 
 	// Downsample through mip chain
 	for (int32_t i = 0; i < mipChain.size(); i++)
@@ -209,7 +210,7 @@ void BloomPass::downsamplingPass(const uint32_t hdrInput)
 		downsamplingShader->setVec2("inversedResolution", mip.inversedSize);
 
 		// Bind mip texture for next downsample iteration
-		glBindTexture(GL_TEXTURE_2D, mip.texture);
+		GLState::bindTexture(GL_TEXTURE_2D, mip.texture);
 	}
 }
 
@@ -224,8 +225,8 @@ void BloomPass::upsamplingPass()
 	upsamplingShader->setFloat("aspectRatio", aspectRatio);
 
 	// Enable additive blending
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_ONE, GL_ONE);
+	GLState::enable(GL_BLEND);
+	GLState::blendFunc(GL_ONE, GL_ONE);
 	glBlendEquation(GL_FUNC_ADD);
 
 	// Upsample through mip chain
@@ -236,8 +237,8 @@ void BloomPass::upsamplingPass()
 		const BloomPass::Mip& targetMip = mipChain[i - 1];
 
 		// Set input texture for next render to be current mips texture
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, mip.texture);
+		GLState::activeTexture(GL_TEXTURE0);
+		GLState::bindTexture(GL_TEXTURE_2D, mip.texture);
 
 		// Set viewport and set render target
 		glViewport(0, 0, static_cast<GLsizei>(targetMip.fSize.x), static_cast<GLsizei>(targetMip.fSize.y));
@@ -249,5 +250,5 @@ void BloomPass::upsamplingPass()
 	}
 
 	// Disable additive blending
-	glDisable(GL_BLEND);
+	GLState::disable(GL_BLEND);
 }
\ No newline at end of file
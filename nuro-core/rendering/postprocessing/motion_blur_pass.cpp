@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <rendering/shader/shader.h>
 #include <diagnostics/diagnostics.h>
@@ -33,11 +34,11 @@ void MotionBlurPass::create()
 
 	// Generate framebuffer
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Generate output texture
 	glGenTextures(1, &output);
-	glBindTexture(GL_TEXTURE_2D, output);
+	GLState::bindTexture(GL_TEXTURE_2D, output);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, nullptr);
 
 	// Set output texture parameters
@@ -57,17 +58,17 @@ void MotionBlurPass::create()
 	}
 
 	// Unbind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void MotionBlurPass::destroy()
 {
 	// Delete output texture
-	glDeleteTextures(1, &output);
+	GLState::deleteTextures(1, &output);
 	output = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &fbo);
+	GLState::deleteFramebuffers(1, &fbo);
 	fbo = 0;
 
 	// Remove shader
@@ -77,14 +78,14 @@ void MotionBlurPass::destroy()
 uint32_t MotionBlurPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const PostProcessing::Profile& profile, const uint32_t hdrInput, const uint32_t depthInput, const uint32_t velocityBufferInput)
 {
 	// Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Bind textures
-	glActiveTexture(GL_TEXTURE0 + HDR_UNIT);
-	glBindTexture(GL_TEXTURE_2D, hdrInput);
+	GLState::activeTexture(GL_TEXTURE0 + HDR_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, hdrInput);
 
-	glActiveTexture(GL_TEXTURE0 + DEPTH_UNIT);
-	glBindTexture(GL_TEXTURE_2D, depthInput);
+	GLState::activeTexture(GL_TEXTURE0 + DEPTH_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, depthInput);
 
 	// Bind shader
 	shader->bind();
@@ -106,8 +107,8 @@ uint32_t MotionBlurPass::render(const glm::mat4& view, const glm::mat4& projecti
 	if (objectEnabled)
 	{
 		// Attach velocity buffer
-		glActiveTexture(GL_TEXTURE0 + VELOCITY_UNIT);
-		glBindTexture(GL_TEXTURE_2D, velocityBufferInput);
+		GLState::activeTexture(GL_TEXTURE0 + VELOCITY_UNIT);
+		GLState::bindTexture(GL_TEXTURE_2D, velocityBufferInput);
 
 		// Set object motion blur uniforms
 		shader->setInt("objectSamples", profile.motionBlur.objectSamples);
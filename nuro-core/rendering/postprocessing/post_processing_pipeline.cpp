@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <rendering/shader/shader.h>
 #include <rendering/passes/pre_pass.h>
@@ -29,11 +30,11 @@ void PostProcessingPipeline::create()
 
 		// Generate framebuffer
 		glGenFramebuffers(1, &fbo);
-		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 		// Generate output texture
 		glGenTextures(1, &output);
-		glBindTexture(GL_TEXTURE_2D, output);
+		GLState::bindTexture(GL_TEXTURE_2D, output);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, NULL);
 
 		// Set output texture parameters
@@ -71,11 +72,11 @@ void PostProcessingPipeline::create()
 void PostProcessingPipeline::destroy()
 {
 	// Delete output texture
-	glDeleteTextures(1, &output);
+	GLState::deleteTextures(1, &output);
 	output = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &fbo);
+	GLState::deleteFramebuffers(1, &fbo);
 	fbo = 0;
 
 	// Destroy all passes
@@ -89,7 +90,7 @@ void PostProcessingPipeline::destroy()
 void PostProcessingPipeline::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const PostProcessing::Profile& profile, const uint32_t hdrInput, const uint32_t depthInput, const uint32_t velocityBufferInput)
 {
 	// Disable any depth testing for whole post processing pass
-	glDisable(GL_DEPTH_TEST);
+	GLState::disable(GL_DEPTH_TEST);
 
 	// Pass input through post processing pipeline
 	uint32_t POST_PROCESSING_PIPELINE_HDR = hdrInput;
@@ -112,7 +113,7 @@ void PostProcessingPipeline::render(const glm::mat4& view, const glm::mat4& proj
 	}
 
 	// Bind post processing framebuffer (which is 0 if rendering to screen)
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Bind finalPassShader and set uniforms
 	finalPassShader->bind();
@@ -122,22 +123,22 @@ void PostProcessingPipeline::render(const glm::mat4& view, const glm::mat4& proj
 	syncConfiguration(profile);
 
 	// Bind forward pass hdr color buffer
-	glActiveTexture(GL_TEXTURE0 + HDR_UNIT);
-	glBindTexture(GL_TEXTURE_2D, POST_PROCESSING_PIPELINE_HDR);
+	GLState::activeTexture(GL_TEXTURE0 + HDR_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, POST_PROCESSING_PIPELINE_HDR);
 
 	// Bind pre pass depth buffer
-	glActiveTexture(GL_TEXTURE0 + DEPTH_UNIT);
-	glBindTexture(GL_TEXTURE_2D, depthInput);
+	GLState::activeTexture(GL_TEXTURE0 + DEPTH_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, depthInput);
 
 	// Bind bloom buffer
-	glActiveTexture(GL_TEXTURE0 + BLOOM_UNIT);
-	glBindTexture(GL_TEXTURE_2D, BLOOM_PASS_OUTPUT);
+	GLState::activeTexture(GL_TEXTURE0 + BLOOM_UNIT);
+	GLState::bindTexture(GL_TEXTURE_2D, BLOOM_PASS_OUTPUT);
 
 	// Bind lens dirt texture
 	if (profile.bloom.lensDirtEnabled)
 	{
-		glActiveTexture(GL_TEXTURE0 + LENS_DIRT_UNIT);
-		glBindTexture(GL_TEXTURE_2D, profile.bloom.lensDirtTexture);
+		GLState::activeTexture(GL_TEXTURE0 + LENS_DIRT_UNIT);
+		GLState::bindTexture(GL_TEXTURE_2D, profile.bloom.lensDirtTexture);
 	}
 
 	// Bind quad and render to screen
@@ -145,7 +146,7 @@ void PostProcessingPipeline::render(const glm::mat4& view, const glm::mat4& proj
 	GlobalQuad::render();
 
 	// Unbind post processing framebuffer (redundant if rendering to screen)
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 uint32_t PostProcessingPipeline::getOutput()
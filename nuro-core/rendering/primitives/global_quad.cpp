@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
+
 namespace GlobalQuad {
 
 	uint32_t _vbo = 0;
@@ -22,7 +24,7 @@ namespace GlobalQuad {
 		glGenVertexArrays(1, &_vao);
 		glGenBuffers(1, &_vbo);
 
-		glBindVertexArray(_vao);
+		GLState::bindVertexArray(_vao);
 		glBindBuffer(GL_ARRAY_BUFFER, _vbo);
 
 		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices, GL_STATIC_DRAW);
@@ -34,7 +36,7 @@ namespace GlobalQuad {
 
 	void bind()
 	{
-		glBindVertexArray(_vao);
+		GLState::bindVertexArray(_vao);
 	}
 
 	void render()
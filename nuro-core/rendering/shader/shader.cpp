@@ -1,15 +1,31 @@
 #include "shader.h"
 
+#include <algorithm>
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <backend/gl_state.h>
 #include <utils/fsutil.h>
 #include <utils/console.h>
 
+// Defines enabling each variant within the vertex and fragment source, empty if the variant is always provided
+static const char* gVariantDefines[static_cast<size_t>(Shader::Variant::COUNT)] = {
+	"",
+	"INDIRECT_DRAW",
+	"INSTANCED_DRAW"
+};
+
+// Versions variant vertex sources are compiled as, empty if the sources own version is kept
+static const char* gVariantVersions[static_cast<size_t>(Shader::Variant::COUNT)] = {
+	"",
+	"#version 460 core",
+	""
+};
+
 Shader::Shader() : sourcePath(),
 data(),
-uniforms(),
-_backendId(0)
+programs(),
+boundVariant(Variant::DEFAULT)
 {
 }
 
@@ -28,60 +44,151 @@ void Shader::setSource(const FS::Path& _sourcePath)
 	sourcePath = _sourcePath;
 }
 
-void Shader::bind() const
+void Shader::bind(Variant variant) const
 {
-	glUseProgram(_backendId);
+	boundVariant = variant;
+	GLState::useProgram(programs[static_cast<size_t>(variant)].backendId);
+}
+
+bool Shader::hasVariant(Variant variant) const
+{
+	return programs[static_cast<size_t>(variant)].backendId != 0;
 }
 
 uint32_t Shader::backendId() const
 {
-	return _backendId;
+	return programs[static_cast<size_t>(Variant::DEFAULT)].backendId;
+}
+
+void Shader::setUniformBlockBinding(const std::string& identifier, uint32_t binding)
+{
+	for (const Program& program : programs) {
+		if (!program.backendId) continue;
+
+		uint32_t index = glGetUniformBlockIndex(program.backendId, identifier.c_str());
+		if (index != GL_INVALID_INDEX) glUniformBlockBinding(program.backendId, index, binding);
+	}
 }
 
 void Shader::setBool(const std::string& identifier, bool value)
 {
-	glUniform1i(getUniformLocation(identifier), (int32_t)value);
+	glUniform1i(getUniformLocation(UniformHash::fnv1a(identifier)), (int32_t)value);
 }
 void Shader::setInt(const std::string& identifier, int32_t value)
 {
-	glUniform1i(getUniformLocation(identifier), value);
+	glUniform1i(getUniformLocation(UniformHash::fnv1a(identifier)), value);
 }
 void Shader::setFloat(const std::string& identifier, float value)
 {
-	glUniform1f(getUniformLocation(identifier), value);
+	glUniform1f(getUniformLocation(UniformHash::fnv1a(identifier)), value);
 }
 void Shader::setVec2(const std::string& identifier, glm::vec2 value)
 {
-	glUniform2f(getUniformLocation(identifier), value.x, value.y);
+	glUniform2f(getUniformLocation(UniformHash::fnv1a(identifier)), value.x, value.y);
 }
 void Shader::setVec3(const std::string& identifier, glm::vec3 value)
 {
-	glUniform3f(getUniformLocation(identifier), value.x, value.y, value.z);
+	glUniform3f(getUniformLocation(UniformHash::fnv1a(identifier)), value.x, value.y, value.z);
 }
 void Shader::setVec4(const std::string& identifier, glm::vec4 value)
 {
-	glUniform4f(getUniformLocation(identifier), value.x, value.y, value.z, value.w);
+	glUniform4f(getUniformLocation(UniformHash::fnv1a(identifier)), value.x, value.y, value.z, value.w);
 }
 void Shader::setMatrix3(const std::string& identifier, glm::mat3 value)
 {
-	glUniformMatrix3fv(getUniformLocation(identifier), 1, GL_FALSE, glm::value_ptr(value));
+	glUniformMatrix3fv(getUniformLocation(UniformHash::fnv1a(identifier)), 1, GL_FALSE, glm::value_ptr(value));
 }
 void Shader::setMatrix4(const std::string& identifier, glm::mat4 value)
 {
-	glUniformMatrix4fv(getUniformLocation(identifier), 1, GL_FALSE, glm::value_ptr(value));
+	glUniformMatrix4fv(getUniformLocation(UniformHash::fnv1a(identifier)), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::setBool(UniformKey identifier, bool value)
+{
+	glUniform1i(getUniformLocation(identifier.hash), (int32_t)value);
+}
+void Shader::setInt(UniformKey identifier, int32_t value)
+{
+	glUniform1i(getUniformLocation(identifier.hash), value);
+}
+void Shader::setFloat(UniformKey identifier, float value)
+{
+	glUniform1f(getUniformLocation(identifier.hash), value);
+}
+void Shader::setVec2(UniformKey identifier, glm::vec2 value)
+{
+	glUniform2f(getUniformLocation(identifier.hash), value.x, value.y);
+}
+void Shader::setVec3(UniformKey identifier, glm::vec3 value)
+{
+	glUniform3f(getUniformLocation(identifier.hash), value.x, value.y, value.z);
+}
+void Shader::setVec4(UniformKey identifier, glm::vec4 value)
+{
+	glUniform4f(getUniformLocation(identifier.hash), value.x, value.y, value.z, value.w);
+}
+void Shader::setMatrix3(UniformKey identifier, glm::mat3 value)
+{
+	glUniformMatrix3fv(getUniformLocation(identifier.hash), 1, GL_FALSE, glm::value_ptr(value));
+}
+void Shader::setMatrix4(UniformKey identifier, glm::mat4 value)
+{
+	glUniformMatrix4fv(getUniformLocation(identifier.hash), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-int32_t Shader::getUniformLocation(const std::string& identifier)
+int32_t Shader::getUniformLocation(uint32_t hash) const
 {
-	// Uniform found in cache, return uniform location
-	if (uniforms.find(identifier) != uniforms.end()) return uniforms[identifier];
+	const std::vector<UniformLocation>& locations = programs[static_cast<size_t>(boundVariant)].locations;
 
-	// Uniform not found in cache, fetch and save uniform location
-	int32_t location = glGetUniformLocation(_backendId, identifier.c_str());
-	uniforms[identifier] = location;
+	// Binary search the location table
+	auto it = std::lower_bound(locations.begin(), locations.end(), hash, [](const UniformLocation& entry, uint32_t value) { return entry.hash < value; });
+	if (it == locations.end() || it->hash != hash) return -1;
 
-	// Return newly fetched uniform location
-	return location;
+	return it->location;
+}
+
+void Shader::buildLocationTable(Program& program)
+{
+	program.locations.clear();
+
+	int32_t nUniforms = 0;
+	int32_t maxNameLength = 0;
+	glGetProgramiv(program.backendId, GL_ACTIVE_UNIFORMS, &nUniforms);
+	glGetProgramiv(program.backendId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	// Adds the location of a uniform, uniforms within uniform blocks have no location and are skipped
+	auto addLocation = [&](const std::string& name) {
+		int32_t location = glGetUniformLocation(program.backendId, name.c_str());
+		if (location >= 0) program.locations.push_back({ UniformHash::fnv1a(name), location });
+	};
+
+	std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+	for (int32_t i = 0; i < nUniforms; i++) {
+		int32_t nameLength = 0;
+		int32_t size = 0;
+		uint32_t type = 0;
+		glGetActiveUniform(program.backendId, i, static_cast<int32_t>(nameBuffer.size()), &nameLength, &size, &type, nameBuffer.data());
+		std::string name(nameBuffer.data(), nameLength);
+
+		if (name.size() < 3 || name.compare(name.size() - 3, 3, "[0]") != 0) {
+			addLocation(name);
+			continue;
+		}
+
+		// Arrays are reported by their first element, add the array name and each element
+		std::string arrayName = name.substr(0, name.size() - 3);
+		addLocation(arrayName);
+		for (int32_t element = 0; element < size; element++)
+			addLocation(arrayName + "[" + std::to_string(element) + "]");
+	}
+
+	// Sort by hash for lookups, colliding names can't be told apart so only one of them is kept
+	std::sort(program.locations.begin(), program.locations.end(), [](const UniformLocation& a, const UniformLocation& b) { return a.hash < b.hash; });
+	auto duplicate = std::adjacent_find(program.locations.begin(), program.locations.end(), [](const UniformLocation& a, const UniformLocation& b) { return a.hash == b.hash; });
+	if (duplicate != program.locations.end()) {
+		Console::out::warning("Shader", "Uniform name hash collision in shader at '" + sourcePath.string() + "'");
+		program.locations.erase(std::unique(program.locations.begin(), program.locations.end(), [](const UniformLocation& a, const UniformLocation& b) { return a.hash == b.hash; }), program.locations.end());
+	}
 }
 
 bool Shader::shaderCompiled(const char* type, int32_t shader)
@@ -108,7 +215,7 @@ bool Shader::programLinked(int32_t program)
 	// Fetch shader program linking status
 	int32_t success;
 	char shader_log[512];
-	glGetProgramiv(program, GL_COMPILE_STATUS, &success);
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
 
 	// Shader program linking failed, terminate program
 	if (!success)
@@ -141,39 +248,86 @@ bool Shader::uploadBuffers()
 	// Don't dispatch shader if there is no data
 	if (data.vertexSource.empty() || data.fragmentSource.empty()) return false;
 
+	// Compile default program
+	uint32_t program = compileProgram(data.vertexSource, data.fragmentSource);
+	if (!program) return false;
+	programs[static_cast<size_t>(Variant::DEFAULT)].backendId = program;
+	buildLocationTable(programs[static_cast<size_t>(Variant::DEFAULT)]);
+
+	// Compile variants the vertex source provides, replacing its version directive by the variants version and define
+	for (size_t i = 1; i < static_cast<size_t>(Variant::COUNT); i++) {
+		if (data.vertexSource.find(gVariantDefines[i]) == std::string::npos) continue;
+
+		size_t versionEnd = data.vertexSource.find('\n');
+		if (data.vertexSource.compare(0, 8, "#version") != 0 || versionEnd == std::string::npos) continue;
+
+		std::string version = *gVariantVersions[i] ? gVariantVersions[i] : data.vertexSource.substr(0, versionEnd);
+		std::string variantSource = version + "\n#define " + gVariantDefines[i] + data.vertexSource.substr(versionEnd);
+
+		// Define the variant within the fragment source too, keeping its own version
+		std::string variantFragmentSource = data.fragmentSource;
+		size_t fragmentVersionEnd = variantFragmentSource.find('\n');
+		if (variantFragmentSource.compare(0, 8, "#version") == 0 && fragmentVersionEnd != std::string::npos)
+			variantFragmentSource.insert(fragmentVersionEnd, "\n#define " + std::string(gVariantDefines[i]));
+
+		programs[i].backendId = compileProgram(variantSource, variantFragmentSource);
+		if (programs[i].backendId) buildLocationTable(programs[i]);
+		else Console::out::warning("Shader", "Couldn't compile variant " + std::string(gVariantDefines[i]) + " of shader at '" + sourcePath.string() + "'");
+	}
+
+	return true;
+}
+
+uint32_t Shader::compileProgram(const std::string& vertexSource, const std::string& fragmentSource)
+{
 	// Shader backend ids
 	uint32_t vertexShader, fragmentShader;
 
 	// Compile vertex shader source
-	const char* vertexSource = data.vertexSource.c_str();
+	const char* vertexSourceData = vertexSource.c_str();
 	vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexSource, nullptr);
+	glShaderSource(vertexShader, 1, &vertexSourceData, nullptr);
 	glCompileShader(vertexShader);
-	if (!shaderCompiled("vertex", vertexShader)) return false;
+	if (!shaderCompiled("vertex", vertexShader)) {
+		glDeleteShader(vertexShader);
+		return 0;
+	}
 
 	// Compile fragment shader source
-	const char* fragmentSource = data.fragmentSource.c_str();
+	const char* fragmentSourceData = fragmentSource.c_str();
 	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
+	glShaderSource(fragmentShader, 1, &fragmentSourceData, nullptr);
 	glCompileShader(fragmentShader);
-	if (!shaderCompiled("fragment", fragmentShader)) return false;
+	if (!shaderCompiled("fragment", fragmentShader)) {
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		return 0;
+	}
 
 	// Create and link shader program
-	_backendId = glCreateProgram();
-	glAttachShader(_backendId, vertexShader);
-	glAttachShader(_backendId, fragmentShader);
-	glLinkProgram(_backendId);
-	if (!programLinked(_backendId)) return false;
+	uint32_t program = glCreateProgram();
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
 
 	// Delete shader sources
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
 
-	return true;
+	if (!programLinked(program)) {
+		GLState::deleteProgram(program);
+		return 0;
+	}
+
+	return program;
 }
 
 void Shader::deleteBuffers()
 {
-	if (_backendId) glDeleteProgram(_backendId);
-	_backendId = 0;
+	for (Program& program : programs) {
+		if (program.backendId) GLState::deleteProgram(program.backendId);
+		program.backendId = 0;
+		program.locations.clear();
+	}
+	boundVariant = Variant::DEFAULT;
 }
\ No newline at end of file
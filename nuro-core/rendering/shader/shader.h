@@ -1,12 +1,14 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <glm/glm.hpp>
-#include <unordered_map>
 
 #include <utils/fsutil.h>
 #include <memory/resource.h>
+#include <rendering/shader/uniform_id.h>
 
 class Shader : public Resource
 {
@@ -14,6 +16,14 @@ public:
 	Shader();
 	~Shader();
 
+	// Programs compiled from the same sources, a vertex source provides a variant by checking for its define
+	enum class Variant : uint8_t {
+		DEFAULT, // Sources as written
+		INDIRECT, // Per draw data read from storage buffers by base instance, compiled as GLSL 4.60 with INDIRECT_DRAW defined
+		INSTANCED, // Per instance transforms read from instance attributes, compiled with INSTANCED_DRAW defined
+		COUNT
+	};
+
 	// Default pipe for creating shader
 	ResourcePipe create() {
 		return std::move(pipe()
@@ -24,12 +34,18 @@ public:
 	// Sets the path of the shaders source
 	void setSource(const FS::Path& sourcePath);
 
-	// Binds the shader program
-	void bind() const;
+	// Binds the program of the given variant, uniforms are set on the bound variant afterwards
+	void bind(Variant variant = Variant::DEFAULT) const;
+
+	// Returns if the shader provides a program for the given variant
+	bool hasVariant(Variant variant) const;
 
-	// Returns the shader programs backend id
+	// Returns the default programs backend id
 	uint32_t backendId() const;
 
+	// Assigns the uniform block of the given name to a binding point in all variants providing it
+	void setUniformBlockBinding(const std::string& identifier, uint32_t binding);
+
 	void setBool(const std::string& identifier, bool value);
 	void setInt(const std::string& identifier, int32_t value);
 	void setFloat(const std::string& identifier, float value);
@@ -39,6 +55,16 @@ public:
 	void setMatrix3(const std::string& identifier, glm::mat3 value);
 	void setMatrix4(const std::string& identifier, glm::mat4 value);
 
+	// Setters taking compile time hashed identifiers, eg. setMatrix4(UniformId<"mvpMatrix">, value)
+	void setBool(UniformKey identifier, bool value);
+	void setInt(UniformKey identifier, int32_t value);
+	void setFloat(UniformKey identifier, float value);
+	void setVec2(UniformKey identifier, glm::vec2 value);
+	void setVec3(UniformKey identifier, glm::vec3 value);
+	void setVec4(UniformKey identifier, glm::vec4 value);
+	void setMatrix3(UniformKey identifier, glm::mat3 value);
+	void setMatrix4(UniformKey identifier, glm::mat4 value);
+
 private:
 	struct Data {
 		std::string vertexSource;
@@ -51,14 +77,35 @@ private:
 	// Shader source data
 	Data data;
 
-	// Shader program uniform location cache
-	std::unordered_map<std::string, int32_t> uniforms;
+	// Location of an active uniform by the hash of its name
+	struct UniformLocation {
+		uint32_t hash;
+		int32_t location;
+	};
+
+	struct Program {
+		// Shader program backend id
+		uint32_t backendId = 0;
+
+		// Locations of all active uniforms sorted by hash, built once after linking
+		std::vector<UniformLocation> locations;
+	};
+
+	// Programs of each variant, backend id is zero if the variant isn't provided
+	std::array<Program, static_cast<size_t>(Variant::COUNT)> programs;
 
-	// Shader program backend id
-	uint32_t _backendId;
+	// Variant uniforms are set on
+	mutable Variant boundVariant;
 
 private:
-	int32_t getUniformLocation(const std::string& identifier);
+	// Returns the location of the uniform with the given name hash in the bound variant, -1 if it isn't active
+	int32_t getUniformLocation(uint32_t hash) const;
+
+	// Fills the location table of a linked program by enumerating its active uniforms
+	void buildLocationTable(Program& program);
+
+	// Compiles and links a program from the given sources, returns zero on failure
+	uint32_t compileProgram(const std::string& vertexSource, const std::string& fragmentSource);
 
 	bool shaderCompiled(const char* type, int32_t shader);
 	bool programLinked(int32_t program);
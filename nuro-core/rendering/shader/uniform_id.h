@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Uniform identifiers hashed at compile time, resolved against the location table of a shader program
+namespace UniformHash
+{
+	constexpr uint32_t FNV_OFFSET_BASIS = 2166136261u;
+	constexpr uint32_t FNV_PRIME = 16777619u;
+
+	// Returns the 32 bit FNV-1a hash of the given string
+	constexpr uint32_t fnv1a(std::string_view string)
+	{
+		uint32_t hash = FNV_OFFSET_BASIS;
+		for (char c : string) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	// String literal usable as template argument
+	template<size_t N>
+	struct Literal
+	{
+		char value[N];
+
+		constexpr Literal(const char(&string)[N])
+		{
+			for (size_t i = 0; i < N; i++) value[i] = string[i];
+		}
+	};
+};
+
+// Hashed uniform identifier, keeping its name for diagnostics
+struct UniformKey
+{
+	uint32_t hash;
+	const char* name;
+};
+
+// Uniform identifier hashed at compile time, eg. UniformId<"mvpMatrix">
+template<UniformHash::Literal Name>
+inline constexpr UniformKey UniformId = { UniformHash::fnv1a(std::string_view(Name.value, sizeof(Name.value) - 1)), Name.value };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <random>
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 
 #define M_PI 3.14159265358979323846
@@ -44,7 +45,7 @@ radius(radius)
 
 	// Generate texture
 	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_3D, texture);
+	GLState::bindTexture(GL_TEXTURE_3D, texture);
 	glTexStorage3D(GL_TEXTURE_3D, 1, GL_RGBA32F, nFilterSamples / 2, windowSize, windowSize);
 	glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, nFilterSamples / 2, windowSize, windowSize, GL_RGBA, GL_FLOAT, &data[0]);
 
@@ -53,14 +54,14 @@ radius(radius)
 	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 
 	// Unbind texture
-	glBindTexture(GL_TEXTURE_3D, 0);
+	GLState::bindTexture(GL_TEXTURE_3D, 0);
 }
 
 void ShadowDisk::bind(uint32_t unit)
 {
 	// Bind shadow disk texture to given unit
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_3D, texture);
+	GLState::activeTexture(GL_TEXTURE0 + unit);
+	GLState::bindTexture(GL_TEXTURE_3D, texture);
 }
 
 uint32_t ShadowDisk::getWindowSize()
@@ -5,9 +5,13 @@
 #include <vector>
 #include <stb_image_write.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <transform/transform.h>
+#include <transform/world_matrices.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/model/lod_selection.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/transformation/transformation.h>
 
@@ -16,7 +20,11 @@ resolutionHeight(resolutionHeight),
 texture(0),
 framebuffer(0),
 lightSpace(glm::mat4(1.0f)),
-shadowPassShader(nullptr)
+shadowPassShader(nullptr),
+lodBias(2.0f),
+casterLods(),
+fallbackLod(0),
+instanceBatch()
 {
 }
 
@@ -30,7 +38,7 @@ void ShadowMap::create()
 
 	// Generate texture
 	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	GLState::bindTexture(GL_TEXTURE_2D, texture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, resolutionWidth, resolutionHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 
 	// Set texture parameters
@@ -44,13 +52,13 @@ void ShadowMap::create()
 	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
 
 	// Set framebuffer attachments
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
 	glDrawBuffer(GL_NONE);
 	glReadBuffer(GL_NONE);
 
 	// Unbind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 
 	// Check for forward pass framebuffer error
 	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -58,21 +66,27 @@ void ShadowMap::create()
 	{
 		Console::out::warning("Shadow Map", "Issue while generating framebuffer: " + std::to_string(fboStatus));
 	}
+
+	// Create instance buffer
+	instanceBatch.create();
 }
 
 void ShadowMap::destroy()
 {
 	// Delete texture
-	glDeleteTextures(1, &texture);
+	GLState::deleteTextures(1, &texture);
 	texture = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &framebuffer);
+	GLState::deleteFramebuffers(1, &framebuffer);
 	framebuffer = 0;
 
 	// Reset light space matrix
 	lightSpace = glm::mat4(1.0f);
 
+	// Delete instance buffer
+	instanceBatch.destroy();
+
 	// Reset shader
 	shadowPassShader = nullptr;
 }
@@ -100,8 +114,8 @@ void ShadowMap::castShadows(SpotlightComponent& spotlight, TransformComponent& t
 
 void ShadowMap::bind(uint32_t unit)
 {
-	glActiveTexture(GL_TEXTURE0 + unit);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	GLState::activeTexture(GL_TEXTURE0 + unit);
+	GLState::bindTexture(GL_TEXTURE_2D, texture);
 }
 
 uint32_t ShadowMap::getTexture() const
@@ -129,6 +143,11 @@ const glm::mat4& ShadowMap::getLightSpace() const
 	return lightSpace;
 }
 
+void ShadowMap::setLodBias(float _lodBias)
+{
+	lodBias = _lodBias;
+}
+
 bool ShadowMap::saveAsImage(int32_t width, int32_t height, const std::string& filename)
 {
 	std::vector<float> depthData(width * height);
@@ -162,35 +181,95 @@ void ShadowMap::renderSingular(glm::mat4 view, glm::mat4 projection)
 
 	// Set viewport and bind shadow map framebuffer
 	glViewport(0, 0, resolutionWidth, resolutionHeight);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 	glClear(GL_DEPTH_BUFFER_BIT);
 
 	// Bind shadow pass shader and render each objects depth on shadow map
-	glEnable(GL_DEPTH_TEST);
+	GLState::enable(GL_DEPTH_TEST);
 
 	// Set culling to front face
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_FRONT);
+	GLState::enable(GL_CULL_FACE);
+	GLState::cullFace(GL_FRONT);
+
+	// Casters are instanced if the shader provides the instanced variant
+	bool instanced = shadowPassShader->hasVariant(Shader::Variant::INSTANCED);
 
 	shadowPassShader->bind();
 
-	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent>();
-	for (auto [entity, transform, renderer] : targets.each()) {
-		if (!renderer.mesh) return; 
+	// The render queue keeps repeated meshes next to each other
+	uint32_t currentVao = 0;
+	instanceBatch.clear();
+	for (auto [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+		if (!renderer.mesh) continue;
+
+		// Skip casters outside the light frustum
+		const glm::mat4& model = Transform::model(transform);
+		glm::mat4 lightMvp = lightSpace * model;
+		if (!MeshBounds::intersectsFrustum(renderer.mesh->bounds(), lightMvp)) continue;
+
+		// Select level of detail
+		uint32_t& lod = casterLod(transform);
+		lod = LodSelection::select(*renderer.mesh, lightMvp, lod, lodBias);
+
+		// Collect instance
+		if (instanced) {
+			instanceBatch.add(nullptr, *renderer.mesh, lod, model, glm::mat3(1.0f));
+			continue;
+		}
 
 		// Set shadow pass shader uniforms
-		shadowPassShader->setMatrix4("modelMatrix", transform.model);
-		shadowPassShader->setMatrix4("lightSpaceMatrix", lightSpace);
+		shadowPassShader->setMatrix4(UniformId<"modelMatrix">, model);
+		shadowPassShader->setMatrix4(UniformId<"lightSpaceMatrix">, lightSpace);
+		VertexFormat::setDecodeUniforms(*shadowPassShader, *renderer.mesh);
 
-		// Bind mesh
-		glBindVertexArray(renderer.mesh->vao());
+		// Bind mesh if its vertex array isn't bound already
+		if (renderer.mesh->vao() != currentVao) {
+			GLState::bindVertexArray(renderer.mesh->vao());
+			currentVao = renderer.mesh->vao();
+		}
 
 		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+		LodSelection::draw(*renderer.mesh, lod);
+	}
+
+	if (instanced) {
+		// Upload instance data
+		instanceBatch.upload();
+
+		// Bind instanced shadow pass shader
+		shadowPassShader->bind(Shader::Variant::INSTANCED);
+		shadowPassShader->setMatrix4(UniformId<"lightSpaceMatrix">, lightSpace);
+
+		// Render each run of instances with a single draw
+		for (const InstanceBatch::Run& run : instanceBatch.getRuns()) {
+
+			// Bind mesh if its vertex array isn't bound already
+			if (run.mesh->vao() != currentVao) {
+				GLState::bindVertexArray(run.mesh->vao());
+				currentVao = run.mesh->vao();
+			}
+
+			// Set decode uniforms of the runs mesh
+			VertexFormat::setDecodeUniforms(*shadowPassShader, *run.mesh);
+
+			// Render instances
+			instanceBatch.draw(run);
+		}
 	}
 
 	// Unbind shadow map framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+uint32_t& ShadowMap::casterLod(const TransformComponent& transform)
+{
+	if (transform.slot == WorldMatrices::INVALID_SLOT) {
+		fallbackLod = 0;
+		return fallbackLod;
+	}
+
+	if (transform.slot >= casterLods.size()) casterLods.resize(transform.slot + 1, 0);
+	return casterLods[transform.slot];
 }
 
 glm::mat4 ShadowMap::getView(const glm::vec3& lightPosition, const glm::vec3& lightDirection) const
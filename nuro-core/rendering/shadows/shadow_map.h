@@ -7,6 +7,7 @@
 #include <ecs/ecs_collection.h>
 #include <rendering/shader/shader.h>
 #include <memory/resource_manager.h>
+#include <rendering/passes/instance_batch.h>
 
 class ShadowMap
 {
@@ -43,6 +44,9 @@ public:
 	// Returns the light space matrix of the shadow map
 	const glm::mat4& getLightSpace() const;
 
+	// Sets the level of detail bias of shadow casters, larger biases select coarser levels than the forward pass
+	void setLodBias(float lodBias);
+
 	// Saves the latest render of the shadow map as an image
 	bool saveAsImage(int32_t width, int32_t height, const std::string& filename);
 
@@ -50,6 +54,9 @@ private:
 	// Render onto singular texture
 	void renderSingular(glm::mat4 view, glm::mat4 projection);
 
+	// Returns the level of detail last selected for the given caster by this shadow map
+	uint32_t& casterLod(const TransformComponent& transform);
+
 	// Returns a view matrix for a light
 	glm::mat4 getView(const glm::vec3& lightPosition, const glm::vec3& lightDirection) const;
 
@@ -76,4 +83,14 @@ private:
 
 	// Shadow pass shader
 	ResourceRef<Shader> shadowPassShader;
+
+	// Level of detail bias of shadow casters
+	float lodBias;
+
+	// Levels of detail last selected for shadow casters by world matrix slot, kept per shadow map so views don't share hysteresis
+	std::vector<uint32_t> casterLods;
+	uint32_t fallbackLod;
+
+	// Per instance transforms of instanced casters
+	InstanceBatch instanceBatch;
 };
\ No newline at end of file
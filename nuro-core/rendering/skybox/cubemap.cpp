@@ -1,12 +1,16 @@
 #include "cubemap.h"
 
+#include <cstring>
 #include <stb_image.h>
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
+#include <context/application_context.h>
 
 Cubemap::Cubemap() : source(),
 data(),
+staging(),
 _backendId(0)
 {
 }
@@ -52,6 +56,23 @@ uint32_t Cubemap::backendId() const
 	return _backendId;
 }
 
+ResourceFootprint Cubemap::footprint() const
+{
+	ResourceFootprint footprint;
+	for (const FaceData& face : data) {
+		footprint.cpu += face.data.size();
+		if (_backendId) footprint.gpu += static_cast<size_t>(face.width) * face.height * face.channels;
+	}
+	return footprint;
+}
+
+bool Cubemap::evict()
+{
+	freeIoData();
+	deleteBuffers();
+	return true;
+}
+
 Cubemap::ImageData Cubemap::loadImageData(const FS::Path& sourcePath)
 {
 	stbi_set_flip_vertically_on_load(false);
@@ -167,25 +188,56 @@ bool Cubemap::loadIoData()
 		break;
 	}
 
+	// Stage face data for upload
+	stageFaceData();
+
 	return true;
 }
 
 void Cubemap::freeIoData()
 {
+	// Give up staging memory if cubemap wasn't uploaded
+	ApplicationContext::stagingRing().discard(staging);
+
 	data.clear();
 }
 
+void Cubemap::stageFaceData()
+{
+	// Get total size of all faces
+	size_t size = 0;
+	for (FaceData& face : data) {
+		face.stagingOffset = size;
+		size += face.data.size();
+	}
+
+	// Ring is full, faces will be uploaded directly from their data
+	staging = ApplicationContext::stagingRing().allocate(size);
+	if (!staging.valid()) return;
+
+	// Write face data to staging memory and free it
+	for (FaceData& face : data) {
+		std::memcpy(staging.data + face.stagingOffset, face.data.data(), face.data.size());
+		face.data = std::vector<unsigned char>();
+	}
+}
+
 bool Cubemap::uploadBuffers()
 {
 	// Don't dispatch cubemap if there is no data
 	if (data.empty()) return false;
 
 	glGenTextures(1, &_backendId);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, _backendId);
+	GLState::bindTexture(GL_TEXTURE_CUBE_MAP, _backendId);
+
+	// Source face data from staging memory if staged
+	StagingRing& ring = ApplicationContext::stagingRing();
+	if (staging.valid())
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.backendId());
 
 	for (int32_t i = 0; i < data.size(); i++)
 	{
-		FaceData face = data[i];
+		const FaceData& face = data[i];
 
 		GLenum format = GL_RGB;
 		if (face.channels == 4)
@@ -193,7 +245,14 @@ bool Cubemap::uploadBuffers()
 			format = GL_RGBA;
 		}
 
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_SRGB, face.width, face.height, 0, format, GL_UNSIGNED_BYTE, face.data.data());
+		const void* pixels = staging.valid() ? reinterpret_cast<const void*>(staging.offset + face.stagingOffset) : face.data.data();
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_SRGB, face.width, face.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	}
+
+	// Staging memory is reused once the copies finished
+	if (staging.valid()) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		ring.submit(staging);
 	}
 
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -202,13 +261,13 @@ bool Cubemap::uploadBuffers()
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	GLState::bindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
 	return true;
 }
 
 void Cubemap::deleteBuffers()
 {
-	if (_backendId) glDeleteTextures(1, &_backendId);
+	if (_backendId) GLState::deleteTextures(1, &_backendId);
 	_backendId = 0;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <utils/fsutil.h>
 #include <memory/resource.h>
+#include <memory/staging_ring.h>
 
 class Cubemap : public Resource
 {
@@ -29,7 +30,18 @@ public:
 	// Returns the backend id of the cubemap texture
 	uint32_t backendId() const;
 
+	// Returns the memory held by the cubemap
+	ResourceFootprint footprint() const override;
+
 private:
+	// Frees the cubemaps data until it's reloaded
+	bool evict() override;
+
+	// Recreates the cubemap after it was evicted
+	ResourcePipe reload() override {
+		return create();
+	}
+
 	struct Source {
 		enum class Type {
 			CROSS,
@@ -49,6 +61,9 @@ private:
 		int32_t width = 0;
 		int32_t height = 0;
 		int32_t channels = 0;
+
+		// Offset of the faces data within the cubemaps staging memory
+		size_t stagingOffset = 0;
 	};
 
 	struct ImageData
@@ -85,12 +100,18 @@ private:
 	bool uploadBuffers();
 	void deleteBuffers();
 
+	// Writes the data of all faces into the staging ring
+	void stageFaceData();
+
 	// Cubemap source
 	Source source;
 
 	// Cubemap data
 	std::vector<FaceData> data;
 
+	// Staging memory holding the data of all faces
+	StagingRing::Allocation staging;
+
 	// Backend id of cubemap texture
 	uint32_t _backendId;
 
@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <rendering/skybox/cubemap.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/shader/shader.h>
@@ -91,7 +92,7 @@ void Skybox::create()
 	glGenVertexArrays(1, &vao);
 	glGenBuffers(1, &vbo);
 
-	glBindVertexArray(vao);
+	GLState::bindVertexArray(vao);
 
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices, GL_STATIC_DRAW);
@@ -99,7 +100,7 @@ void Skybox::create()
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0);
 
-	glBindVertexArray(0);
+	GLState::bindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
@@ -109,7 +110,7 @@ void Skybox::render(const glm::mat4& viewMatrix, const glm::mat4& projectionMatr
 	if (!cubemap || !shader) return;
 
 	// Set depth function
-	glDepthFunc(GL_LEQUAL);
+	GLState::depthFunc(GL_LEQUAL);
 
 	// Calculate skybox transformation matrices
 	glm::mat4 adjustedViewMatrix = glm::mat4(glm::mat3(viewMatrix));
@@ -122,15 +123,15 @@ void Skybox::render(const glm::mat4& viewMatrix, const glm::mat4& projectionMatr
 	shader->setFloat("emission", emission);
 
 	// Bind skybox vao
-	glBindVertexArray(vao);
+	GLState::bindVertexArray(vao);
 
 	// Bind cubemap texture
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap->backendId());
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_CUBE_MAP, cubemap->backendId());
 
 	// Draw skybox
 	glDrawArrays(GL_TRIANGLES, 0, 36);
 
 	// Reset depth function
-	glDepthFunc(GL_LESS);
+	GLState::depthFunc(GL_LESS);
 }
\ No newline at end of file
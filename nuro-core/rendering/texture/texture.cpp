@@ -1,13 +1,19 @@
 #include "texture.h"
 
+#include <cstring>
 #include <glad/glad.h>
 #include <stb_image.h>
 
+#include <backend/gl_state.h>
+#include <backend/gl_extensions.h>
 #include <utils/fsutil.h>
 #include <utils/console.h>
 #include <context/application_context.h>
+#include <rendering/texture/texture_array_pool.h>
 
 uint32_t Texture::defaultTextureId = 0;
+uint64_t Texture::defaultTextureHandle = 0;
+uint32_t Texture::lastGeneration = 0;
 
 Texture::Texture() : type(TextureType::EMPTY),
 sourcePath(),
@@ -15,7 +21,10 @@ width(0),
 height(0),
 channels(0),
 data(nullptr),
-_backendId(defaultTextureId)
+staging(),
+_backendId(defaultTextureId),
+_bindlessHandle(0),
+_generation(0)
 {
 }
 
@@ -40,11 +49,70 @@ uint32_t Texture::backendId() const
 	return _backendId;
 }
 
+uint32_t Texture::generation() const
+{
+	return _generation;
+}
+
+uint64_t Texture::bindlessHandle()
+{
+	// Textures falling back to the default texture share its handle, a handle can only be made resident once
+	if (_backendId == defaultTextureId) {
+		if (!defaultTextureHandle && defaultTextureId) {
+			defaultTextureHandle = GLExtensions::getTextureHandle(defaultTextureId);
+			GLExtensions::makeTextureHandleResident(defaultTextureHandle);
+		}
+		return defaultTextureHandle;
+	}
+
+	if (!_bindlessHandle) {
+		_bindlessHandle = GLExtensions::getTextureHandle(_backendId);
+		GLExtensions::makeTextureHandleResident(_bindlessHandle);
+	}
+	return _bindlessHandle;
+}
+
 void Texture::setDefaultTexture(uint32_t textureId)
 {
+	if (textureId == defaultTextureId) return;
+
+	if (defaultTextureHandle) {
+		GLExtensions::makeTextureHandleNonResident(defaultTextureHandle);
+		defaultTextureHandle = 0;
+	}
+
 	defaultTextureId = textureId;
 }
 
+bool Texture::bindless()
+{
+	return GLExtensions::bindlessTexture();
+}
+
+ResourceFootprint Texture::footprint() const
+{
+	ResourceFootprint footprint;
+	size_t size = static_cast<size_t>(width) * height * channels;
+
+	// Image data is only kept on the cpu if it couldn't be staged
+	if (data) footprint.cpu = size;
+
+	// Mipmap chain adds about a third of the base level
+	if (_backendId && _backendId != defaultTextureId) footprint.gpu = size + size / 3;
+
+	// Packed copy within an array texture occupies the same amount again
+	if (footprint.gpu && TextureArrayPool::packed(_backendId)) footprint.gpu *= 2;
+
+	return footprint;
+}
+
+bool Texture::evict()
+{
+	freeIoData();
+	deleteBuffers();
+	return true;
+}
+
 bool Texture::loadIoData()
 {
 	// Load image data
@@ -64,17 +132,30 @@ bool Texture::loadIoData()
 	channels = _channels;
 	data = _data;
 
+	// Write image data to staging memory and free it, keep it for a direct upload if the ring is full
+	size_t size = static_cast<size_t>(width) * height * channels;
+	staging = ApplicationContext::stagingRing().allocate(size);
+	if (staging.valid()) {
+		std::memcpy(staging.data, data, size);
+		stbi_image_free(data);
+		data = nullptr;
+	}
+
 	return true;
 }
 
 void Texture::freeIoData()
 {
+	// Give up staging memory if texture wasn't uploaded
+	ApplicationContext::stagingRing().discard(staging);
+
 	// No data loaded
 	if (!data) 
 		return;
 
 	// Free memory allocated for image data
 	stbi_image_free(data);
+	data = nullptr;
 
 	return;
 }
@@ -82,12 +163,12 @@ void Texture::freeIoData()
 bool Texture::uploadBuffers()
 {
 	// Don't dispatch texture if there is no data
-	if (!data) 
+	if (!data && !staging.valid()) 
 		return false;
 
 	// Generate texture
 	glGenTextures(1, &_backendId);
-	glBindTexture(GL_TEXTURE_2D, _backendId);
+	GLState::bindTexture(GL_TEXTURE_2D, _backendId);
 
 	// Set texture parameters
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -100,7 +181,7 @@ bool Texture::uploadBuffers()
 	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAniso);
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, maxAniso);
 
-	// Get texture backend format from texture type
+	// Get texture backend format from texture type, sized so textures can be packed into array textures
 	GLenum internalFormat;
 	GLenum format;
 	switch (type)
@@ -109,78 +190,99 @@ bool Texture::uploadBuffers()
 	{
 		switch (channels) {
 		case 1:
-			internalFormat = GL_RED;
+			internalFormat = GL_R8;
 			format = GL_RED;
 			break;
 		case 2:
-			internalFormat = GL_RG;
+			internalFormat = GL_RG8;
 			format = GL_RG;
 			break;
 		case 3:
-			internalFormat = GL_RGB;
+			internalFormat = GL_RGB8;
 			format = GL_RGB;
 			break;
 		case 4:
-			internalFormat = GL_RGBA;
+			internalFormat = GL_RGBA8;
 			format = GL_RGBA;
 			break;
 		default:
-			internalFormat = GL_RGB;
+			internalFormat = GL_RGB8;
 			format = GL_RGB;
 			break;
 		}
 		break;
 	}
 	case TextureType::ALBEDO:
-		internalFormat = GL_SRGB;
+		internalFormat = GL_SRGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::ROUGHNESS:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::METALLIC:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::NORMAL:
-		internalFormat = GL_RGB;
+		internalFormat = GL_RGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::OCCLUSION:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::EMISSIVE:
-		internalFormat = GL_RGB;
+		internalFormat = GL_RGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::HEIGHT:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	default:
-		internalFormat = GL_RGB;
+		internalFormat = GL_RGB8;
 		format = GL_RGB;
 		break;
 	}
 
-	// Buffer image data to texture
-	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+	// Buffer image data to texture, sourcing it from staging memory if staged
+	if (staging.valid()) {
+		StagingRing& ring = ApplicationContext::stagingRing();
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.backendId());
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, reinterpret_cast<void*>(staging.offset));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		ring.submit(staging);
+	}
+	else {
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+	}
 
 	// Generate textures mipmap
 	glGenerateMipmap(GL_TEXTURE_2D);
 
+	// Backend ids are reused by the backend, so changes are tracked by generation
+	_generation = ++lastGeneration;
+
 	// Undbind texture
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::bindTexture(GL_TEXTURE_2D, 0);
 
 	return true;
 }
 
 void Texture::deleteBuffers()
 {
-	if (_backendId)
-		glDeleteTextures(1, &_backendId);
+	// Never delete the shared default texture
+	if (_backendId && _backendId != defaultTextureId) {
+		// Handles and packed copies have to be released while the texture still exists
+		if (_bindlessHandle) GLExtensions::makeTextureHandleNonResident(_bindlessHandle);
+		TextureArrayPool::release(_backendId);
+
+		GLState::deleteTextures(1, &_backendId);
+	}
+
+	_bindlessHandle = 0;
 
 	_backendId = defaultTextureId;
+	_generation = ++lastGeneration;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <utils/fsutil.h>
 #include <memory/resource.h>
+#include <memory/staging_ring.h>
 
 enum class TextureType
 {
@@ -40,10 +41,30 @@ public:
 	// Returns the textures backend id
 	uint32_t backendId() const;
 
+	// Returns a stamp that changes whenever the backend texture is recreated or deleted, unique among all textures
+	uint32_t generation() const;
+
+	// Returns the resident bindless handle of the texture, creating it on first use (context thread only)
+	uint64_t bindlessHandle();
+
 	// Sets the given texture backend id to be the default backend id for new textures
 	static void setDefaultTexture(uint32_t textureId);
 
+	// Returns if textures can be accessed through bindless handles (ARB_bindless_texture)
+	static bool bindless();
+
+	// Returns the memory held by the texture
+	ResourceFootprint footprint() const override;
+
 private:
+	// Frees the textures data, falling back to the default texture until it's reloaded
+	bool evict() override;
+
+	// Recreates the texture after it was evicted
+	ResourcePipe reload() override {
+		return create();
+	}
+
 	bool loadIoData();
 	void freeIoData();
 	bool uploadBuffers();
@@ -52,19 +73,34 @@ private:
 	// Default texture fallback
 	static uint32_t defaultTextureId;
 
+	// Bindless handle of the default texture, shared by all textures falling back to it
+	static uint64_t defaultTextureHandle;
+
+	// Last generation handed out to a texture
+	static uint32_t lastGeneration;
+
 	// Texture type
 	TextureType type;
 
 	// Path of texture source
 	FS::Path sourcePath;
 
-	// Dynamic temporary texture data
+	// Dynamic temporary texture data, only kept if it couldn't be staged
 	unsigned char* data;
 
+	// Staging memory holding the texture data
+	StagingRing::Allocation staging;
+
 	uint32_t width;
 	uint32_t height;
 	uint32_t channels;
 
 	// Backend id of texture
 	uint32_t _backendId;
+
+	// Bindless handle of the texture, zero until requested
+	uint64_t _bindlessHandle;
+
+	// Generation of the current backend texture
+	uint32_t _generation;
 };
\ No newline at end of file
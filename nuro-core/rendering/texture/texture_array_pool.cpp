@@ -0,0 +1,193 @@
+#include "texture_array_pool.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <glad/glad.h>
+
+#include <backend/gl_state.h>
+#include <utils/console.h>
+
+namespace TextureArrayPool {
+
+	// Amount of layers a new array texture is created with, grown by doubling once full
+	constexpr int32_t INITIAL_LAYERS = 4;
+
+	struct Array {
+		uint32_t backendId = 0;
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t internalFormat = 0;
+		int32_t levels = 0;
+		int32_t capacity = 0; // Amount of allocated layers
+		int32_t used = 0; // Amount of layers handed out so far, including released ones
+		std::vector<uint32_t> freeLayers; // Released layers
+	};
+
+	Array gArrays[MAX_ARRAYS];
+	uint32_t gNArrays = 0;
+
+	// Layers of packed textures by their backend id
+	std::unordered_map<uint32_t, Layer> gLayers;
+
+	// Set once textures couldn't be packed, to only inform once
+	bool gExhausted = false;
+
+	// Returns the amount of levels of a complete mipmap chain of the given size
+	int32_t _levels(int32_t width, int32_t height)
+	{
+		int32_t levels = 1;
+		for (int32_t size = std::max(width, height); size > 1; size >>= 1) levels++;
+		return levels;
+	}
+
+	// Creates the storage of an array texture with the given amount of layers, filtered like regular textures
+	uint32_t _createStorage(const Array& array, int32_t capacity)
+	{
+		uint32_t backendId = 0;
+		glGenTextures(1, &backendId);
+		GLState::bindTexture(GL_TEXTURE_2D_ARRAY, backendId);
+
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, array.levels, array.internalFormat, array.width, array.height, capacity);
+
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		GLfloat maxAniso = 0.0f;
+		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAniso);
+		glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY, maxAniso);
+
+		GLState::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		return backendId;
+	}
+
+	// Copies the given layers of all levels between textures of the array's size
+	void _copyLayers(const Array& array, uint32_t source, uint32_t sourceTarget, int32_t sourceLayer, uint32_t destination, int32_t destinationLayer, int32_t nLayers)
+	{
+		for (int32_t level = 0; level < array.levels; level++) {
+			int32_t width = std::max(array.width >> level, 1);
+			int32_t height = std::max(array.height >> level, 1);
+			glCopyImageSubData(source, sourceTarget, level, 0, 0, sourceLayer, destination, GL_TEXTURE_2D_ARRAY, level, 0, 0, destinationLayer, width, height, nLayers);
+		}
+	}
+
+	// Doubles the layers of an array texture, returns false if it's at the backends layer limit
+	bool _grow(Array& array)
+	{
+		int32_t maxLayers = 0;
+		glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+		if (array.capacity >= maxLayers) return false;
+
+		// Layers keep their index, so packed textures stay valid
+		int32_t capacity = std::min(array.capacity * 2, maxLayers);
+		uint32_t backendId = _createStorage(array, capacity);
+		_copyLayers(array, array.backendId, GL_TEXTURE_2D_ARRAY, 0, backendId, 0, array.used);
+
+		GLState::deleteTextures(1, &array.backendId);
+		array.backendId = backendId;
+		array.capacity = capacity;
+		return true;
+	}
+
+	// Informs about a texture that couldn't be packed once
+	void _exhausted(const std::string& reason)
+	{
+		if (gExhausted) return;
+		Console::out::info("Texture Array Pool", "Couldn't pack texture, " + reason + ", textures that can't be packed are bound directly");
+		gExhausted = true;
+	}
+
+	Layer acquire(uint32_t texture)
+	{
+		if (!texture) return Layer();
+
+		auto it = gLayers.find(texture);
+		if (it != gLayers.end()) return it->second;
+
+		// Fetch size and format of the textures base level
+		int32_t width = 0, height = 0, internalFormat = 0;
+		glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_HEIGHT, &height);
+		glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+		if (width <= 0 || height <= 0) return Layer();
+
+		// Find the array of the textures size and format, creating it if there is none yet
+		uint32_t index = 0;
+		while (index < gNArrays && (gArrays[index].width != width || gArrays[index].height != height || gArrays[index].internalFormat != internalFormat)) index++;
+		if (index == gNArrays) {
+			if (gNArrays == MAX_ARRAYS) {
+				_exhausted("all array textures are in use by other sizes or formats");
+				return Layer();
+			}
+
+			Array& array = gArrays[gNArrays++];
+			array.width = width;
+			array.height = height;
+			array.internalFormat = internalFormat;
+			array.levels = _levels(width, height);
+			array.capacity = INITIAL_LAYERS;
+			array.backendId = _createStorage(array, array.capacity);
+		}
+		Array& array = gArrays[index];
+
+		// Reuse a released layer or take the next one
+		uint32_t layer = 0;
+		if (!array.freeLayers.empty()) {
+			layer = array.freeLayers.back();
+			array.freeLayers.pop_back();
+		}
+		else {
+			if (array.used == array.capacity && !_grow(array)) {
+				_exhausted("array texture reached the layer limit");
+				return Layer();
+			}
+			layer = static_cast<uint32_t>(array.used++);
+		}
+
+		_copyLayers(array, texture, GL_TEXTURE_2D, 0, array.backendId, static_cast<int32_t>(layer), 1);
+
+		Layer packed;
+		packed.array = index;
+		packed.layer = layer;
+		gLayers[texture] = packed;
+		return packed;
+	}
+
+	void release(uint32_t texture)
+	{
+		auto it = gLayers.find(texture);
+		if (it == gLayers.end()) return;
+
+		gArrays[it->second.array].freeLayers.push_back(it->second.layer);
+		gLayers.erase(it);
+	}
+
+	bool packed(uint32_t texture)
+	{
+		return gLayers.find(texture) != gLayers.end();
+	}
+
+	void destroy()
+	{
+		for (uint32_t i = 0; i < gNArrays; i++) {
+			GLState::deleteTextures(1, &gArrays[i].backendId);
+			gArrays[i] = Array();
+		}
+
+		gNArrays = 0;
+		gLayers.clear();
+		gExhausted = false;
+	}
+
+	void bind(uint32_t firstUnit)
+	{
+		for (uint32_t i = 0; i < gNArrays; i++) {
+			GLState::activeTexture(GL_TEXTURE0 + firstUnit + i);
+			GLState::bindTexture(GL_TEXTURE_2D_ARRAY, gArrays[i].backendId);
+		}
+	}
+
+}
\ No newline at end of file
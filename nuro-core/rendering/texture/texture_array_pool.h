@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// Copies of textures packed into the layers of shared 2D array textures, one array per size and format
+// Lets materials reference textures by array and layer on backends without bindless textures
+namespace TextureArrayPool
+{
+	// Amount of array textures, textures of further sizes or formats can't be packed and have to be bound directly
+	// Kept low so array and direct texture units together stay within the guaranteed 16 fragment texture units
+	constexpr uint32_t MAX_ARRAYS = 6;
+
+	// Location of a packed texture
+	struct Layer
+	{
+		uint32_t array = UINT32_MAX; // Index of the array texture
+		uint32_t layer = 0; // Layer within the array texture
+
+		// Returns if the layer holds a packed texture
+		bool valid() const {
+			return array != UINT32_MAX;
+		}
+	};
+
+	// Returns the layer holding a copy of the given texture, packing it on first use (context thread only)
+	// The texture needs a sized internal format and a complete mipmap chain
+	Layer acquire(uint32_t texture);
+
+	// Releases the layer of the given texture if it's packed, before the texture is deleted (context thread only)
+	void release(uint32_t texture);
+
+	// Returns if the given texture has a packed copy
+	bool packed(uint32_t texture);
+
+	// Deletes all array textures and forgets packed textures, while the context is still alive
+	void destroy();
+
+	// Binds all array textures to consecutive texture units starting at the given unit
+	void bind(uint32_t firstUnit);
+};
\ No newline at end of file
@@ -3,11 +3,15 @@
 #include <glad/glad.h>
 #include <vector>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
+#include <transform/transform.h>
 #include <rendering/shader/shader.h>
 #include <rendering/primitives/global_quad.h>
 #include <rendering/shader/shader_pool.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/model/lod_selection.h>
 #include <ecs/ecs_collection.h>
 
 VelocityBuffer::VelocityBuffer(const Viewport& viewport) : viewport(viewport),
@@ -31,12 +35,12 @@ void VelocityBuffer::create()
 
 	// Generate framebuffer
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Generate output texture
 	// RED CHANNEL = x velocity | GREEN CHANNEL = y velocity | BLUE CHANNEL = view space depth
 	glGenTextures(1, &output);
-	glBindTexture(GL_TEXTURE_2D, output);
+	GLState::bindTexture(GL_TEXTURE_2D, output);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGB, GL_FLOAT, nullptr);
 
 	// Set output texture parameters
@@ -50,7 +54,7 @@ void VelocityBuffer::create()
 
 	// Generate postfiltered output texture
 	glGenTextures(1, &postfilteredOutput);
-	glBindTexture(GL_TEXTURE_2D, postfilteredOutput);
+	GLState::bindTexture(GL_TEXTURE_2D, postfilteredOutput);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGB, GL_FLOAT, nullptr);
 
 	// Set postfiltered output texture parameters
@@ -73,17 +77,17 @@ void VelocityBuffer::create()
 	}
 
 	// Unbind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void VelocityBuffer::destroy()
 {
 	// Delete output texture
-	glDeleteTextures(1, &output);
+	GLState::deleteTextures(1, &output);
 	output = 0;
 
 	// Delete postfiltered output texture
-	glDeleteTextures(1, &postfilteredOutput);
+	GLState::deleteTextures(1, &postfilteredOutput);
 	postfilteredOutput = 0;
 
 	// Delete renderbuffer
@@ -91,7 +95,7 @@ void VelocityBuffer::destroy()
 	rbo = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &fbo);
+	GLState::deleteFramebuffers(1, &fbo);
 	fbo = 0;
 
 	// Remove shaders
@@ -99,13 +103,13 @@ void VelocityBuffer::destroy()
 	postfilterShader = nullptr;
 }
 
-uint32_t VelocityBuffer::render(const glm::mat4& view, const glm::mat4& projection, const PostProcessing::Profile& profile)
+uint32_t VelocityBuffer::render(const glm::mat4& view, const glm::mat4& projection, const PostProcessing::Profile& profile, ViewMatrices& viewMatrices)
 {
 	// Prepare output
 	uint32_t OUTPUT = 0;
 
 	// Render velocity buffer
-	OUTPUT = velocityPass(view, projection);
+	OUTPUT = velocityPass(view, projection, viewMatrices);
 
 	// OUTPUT = postfilteringPass();
 
@@ -113,10 +117,10 @@ uint32_t VelocityBuffer::render(const glm::mat4& view, const glm::mat4& projecti
 	return OUTPUT;
 }
 
-uint32_t VelocityBuffer::velocityPass(const glm::mat4& view, const glm::mat4& projection)
+uint32_t VelocityBuffer::velocityPass(const glm::mat4& view, const glm::mat4& projection, ViewMatrices& viewMatrices)
 {
 	// Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Set render target to output texture
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output, 0);
@@ -126,8 +130,8 @@ uint32_t VelocityBuffer::velocityPass(const glm::mat4& view, const glm::mat4& pr
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::depthFunc(GL_LESS);
 
 	// Bind shader
 	velocityPassShader->bind();
@@ -136,26 +140,31 @@ uint32_t VelocityBuffer::velocityPass(const glm::mat4& view, const glm::mat4& pr
 
 	// Render velocity buffer by performing velocity pass on each object
 	auto targets = ECS::main().view<TransformComponent, MeshRendererComponent, VelocityBlurComponent>();
+	uint32_t currentVao = 0;
 	for (auto [entity, transform, renderer, velocity] : targets.each()) {
 		if (!renderer.mesh) return 0;
 
 		// Set velocity pass shader uniforms
-		velocityPassShader->setMatrix4("modelMatrix", transform.model);
-		velocityPassShader->setMatrix4("previousModelMatrix", velocity.lastModel);
-		velocityPassShader->setFloat("intensity", velocity.intensity);
-
-		// Bind mesh
-		glBindVertexArray(renderer.mesh->vao());
+		velocityPassShader->setMatrix4(UniformId<"modelMatrix">, Transform::model(transform));
+		velocityPassShader->setMatrix4(UniformId<"previousModelMatrix">, velocity.lastModel);
+		velocityPassShader->setFloat(UniformId<"intensity">, velocity.intensity);
+		VertexFormat::setDecodeUniforms(*velocityPassShader, *renderer.mesh);
+
+		// Bind mesh if its vertex array isn't bound already
+		if (renderer.mesh->vao() != currentVao) {
+			GLState::bindVertexArray(renderer.mesh->vao());
+			currentVao = renderer.mesh->vao();
+		}
 		  
-		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->verticeCount(), GL_UNSIGNED_INT, 0);
+		// Render mesh with the level of detail of the forward pass
+		LodSelection::draw(*renderer.mesh, viewMatrices.lod(transform, ViewMatrices::LodPass::FORWARD));
 
 		// Update last model matrix cache
-		velocity.lastModel = transform.model;
+		velocity.lastModel = Transform::model(transform);
 	}
 
 	// Disable depth testing
-	glDisable(GL_DEPTH_TEST);
+	GLState::disable(GL_DEPTH_TEST);
 
 	// Return output
 	return output;
@@ -171,8 +180,8 @@ uint32_t VelocityBuffer::postfilteringPass()
 	postfilterShader->setVec2("resolution", viewport.getResolution());
 
 	// Bind velocity buffer texture
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, output);
+	GLState::activeTexture(GL_TEXTURE0);
+	GLState::bindTexture(GL_TEXTURE_2D, output);
 
 	// Bind and render to quad
 	GlobalQuad::bind();
@@ -6,6 +6,7 @@
 
 #include <viewport/viewport.h>
 #include <memory/resource_manager.h>
+#include <transform/view_matrices.h>
 #include <rendering/postprocessing/post_processing.h>
 
 class Shader;
@@ -18,10 +19,10 @@ public:
 	void create();	// Setup velocity buffer
 	void destroy(); // Delete velocity buffer
 
-	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const PostProcessing::Profile& profile); // Renders the velocity buffer and returns the filtered output
+	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const PostProcessing::Profile& profile, ViewMatrices& viewMatrices); // Renders the velocity buffer with the views levels of detail and returns the filtered output
 
 private:
-	uint32_t velocityPass(const glm::mat4& view, const glm::mat4& projection);	  // Performs velocity passes to render velocity buffer and returns velocity buffer
+	uint32_t velocityPass(const glm::mat4& view, const glm::mat4& projection, ViewMatrices& viewMatrices);	  // Performs velocity passes to render velocity buffer and returns velocity buffer
 	uint32_t postfilteringPass(); // Performs postfiltering pass on rendered velocity buffer and returns postfiltered velocity buffer
 
 private:
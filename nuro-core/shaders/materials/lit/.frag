@@ -1,4 +1,5 @@
-#version 330 core
+#version 460 core
+#extension GL_ARB_bindless_texture : enable
 
 #define PI 3.14159265359
 
@@ -11,6 +12,10 @@
 #define MAX_POINT_LIGHTS 15
 #define MAX_SPOT_LIGHTS 8
 
+#define MAX_TEXTURE_ARRAYS 6
+#define TEXTURE_MAP_COUNT 7
+#define DIRECT_TEXTURE 0xFFFFFFFFu
+
 out vec4 FragColor;
 
 in vec3 v_normal;
@@ -24,108 +29,124 @@ vec2 viewportUv;
 vec2 uv;
 vec3 normal;
 
-struct Configuration {
-    // General parameters
-    float gamma;
-    bool solidMode;
-    vec2 viewportResolution;
-
-    // Shadow parameters
-    bool castShadows;
-    sampler2D shadowMap;
-    float shadowMapResolutionWidth;
-    float shadowMapResolutionHeight;
-
-    sampler3D shadowDisk;
-    float shadowDiskWindowSize;
-    float shadowDiskFilterSize;
-    float shadowDiskRadius;
-
-    // World parameters
-    vec3 cameraPosition;
-
-    // Lighting parameters
-    int numDirectionalLights;
-    int numPointLights;
-    int numSpotLights;
-
-    // SSAO
-    bool enableSSAO;
-    sampler2D ssaoBuffer;
-};
-uniform Configuration configuration;
-
 struct DirectionalLight {
-    float intensity;
     vec3 direction;
+    float intensity;
     vec3 color;
     vec3 position; // boilerplate for directional shadows
 };
-uniform DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
 
 struct PointLight {
     vec3 position;
-    vec3 color;
     float intensity;
+    vec3 color;
     float range;
     float falloff;
 };
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
 
 struct Spotlight {
     vec3 position;
-    vec3 direction;
-    vec3 color;
     float intensity;
+    vec3 direction;
     float range;
+    vec3 color;
     float falloff;
     float innerCos;
     float outerCos;
 };
-uniform Spotlight spotlights[MAX_SPOT_LIGHTS];
 
 struct Fog {
-    int type;
     vec3 color;
-    float data[2];
+    int type;
+    vec2 data;
 };
-uniform Fog fog;
 
+// Per frame data shared by all lit materials
+layout(std140) uniform FrameData {
+    // Lights
+    DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
+    PointLight pointLights[MAX_POINT_LIGHTS];
+    Spotlight spotlights[MAX_SPOT_LIGHTS];
+
+    // Fog
+    Fog fog;
+
+    // Lighting parameters
+    int numDirectionalLights;
+    int numPointLights;
+    int numSpotLights;
+
+    // Shadow parameters
+    float shadowMapResolutionWidth;
+    float shadowMapResolutionHeight;
+    float shadowDiskWindowSize;
+    float shadowDiskFilterSize;
+    float shadowDiskRadius;
+};
+
+// Per view data, shared with the vertex stage
+layout(std140) uniform ViewData {
+    mat4 lightSpaceMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool solidMode;
+    bool castShadows;
+    bool enableSSAO;
+} configuration;
+
+// Per material data, textures are referenced by bindless handle, by texture array and layer or by DIRECT_TEXTURE and texture map
 struct Material {
     vec4 baseColor;
-
     vec2 tiling;
     vec2 offset;
-
-    bool enableAlbedoMap;
-    sampler2D albedoMap;
-
+    vec3 emissionColor;
+    float emissionIntensity;
     float roughness;
-    bool enableRoughnessMap;
-    sampler2D roughnessMap;
-
     float metallic;
+    float normalMapIntensity;
+    float heightMapScale;
+    bool emission;
+    bool enableAlbedoMap;
+    bool enableRoughnessMap;
     bool enableMetallicMap;
-    sampler2D metallicMap;
-
     bool enableNormalMap;
-    sampler2D normalMap;
-    float normalMapIntensity;
-
     bool enableOcclusionMap;
-    sampler2D occlusionMap;
-
-    bool emission;
-    float emissionIntensity;
-    vec3 emissionColor;
     bool enableEmissiveMap;
-    sampler2D emissiveMap;
-
     bool enableHeightMap;
-    sampler2D heightMap;
-    float heightMapScale;
+    uvec2 albedoMap;
+    uvec2 roughnessMap;
+    uvec2 metallicMap;
+    uvec2 normalMap;
+    uvec2 occlusionMap;
+    uvec2 emissiveMap;
+    uvec2 heightMap;
+};
+
+// Material data of all lit materials
+layout(std430, binding = 1) readonly buffer MaterialTable {
+    Material materials[];
 };
-uniform Material material;
+
+#if defined(INDIRECT_DRAW)
+// Material table entry of the current draw
+flat in uint v_materialSlot;
+#else
+// Material table entry of the current material
+uniform int materialIndex;
+#endif
+
+Material material;
+
+// Textures
+uniform sampler2D shadowMap;
+uniform sampler3D shadowDisk;
+uniform sampler2D ssaoBuffer;
+
+#ifndef GL_ARB_bindless_texture
+uniform sampler2DArray materialTextureArrays[MAX_TEXTURE_ARRAYS];
+uniform sampler2D materialTextures[TEXTURE_MAP_COUNT]; // Textures that couldn't be packed, by texture map
+#endif
 
 //
 // HELPERS
@@ -136,6 +157,28 @@ float sqr(float x)
     return x * x;
 }
 
+// sample material texture by its reference
+vec4 sampleMaterialTexture(uvec2 reference, vec2 uv)
+{
+#ifdef GL_ARB_bindless_texture
+    return texture(sampler2D(reference), uv);
+#else
+    if (reference.x == DIRECT_TEXTURE) return texture(materialTextures[reference.y], uv);
+    return texture(materialTextureArrays[reference.x], vec3(uv, float(reference.y)));
+#endif
+}
+
+// get size of material texture by its reference
+ivec2 materialTextureSize(uvec2 reference)
+{
+#ifdef GL_ARB_bindless_texture
+    return textureSize(sampler2D(reference), 0);
+#else
+    if (reference.x == DIRECT_TEXTURE) return textureSize(materialTextures[reference.y], 0);
+    return textureSize(materialTextureArrays[reference.x], 0).xy;
+#endif
+}
+
 //
 // SHADOWING
 //
@@ -168,7 +211,7 @@ float getShadowHard(vec3 lightDirection)
     if (shadowCoords.z > 1.0) return 0.0;
 
     // check if fragment is in shadow
-    float depth = texture(configuration.shadowMap, shadowCoords.xy).r;
+    float depth = texture(shadowMap, shadowCoords.xy).r;
     float bias = getShadowBias(lightDirection);
     float shadow = shadowCoords.z - bias > depth ? 1.0 : 0.0;
 
@@ -192,7 +235,7 @@ float getShadowSoft(vec3 lightDirection)
     ivec3 offsetCoord;
 
     // get fractional part of fragment's screen position (for sampling)
-    vec2 f = mod(gl_FragCoord.xy, vec2(configuration.shadowDiskWindowSize));
+    vec2 f = mod(gl_FragCoord.xy, vec2(shadowDiskWindowSize));
 
     // assign fractional part to y and z components of offset
     offsetCoord.yz = ivec2(f);
@@ -204,11 +247,11 @@ float getShadowSoft(vec3 lightDirection)
     float sum = 0.0;
 
     // calculate number of samples to take based on filter size
-    int samplesDiv2 = int(configuration.shadowDiskFilterSize * configuration.shadowDiskFilterSize / 2.0);
+    int samplesDiv2 = int(shadowDiskFilterSize * shadowDiskFilterSize / 2.0);
 
     // calculate texel size for shadow map based on its dimensions
-    float texelWidth = 1.0 / configuration.shadowMapResolutionWidth;
-    float texelHeight = 1.0 / configuration.shadowMapResolutionHeight;
+    float texelWidth = 1.0 / shadowMapResolutionWidth;
+    float texelHeight = 1.0 / shadowMapResolutionHeight;
 
     // store texel size in a vec2
     vec2 texelSize = vec2(texelWidth, texelHeight);
@@ -222,18 +265,18 @@ float getShadowSoft(vec3 lightDirection)
         offsetCoord.x = i; // set x offset for this sample
 
         // fetch offsets from shadow disk texture, scaled by shadow radius
-        vec4 Offsets = texelFetch(configuration.shadowDisk, offsetCoord, 0) * configuration.shadowDiskRadius;
+        vec4 Offsets = texelFetch(shadowDisk, offsetCoord, 0) * shadowDiskRadius;
 
         // sample shadow map at first offset location
         sc.xy = shadowCoords.xy + Offsets.rg * texelSize;
-        depth = texture(configuration.shadowMap, sc.xy).x;
+        depth = texture(shadowMap, sc.xy).x;
 
         // compare depth to shadow coordinate z value to determine if in shadow
         shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
 
         // sample shadow map at second offset location
         sc.xy = shadowCoords.xy + Offsets.ba * texelSize;
-        depth = texture(configuration.shadowMap, sc.xy).x;
+        depth = texture(shadowMap, sc.xy).x;
 
         // compare depth again
         shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
@@ -249,18 +292,18 @@ float getShadowSoft(vec3 lightDirection)
             offsetCoord.x = i;
 
             // fetch more offsets from shadow disk texture
-            vec4 Offsets = texelFetch(configuration.shadowDisk, offsetCoord, 0) * configuration.shadowDiskRadius;
+            vec4 Offsets = texelFetch(shadowDisk, offsetCoord, 0) * shadowDiskRadius;
 
             // sample shadow map at first offset location
             sc.xy = shadowCoords.xy + Offsets.rg * texelSize;
-            depth = texture(configuration.shadowMap, sc.xy).x;
+            depth = texture(shadowMap, sc.xy).x;
 
             // compare depth to shadow coordinate z value
             shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
 
             // sample at second offset location
             sc.xy = shadowCoords.xy + Offsets.ba * texelSize;
-            depth = texture(configuration.shadowMap, sc.xy).x;
+            depth = texture(shadowMap, sc.xy).x;
 
             // compare depth again
             shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
@@ -425,7 +468,7 @@ vec2 POM_getUv(vec2 uvInput) {
     vec2 uvCurrent = uvInput;
 
     // sample depth at current uv
-    float depthSample = 1.0 - texture(material.heightMap, uvCurrent).r;
+    float depthSample = 1.0 - sampleMaterialTexture(material.heightMap, uvCurrent).r;
 
     // march along view direction, starting from the beginning
     // loop until current layer depth exceeds or equals sampled depth
@@ -437,7 +480,7 @@ vec2 POM_getUv(vec2 uvInput) {
         uvCurrent -= uvDelta;
 
         // resample depth at new uv current
-        depthSample = 1.0 - texture(material.heightMap, uvCurrent).r;
+        depthSample = 1.0 - sampleMaterialTexture(material.heightMap, uvCurrent).r;
 
         // add depth to current layer
         currentLayerDepth += layerDepth;
@@ -446,7 +489,7 @@ vec2 POM_getUv(vec2 uvInput) {
     // calculate occlusion
     vec2 uvPrevious = uvCurrent + uvDelta;
     float depthAfter = depthSample - currentLayerDepth;
-    float depthBefore = 1.0 - texture(material.heightMap, uvPrevious).r - currentLayerDepth + layerDepth;
+    float depthBefore = 1.0 - sampleMaterialTexture(material.heightMap, uvPrevious).r - currentLayerDepth + layerDepth;
     float weight = depthAfter / (depthAfter - depthBefore);
 
     // calculate final uv output
@@ -480,7 +523,7 @@ float POM_sampleShadow(vec3 tangentLightDirection, vec2 uvOffset)
     vec2 uvCurrent = uv + uvOffset;
 
     // sample depth at current uv
-    float depthSample = 1.0 - texture(material.heightMap, uvCurrent).r;
+    float depthSample = 1.0 - sampleMaterialTexture(material.heightMap, uvCurrent).r;
     
     // calculate layer depth
     float layerDepth = 1.0 / numLayers;
@@ -497,7 +540,7 @@ float POM_sampleShadow(vec3 tangentLightDirection, vec2 uvOffset)
     while (currentLayerDepth <= depthSample && currentLayerDepth > 0.0)
     {
         uvCurrent += uvDelta;
-        depthSample = 1.0 - texture(material.heightMap, uvCurrent).r;
+        depthSample = 1.0 - sampleMaterialTexture(material.heightMap, uvCurrent).r;
         currentLayerDepth -= layerDepth;
     }
 
@@ -512,7 +555,7 @@ float POM_sampleShadow(vec3 tangentLightDirection, vec2 uvOffset)
 float POM_multisampleShadowAverage(vec3 tangentLightDirection)
 {
     // get texel size
-    vec2 texelSize = 1.0 / textureSize(material.heightMap, 0);
+    vec2 texelSize = 1.0 / materialTextureSize(material.heightMap);
 
     // calculate square kernel
     int sampleCount = 9;
@@ -587,7 +630,7 @@ vec3 getNormal() {
     // normal mapping enabled
 
     // sample normal map
-    vec3 N = texture(material.normalMap, uv).rgb;
+    vec3 N = sampleMaterialTexture(material.normalMap, uv).rgb;
 
     // normalize sampled normal
     N = N * 2.0 - vec3(1.0);
@@ -610,7 +653,7 @@ vec3 getAlbedo()
 
     // sample albedo map if enabled
     if (material.enableAlbedoMap) {
-        vec3 albedoSample = texture(material.albedoMap, uv).rgb;
+        vec3 albedoSample = sampleMaterialTexture(material.albedoMap, uv).rgb;
         albedo = pow(albedoSample, vec3(configuration.gamma));
     }
 
@@ -629,7 +672,7 @@ float getRoughness()
 
     // roughness map enabled, sample roughness by roughness map
     if (material.enableRoughnessMap) {
-        roughness = texture(material.roughnessMap, uv).r;
+        roughness = sampleMaterialTexture(material.roughnessMap, uv).r;
         // no roughness map, set to materials roughness property
     } else {
         roughness = material.roughness;
@@ -647,7 +690,7 @@ float getMetallic()
 
     // metallic map enabled, sample metallic by metallic map
     if (material.enableMetallicMap) {
-        metallic = texture(material.metallicMap, uv).r;
+        metallic = sampleMaterialTexture(material.metallicMap, uv).r;
         // no metallic map, set to materials metallic property
     } else {
         metallic = material.metallic;
@@ -665,7 +708,7 @@ float getOcclusionMapSample()
 
     // occlusion map enabled, sample by occlusion map
     if (material.enableOcclusionMap) {
-        occlusionMapSample = texture(material.occlusionMap, uv).r;
+        occlusionMapSample = sampleMaterialTexture(material.occlusionMap, uv).r;
     }
 
     // return occlusion map sample
@@ -679,7 +722,7 @@ float getSSAO() {
 
     // ssao enabled, sample by ssao buffer
     if (configuration.enableSSAO) {
-        ssao = texture(configuration.ssaoBuffer, viewportUv).r;
+        ssao = texture(ssaoBuffer, viewportUv).r;
     }
 
     // return ssao sample
@@ -698,7 +741,7 @@ vec3 getEmission() {
 
     // emissive map enabled, tint emission by emissive map sample
     if (material.enableEmissiveMap) {
-        emission *= texture(material.emissiveMap, uv).rgb;
+        emission *= sampleMaterialTexture(material.emissiveMap, uv).rgb;
     }
 
     // return emission
@@ -782,7 +825,7 @@ vec4 shadePBR() {
         // DIRECTIONAL LIGHTS
         //
 
-        for (int i = 0; i < configuration.numDirectionalLights; i++)
+        for (int i = 0; i < numDirectionalLights; i++)
         {
             DirectionalLight directionalLight = directionalLights[i];
 
@@ -816,7 +859,7 @@ vec4 shadePBR() {
         // POINT LIGHTS
         //
 
-        for (int i = 0; i < configuration.numPointLights; i++) {
+        for (int i = 0; i < numPointLights; i++) {
             PointLight pointLight = pointLights[i];
 
             float distance = length(pointLight.position - v_fragmentWorldPosition);
@@ -848,7 +891,7 @@ vec4 shadePBR() {
         // SPOT LIGHTS
         //
 
-        for (int i = 0; i < configuration.numSpotLights; i++) {
+        for (int i = 0; i < numSpotLights; i++) {
             Spotlight spotlight = spotlights[i];
 
             float distance = length(spotlight.position - v_fragmentWorldPosition);
@@ -920,7 +963,7 @@ vec4 shadeSolid()
     // static directional light
     vec3 direction = vec3(-0.5, -0.5, 1.0);
 
-    for (int i = 0; i < configuration.numDirectionalLights; i++)
+    for (int i = 0; i < numDirectionalLights; i++)
     {
         DirectionalLight directionalLight = directionalLights[i];
 
@@ -935,7 +978,7 @@ vec4 shadeSolid()
 
     vec3 albedo = vec3(1.0);
     if (material.enableAlbedoMap) {
-        albedo = texture(material.albedoMap, uv).rgb;
+        albedo = sampleMaterialTexture(material.albedoMap, uv).rgb;
     }
     albedo *= vec3(material.baseColor);
 
@@ -987,7 +1030,7 @@ vec4 shadeDepth() {
 vec4 shadeShadowMap() {
     vec3 projectionCoordinates = v_fragmentLightSpacePosition.xyz / v_fragmentLightSpacePosition.w;
     projectionCoordinates = projectionCoordinates * 0.5 + 0.5;
-    float depth = texture(configuration.shadowMap, projectionCoordinates.xy).r;
+    float depth = texture(shadowMap, projectionCoordinates.xy).r;
     return vec4(vec3(depth), 1.0);
 }
 vec4 shadeUv(){
@@ -1009,6 +1052,12 @@ vec4 shadeTangentSpace() {
 
 void main()
 {
+#if defined(INDIRECT_DRAW)
+    material = materials[v_materialSlot];
+#else
+    material = materials[materialIndex];
+#endif
+
     viewportUv = gl_FragCoord.xy / vec2(configuration.viewportResolution.x, configuration.viewportResolution.y);
     uv = getUv();
     normal = getNormal();
@@ -1,15 +1,89 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec4 position_in;
 layout(location = 1) in vec3 normal_in;
 layout(location = 2) in vec2 uv_in;
 layout(location = 3) in vec3 tangent_in;
 layout(location = 4) in vec3 bitangent_in;
 
+#if defined(INDIRECT_DRAW)
+struct DrawData {
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+    vec4 positionOrigin;
+    vec4 positionExtent;
+    uvec4 info; // x: material table slot, y: packed vertices
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+uniform mat4 viewProjectionMatrix;
+
+// Material table entry of the draw, draws of different materials share one multi draw
+flat out uint v_materialSlot;
+
+mat4 mvpMatrix;
+mat4 modelMatrix;
+mat3 normalMatrix;
+
+bool packedVertices;
+vec3 positionOrigin;
+vec3 positionExtent;
+
+void loadDrawData() {
+    DrawData draw = draws[gl_BaseInstance + gl_InstanceID];
+    modelMatrix = draw.modelMatrix;
+    normalMatrix = mat3(draw.normalMatrix);
+    mvpMatrix = viewProjectionMatrix * modelMatrix;
+    packedVertices = draw.info.y != 0u;
+    positionOrigin = draw.positionOrigin.xyz;
+    positionExtent = draw.positionExtent.xyz;
+    v_materialSlot = draw.info.x;
+}
+#elif defined(INSTANCED_DRAW)
+layout(location = 5) in mat4 instanceModelMatrix_in;
+layout(location = 9) in mat3 instanceNormalMatrix_in;
+
+uniform mat4 viewProjectionMatrix;
+
+mat4 mvpMatrix;
+mat4 modelMatrix;
+mat3 normalMatrix;
+
+uniform bool packedVertices;
+uniform vec3 positionOrigin;
+uniform vec3 positionExtent;
+
+void loadDrawData() {
+    modelMatrix = instanceModelMatrix_in;
+    normalMatrix = instanceNormalMatrix_in;
+    mvpMatrix = viewProjectionMatrix * modelMatrix;
+}
+#else
 uniform mat4 mvpMatrix;
 uniform mat4 modelMatrix;
 uniform mat3 normalMatrix;
-uniform mat4 lightSpaceMatrix;
+
+uniform bool packedVertices;
+uniform vec3 positionOrigin;
+uniform vec3 positionExtent;
+
+void loadDrawData() {
+}
+#endif
+
+// Per view data, shared with the fragment stage
+layout(std140) uniform ViewData {
+    mat4 lightSpaceMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool solidMode;
+    bool castShadows;
+    bool enableSSAO;
+} view;
 
 out vec3 v_normal;
 out vec2 v_uv;
@@ -18,27 +92,53 @@ out mat3 v_tbnTransposed;
 out vec3 v_fragmentWorldPosition;
 out vec4 v_fragmentLightSpacePosition;
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+vec3 getVertexPosition() {
+    return packedVertices ? positionOrigin + position_in.xyz * positionExtent : position_in.xyz;
+}
+
+vec3 getVertexNormal() {
+    return packedVertices ? octDecode(normal_in.xy) : normal_in;
+}
+
+vec3 getVertexTangent() {
+    return packedVertices ? octDecode(tangent_in.xy) : tangent_in;
+}
+
+vec3 getVertexBitangent() {
+    if (!packedVertices) return bitangent_in;
+    return cross(getVertexNormal(), getVertexTangent()) * (position_in.w > 0.5 ? 1.0 : -1.0);
+}
+
 vec3 getNormal() {
-    return normalize(normalMatrix * normal_in);
+    return normalize(normalMatrix * getVertexNormal());
 }
 
 mat3 getTBNMatrix() {
-    vec3 t = normalize(normalMatrix * tangent_in);
-    vec3 b = normalize(normalMatrix * bitangent_in);
+    vec3 t = normalize(normalMatrix * getVertexTangent());
+    vec3 b = normalize(normalMatrix * getVertexBitangent());
     vec3 n = v_normal;
     return mat3(t, b, n);
 }
 
 vec3 getFragmentWorldPosition() {
-    return vec3(modelMatrix * vec4(position_in, 1.0));
+    return vec3(modelMatrix * vec4(getVertexPosition(), 1.0));
 }
 
 vec4 getFragmentLightSpacePosition() {
-    return lightSpaceMatrix * vec4(v_fragmentWorldPosition, 1.0);
+    return view.lightSpaceMatrix * vec4(v_fragmentWorldPosition, 1.0);
 }
 
 void main()
 {
+    loadDrawData();
+
     v_normal = getNormal();
     v_uv = uv_in;
     v_tbn = getTBNMatrix();
@@ -46,5 +146,5 @@ void main()
     v_fragmentWorldPosition = getFragmentWorldPosition();
     v_fragmentLightSpacePosition = getFragmentLightSpacePosition();
 
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = mvpMatrix * vec4(getVertexPosition(), 1.0);
 }
\ No newline at end of file
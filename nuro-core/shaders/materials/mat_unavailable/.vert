@@ -1,10 +1,53 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec4 position_in;
 
+#ifdef INDIRECT_DRAW
+struct DrawData {
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+    vec4 positionOrigin;
+    vec4 positionExtent;
+    uvec4 info; // x: material table slot, y: packed vertices
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+uniform mat4 viewProjectionMatrix;
+
+mat4 mvpMatrix;
+
+bool packedVertices;
+vec3 positionOrigin;
+vec3 positionExtent;
+
+void loadDrawData() {
+    DrawData draw = draws[gl_BaseInstance + gl_InstanceID];
+    mvpMatrix = viewProjectionMatrix * draw.modelMatrix;
+    packedVertices = draw.info.y != 0u;
+    positionOrigin = draw.positionOrigin.xyz;
+    positionExtent = draw.positionExtent.xyz;
+}
+#else
 uniform mat4 mvpMatrix;
 
+uniform bool packedVertices;
+uniform vec3 positionOrigin;
+uniform vec3 positionExtent;
+
+void loadDrawData() {
+}
+#endif
+
+vec3 getVertexPosition() {
+    return packedVertices ? positionOrigin + position_in.xyz * positionExtent : position_in.xyz;
+}
+
 void main()
 {
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    loadDrawData();
+
+    gl_Position = mvpMatrix * vec4(getVertexPosition(), 1.0);
 }
@@ -1,19 +1,62 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec4 position_in;
 layout(location = 1) in vec3 normal_in;
 
+#ifdef INSTANCED_DRAW
+layout(location = 5) in mat4 instanceModelMatrix_in;
+layout(location = 9) in mat3 instanceNormalMatrix_in;
+
+uniform mat4 viewProjectionMatrix;
+uniform mat3 viewNormalMatrix;
+
+mat4 getMvpMatrix() {
+    return viewProjectionMatrix * instanceModelMatrix_in;
+}
+
+mat3 getNormalMatrix() {
+    return viewNormalMatrix * instanceNormalMatrix_in;
+}
+#else
 uniform mat4 mvpMatrix;
 uniform mat3 viewNormalMatrix;
 
+mat4 getMvpMatrix() {
+    return mvpMatrix;
+}
+
+mat3 getNormalMatrix() {
+    return viewNormalMatrix;
+}
+#endif
+
+uniform bool packedVertices;
+uniform vec3 positionOrigin;
+uniform vec3 positionExtent;
+
 out vec3 v_viewNormal;
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+vec3 getVertexPosition() {
+    return packedVertices ? positionOrigin + position_in.xyz * positionExtent : position_in.xyz;
+}
+
+vec3 getVertexNormal() {
+    return packedVertices ? octDecode(normal_in.xy) : normal_in;
+}
+
 vec3 getViewNormal() {
-    return normalize(viewNormalMatrix * normal_in);
+    return normalize(getNormalMatrix() * getVertexNormal());
 }
 
 void main()
 {
     v_viewNormal = getViewNormal();
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = getMvpMatrix() * vec4(getVertexPosition(), 1.0);
 }
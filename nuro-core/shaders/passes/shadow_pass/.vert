@@ -1,11 +1,32 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec4 position_in;
 
 uniform mat4 lightSpaceMatrix;
+
+#ifdef INSTANCED_DRAW
+layout(location = 5) in mat4 instanceModelMatrix_in;
+
+mat4 getModelMatrix() {
+    return instanceModelMatrix_in;
+}
+#else
 uniform mat4 modelMatrix;
 
+mat4 getModelMatrix() {
+    return modelMatrix;
+}
+#endif
+
+uniform bool packedVertices;
+uniform vec3 positionOrigin;
+uniform vec3 positionExtent;
+
+vec3 getVertexPosition() {
+    return packedVertices ? positionOrigin + position_in.xyz * positionExtent : position_in.xyz;
+}
+
 void main()
 {
-    gl_Position = lightSpaceMatrix * modelMatrix * vec4(position_in, 1.0);
+    gl_Position = lightSpaceMatrix * getModelMatrix() * vec4(getVertexPosition(), 1.0);
 }
@@ -1,20 +1,29 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec4 position_in;
 
 uniform mat4 modelMatrix;
 uniform mat4 previousModelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
+uniform bool packedVertices;
+uniform vec3 positionOrigin;
+uniform vec3 positionExtent;
+
 out vec4 v_viewPosition;
 out vec4 v_position;
 out vec4 v_previousPosition;
 
+vec3 getVertexPosition() {
+    return packedVertices ? positionOrigin + position_in.xyz * positionExtent : position_in.xyz;
+}
+
 void main()
 {
-    vec4 worldPosition = modelMatrix * vec4(position_in, 1.0);
-    vec4 previousWorldPosition = previousModelMatrix * vec4(position_in, 1.0);
+    vec3 position = getVertexPosition();
+    vec4 worldPosition = modelMatrix * vec4(position, 1.0);
+    vec4 previousWorldPosition = previousModelMatrix * vec4(position, 1.0);
 
     v_viewPosition = viewMatrix * worldPosition;
     v_position = projectionMatrix * v_viewPosition;
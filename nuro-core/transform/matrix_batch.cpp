@@ -0,0 +1,70 @@
+#include "matrix_batch.h"
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MATRIX_BATCH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace MatrixBatch {
+
+#ifdef MATRIX_BATCH_SSE
+
+	// Multiplies the column major matrix given by its columns a0-a3 with matrix b into out
+	static inline void _multiplyColumns(__m128 a0, __m128 a1, __m128 a2, __m128 a3, const float* b, float* out)
+	{
+		for (int32_t column = 0; column < 4; column++) {
+			const float* bColumn = b + column * 4;
+
+			__m128 result = _mm_mul_ps(a0, _mm_set1_ps(bColumn[0]));
+			result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(bColumn[1])));
+			result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(bColumn[2])));
+			result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(bColumn[3])));
+
+			_mm_storeu_ps(out + column * 4, result);
+		}
+	}
+
+	void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+	{
+		const float* aData = &a[0][0];
+		_multiplyColumns(
+			_mm_loadu_ps(aData),
+			_mm_loadu_ps(aData + 4),
+			_mm_loadu_ps(aData + 8),
+			_mm_loadu_ps(aData + 12),
+			&b[0][0], &out[0][0]);
+	}
+
+	void multiply(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count)
+	{
+		// Keep left hand side in registers for the whole batch
+		const float* lhsData = &lhs[0][0];
+		__m128 a0 = _mm_loadu_ps(lhsData);
+		__m128 a1 = _mm_loadu_ps(lhsData + 4);
+		__m128 a2 = _mm_loadu_ps(lhsData + 8);
+		__m128 a3 = _mm_loadu_ps(lhsData + 12);
+
+		for (size_t i = 0; i < count; i++) {
+			_multiplyColumns(a0, a1, a2, a3, &rhs[i][0][0], &out[i][0][0]);
+		}
+	}
+
+#else
+
+	void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+	{
+		out = a * b;
+	}
+
+	void multiply(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++) {
+			out[i] = lhs * rhs[i];
+		}
+	}
+
+#endif
+
+}
\ No newline at end of file
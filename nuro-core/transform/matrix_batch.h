@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace MatrixBatch
+{
+
+	// Multiplies matrix a with matrix b into out (out may alias a or b)
+	void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out);
+
+	// Multiplies the given left hand side matrix with each of the count right hand side matrices into out (out may alias rhs)
+	void multiply(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count);
+
+};
\ No newline at end of file
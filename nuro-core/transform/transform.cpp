@@ -4,6 +4,8 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include <ecs/ecs.h>
+#include <transform/matrix_batch.h>
+#include <transform/world_matrices.h>
 #include <rendering/transformation/transformation.h>
 
 #include <utils/console.h>
@@ -25,20 +27,41 @@ namespace Transform {
 		return ECS::main().get<TransformComponent>(transform.parent);
 	}
 
-	void evaluate(TransformComponent& transform)
+	const glm::mat4& model(const TransformComponent& transform)
 	{
-		transform.model = Transformation::model(transform.position, transform.rotation, transform.scale);
-		transform.normal = Transformation::normal(transform.model);
+		static const glm::mat4 identity = glm::mat4(1.0f);
+		if (transform.slot == WorldMatrices::INVALID_SLOT) return identity;
+
+		return ECS::main().getWorldMatrices().model(transform.slot);
 	}
 
-	void evaluate(TransformComponent& transform, TransformComponent& parent) {
-		transform.model = parent.model * Transformation::model(transform.position, transform.rotation, transform.scale);
-		transform.normal = Transformation::normal(transform.model);	
+	const glm::mat3& normal(const TransformComponent& transform)
+	{
+		static const glm::mat3 identity = glm::mat3(1.0f);
+		if (transform.slot == WorldMatrices::INVALID_SLOT) return identity;
+
+		return ECS::main().getWorldMatrices().normal(transform.slot);
 	}
 
-	void updateMvp(TransformComponent& transform, const glm::mat4& viewProjection)
+	void evaluate(TransformComponent& transform)
 	{
-		transform.mvp = viewProjection * transform.model;
+		if (transform.slot == WorldMatrices::INVALID_SLOT) return;
+
+		WorldMatrices& matrices = ECS::main().getWorldMatrices();
+		glm::mat4& model = matrices.model(transform.slot);
+		model = Transformation::model(transform.position, transform.rotation, transform.scale);
+		matrices.normal(transform.slot) = glm::mat3(Transformation::normal(model));
+		matrices.touch(transform.slot);
+	}
+
+	void evaluate(TransformComponent& transform, TransformComponent& parent) {
+		if (transform.slot == WorldMatrices::INVALID_SLOT) return;
+
+		WorldMatrices& matrices = ECS::main().getWorldMatrices();
+		glm::mat4& model = matrices.model(transform.slot);
+		MatrixBatch::multiply(Transform::model(parent), Transformation::model(transform.position, transform.rotation, transform.scale), model);
+		matrices.normal(transform.slot) = glm::mat3(Transformation::normal(model));
+		matrices.touch(transform.slot);
 	}
 
 	void _tmp_updateModel(TransformComponent& transform)
@@ -51,6 +74,7 @@ namespace Transform {
 		else {
 			evaluate(transform);
 		}
+		ECS::main().getWorldMatrices().commit();
 	}
 
 	void setPosition(TransformComponent& transform, const glm::vec3& position, Space space)
@@ -66,7 +90,7 @@ namespace Transform {
 			_tmp_updateModel(parent); // tmp; inefficient!
 
 			glm::vec4 localBackendPos = glm::vec4(Transformation::swap(position), 1.0f);
-			glm::vec3 worldBackendPos = glm::vec3(glm::inverse(parent.model) * localBackendPos);
+			glm::vec3 worldBackendPos = glm::vec3(glm::inverse(model(parent)) * localBackendPos);
 
 			transform.position = Transformation::swap(worldBackendPos);
 		}
@@ -128,7 +152,7 @@ namespace Transform {
 
 			_tmp_updateModel(parent); // tmp; inefficient!
 
-			glm::mat4 parentModel = parent.model;
+			glm::mat4 parentModel = model(parent);
 			glm::vec3 parentWorldScale = glm::vec3(
 				glm::length(glm::vec3(parentModel[0])),
 				glm::length(glm::vec3(parentModel[1])),
@@ -149,7 +173,7 @@ namespace Transform {
 		}
 		// World space with parent
 		else {
-			return Transformation::swap(glm::vec3(transform.model[3]));
+			return Transformation::swap(glm::vec3(model(transform)[3]));
 		}
 	}
 
@@ -161,7 +185,7 @@ namespace Transform {
 		}
 		// World space with parent
 		else {
-			glm::mat3 rotationMatrix(transform.model);
+			glm::mat3 rotationMatrix(model(transform));
 
 			glm::vec3 col0 = glm::normalize(glm::vec3(rotationMatrix[0]));
 			glm::vec3 col1 = glm::normalize(glm::vec3(rotationMatrix[1]));
@@ -196,9 +220,9 @@ namespace Transform {
 		// World space with parent
 		else {
 			return glm::vec3(
-				glm::length(glm::vec3(transform.model[0])),
-				glm::length(glm::vec3(transform.model[1])),
-				glm::length(glm::vec3(transform.model[2]))
+				glm::length(glm::vec3(model(transform)[0])),
+				glm::length(glm::vec3(model(transform)[1])),
+				glm::length(glm::vec3(model(transform)[2]))
 			);
 		}
 	}
@@ -26,15 +26,18 @@ namespace Transform
 	// Returns a transforms parent; make sure transform has parent before using!
 	TransformComponent& fetchParent(TransformComponent& transform);
 
+	// Returns a transforms model matrix in world space
+	const glm::mat4& model(const TransformComponent& transform);
+
+	// Returns a transforms normal matrix in world space
+	const glm::mat3& normal(const TransformComponent& transform);
+
 	// Updates a transforms model matrix
 	void evaluate(TransformComponent& transform);
 
 	// Updates a transforms model matrix relative to the given parent
 	void evaluate(TransformComponent& transform, TransformComponent& parent);
 
-	// Updates a transforms model-view-projection matrix
-	void updateMvp(TransformComponent& transform, const glm::mat4& viewProjection);
-
 	//
 	// TRANSFORMATION
 	//
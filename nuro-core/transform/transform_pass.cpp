@@ -5,39 +5,108 @@
 #include <ecs/ecs_collection.h>
 #include <transform/transform.h>
 #include <diagnostics/profiler.h>
+#include <context/application_context.h>
 
-void TransformPass::perform(glm::mat4 viewProjection)
+// Amount of transforms evaluated per job
+static constexpr size_t EVALUATION_BATCH_SIZE = 256;
+
+TransformPass::TransformPass() : parallel(true),
+levels()
+{
+}
+
+void TransformPass::perform()
 {
-	// Evaluate transforms
-	for (auto [entity, transform] : ECS::main().view<TransformComponent>().each()) {
-		// Evaluate root node
-		if (Transform::isRoot(transform)) evaluate(transform);
+	ECS& ecs = ECS::main();
+
+	// Bucket modified transforms by their depth, static transforms never enter this loop
+	for (auto& level : levels) level.clear();
+
+	for (auto [entity, transform] : ecs.view<TransformComponent>(entt::exclude<StaticComponent>).each()) {
+		if (transform.modified) enqueue(transform);
+	}
+
+	// Evaluate transforms which were marked static since the last pass once
+	std::vector<Entity>& staticUpdates = ecs.getStaticUpdates();
+	std::sort(staticUpdates.begin(), staticUpdates.end());
+	staticUpdates.erase(std::unique(staticUpdates.begin(), staticUpdates.end()), staticUpdates.end());
+	for (Entity entity : staticUpdates) {
+		// Entity might have been destroyed or turned dynamic again in the meantime
+		if (!ecs.verify(entity) || !ecs.has<TransformComponent>(entity) || !ecs.has<StaticComponent>(entity)) continue;
 
-		// Update transforms model-view-projection
-		Transform::updateMvp(transform, viewProjection);
+		TransformComponent& transform = ecs.get<TransformComponent>(entity);
+		if (transform.modified) enqueue(transform);
 	}
+	staticUpdates.clear();
+
+	// Evaluate modified subtrees
+	bool evaluated = std::any_of(levels.begin(), levels.end(), [](const std::vector<TransformComponent*>& level) { return !level.empty(); });
+	evaluateHierarchy();
+
+	// Let consumers of all world matrices know they changed
+	if (evaluated) ecs.getWorldMatrices().commit();
 }
 
-void TransformPass::evaluate(TransformComponent& transform)
+void TransformPass::setParallel(bool value)
 {
-	if(transform.modified) Transform::evaluate(transform);
+	parallel = value;
+}
 
-	for (Entity child : transform.children) {
-		evaluate(ECS::main().get<TransformComponent>(child), transform, transform.modified);
-	}
+bool TransformPass::getParallel() const
+{
+	return parallel;
+}
 
-	transform.modified = false;
+void TransformPass::dispatch(size_t count, size_t batchSize, const JobSystem::RangeJob& job)
+{
+	if (parallel) {
+		ApplicationContext::jobSystem().parallelFor(count, batchSize, job);
+	}
+	else {
+		job(0, count);
+	}
 }
 
-void TransformPass::evaluate(TransformComponent& transform, TransformComponent& parent, bool propagateModified)
+void TransformPass::evaluateHierarchy()
 {
-	if (propagateModified) transform.modified = true;
+	// Levels may grow while modifications are propagated to children
+	for (size_t depth = 0; depth < levels.size(); depth++) {
+		std::vector<TransformComponent*>& level = levels[depth];
+		if (level.empty()) continue;
+
+		// Evaluate level, parents of all transforms were evaluated with the previous level
+		dispatch(level.size(), EVALUATION_BATCH_SIZE, [&level](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				TransformComponent& transform = *level[i];
 
-	if(transform.modified) Transform::evaluate(transform, parent);
+				if (Transform::isRoot(transform)) Transform::evaluate(transform);
+				else Transform::evaluate(transform, Transform::fetchParent(transform));
 
-	for (Entity child : transform.children) {
-		evaluate(ECS::main().get<TransformComponent>(child), transform, transform.modified);
+				transform.modified = false;
+			}
+			});
+
+		// Make sure next level exists before propagating, resizing invalidates level references
+		bool hasChildren = std::any_of(level.begin(), level.end(), [](TransformComponent* transform) { return !transform->children.empty(); });
+		if (!hasChildren) continue;
+		if (depth + 1 >= levels.size()) levels.resize(depth + 2);
+
+		// Propagate modification to children, skipping children that are pending already
+		std::vector<TransformComponent*>& nextLevel = levels[depth + 1];
+		for (TransformComponent* transform : levels[depth]) {
+			for (Entity child : transform->children) {
+				TransformComponent& childTransform = ECS::main().get<TransformComponent>(child);
+				if (childTransform.modified) continue;
+
+				childTransform.modified = true;
+				nextLevel.push_back(&childTransform);
+			}
+		}
 	}
+}
 
-	transform.modified = false; 
+void TransformPass::enqueue(TransformComponent& transform)
+{
+	if (transform.depth >= levels.size()) levels.resize(transform.depth + 1);
+	levels[transform.depth].push_back(&transform);
 }
\ No newline at end of file
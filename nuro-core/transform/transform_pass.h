@@ -3,15 +3,36 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include <utils/job_system.h>
 #include <transform/transform.h>
 
 class TransformPass
 {
 public:
-	// Performs the preprocessing needed before rendering for all entities
-	void perform(glm::mat4 viewProjection);
+	TransformPass();
+
+	// Evaluates the world matrices of all modified transforms, performed once per frame before any view is rendered
+	void perform();
+
+	// Sets if transforms are evaluated in parallel using the job system
+	void setParallel(bool value);
+
+	// Returns if transforms are evaluated in parallel
+	bool getParallel() const;
 
 private:
-	void evaluate(TransformComponent& transform);
-	void evaluate(TransformComponent& transform, TransformComponent& parent, bool propagateModified);
+	// Evaluates transforms in parallel if set
+	bool parallel;
+
+	// Modified transforms awaiting evaluation, bucketed by their depth in hierarchy
+	std::vector<std::vector<TransformComponent*>> levels;
+
+	// Queues the evaluation of the given modified transform
+	void enqueue(TransformComponent& transform);
+
+	// Runs the given range job in parallel if enabled, otherwise on the calling thread
+	void dispatch(size_t count, size_t batchSize, const JobSystem::RangeJob& job);
+
+	// Evaluates modified transforms level by level, only descending into modified subtrees
+	void evaluateHierarchy();
 };
\ No newline at end of file
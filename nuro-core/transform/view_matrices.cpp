@@ -0,0 +1,112 @@
+#include "view_matrices.h"
+
+#include <algorithm>
+
+#include <ecs/ecs_collection.h>
+#include <transform/matrix_batch.h>
+#include <transform/world_matrices.h>
+#include <context/application_context.h>
+
+// Amount of model-view-projection matrices updated per job
+static constexpr size_t UPDATE_BATCH_SIZE = 1024;
+
+ViewMatrices::ViewMatrices() : mvps(),
+stamps(),
+lods(),
+fallbackLod(0),
+viewProjection(1.0f),
+viewProjectionVersion(1)
+{
+}
+
+void ViewMatrices::update(const glm::mat4& _viewProjection)
+{
+	// Bump view projection version if camera changed
+	if (_viewProjection != viewProjection) {
+		viewProjection = _viewProjection;
+		viewProjectionVersion++;
+	}
+
+	resize();
+
+	// Walk slots in order so consecutive outdated slots are multiplied as one batch
+	WorldMatrices& matrices = ECS::main().getWorldMatrices();
+	size_t nSlots = std::min(matrices.size(), mvps.size());
+
+	ApplicationContext::jobSystem().parallelFor(nSlots, UPDATE_BATCH_SIZE, [this, &matrices](size_t begin, size_t end) {
+		const glm::mat4* models = matrices.modelData();
+
+		size_t slot = begin;
+		while (slot < end) {
+			// Skip slots that are up to date
+			if (!outdated(matrices, static_cast<uint32_t>(slot))) {
+				slot++;
+				continue;
+			}
+
+			// Find range of consecutive outdated slots, stamping them on the way
+			size_t rangeBegin = slot;
+			for (; slot < end && outdated(matrices, static_cast<uint32_t>(slot)); slot++) {
+				stamps[slot] = { matrices.worldVersion(static_cast<uint32_t>(slot)), viewProjectionVersion };
+			}
+
+			MatrixBatch::multiply(viewProjection, models + rangeBegin, mvps.data() + rangeBegin, slot - rangeBegin);
+		}
+		});
+}
+
+const glm::mat4& ViewMatrices::mvp(const TransformComponent& transform)
+{
+	static const glm::mat4 identity = glm::mat4(1.0f);
+	if (transform.slot == WorldMatrices::INVALID_SLOT) return identity;
+
+	// Transform might have been created after the last update
+	if (transform.slot >= mvps.size()) resize();
+
+	refresh(transform.slot);
+	return mvps[transform.slot];
+}
+
+const glm::mat4& ViewMatrices::getViewProjection() const
+{
+	return viewProjection;
+}
+
+uint32_t& ViewMatrices::lod(const TransformComponent& transform, LodPass pass)
+{
+	if (transform.slot == WorldMatrices::INVALID_SLOT) {
+		fallbackLod = 0;
+		return fallbackLod;
+	}
+
+	// Transform might have been created after the last update
+	if (transform.slot >= lods.size()) resize();
+
+	return lods[transform.slot][static_cast<size_t>(pass)];
+}
+
+void ViewMatrices::resize()
+{
+	size_t size = ECS::main().getWorldMatrices().size();
+	if (mvps.size() >= size) return;
+
+	mvps.resize(size, glm::mat4(1.0f));
+	stamps.resize(size, Stamp());
+	lods.resize(size, {});
+}
+
+void ViewMatrices::refresh(uint32_t slot)
+{
+	WorldMatrices& matrices = ECS::main().getWorldMatrices();
+
+	if (!outdated(matrices, slot)) return;
+
+	MatrixBatch::multiply(viewProjection, matrices.model(slot), mvps[slot]);
+	stamps[slot] = { matrices.worldVersion(slot), viewProjectionVersion };
+}
+
+bool ViewMatrices::outdated(const WorldMatrices& matrices, uint32_t slot) const
+{
+	const Stamp& stamp = stamps[slot];
+	return stamp.world != matrices.worldVersion(slot) || stamp.viewProjection != viewProjectionVersion;
+}
\ No newline at end of file
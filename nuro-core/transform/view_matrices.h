@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include <ecs/components.h>
+
+class WorldMatrices;
+
+// Model-view-projection matrices of all transforms relative to a single view, indexed by world matrix slot
+class ViewMatrices
+{
+public:
+	ViewMatrices();
+
+	// Sets the views projection and recalculates outdated model-view-projection matrices of all slots, batching consecutive outdated slots
+	void update(const glm::mat4& viewProjection);
+
+	// Returns the model-view-projection matrix of the given transform, recalculating it first if outdated
+	const glm::mat4& mvp(const TransformComponent& transform);
+
+	// Returns the current view projection
+	const glm::mat4& getViewProjection() const;
+
+	// Passes of a view selecting levels of detail
+	enum class LodPass : uint8_t {
+		FORWARD,
+		PRE_PASS,
+		COUNT
+	};
+
+	// Returns the level of detail last selected for the given transform by the given pass of this view, kept per view so views don't share hysteresis
+	uint32_t& lod(const TransformComponent& transform, LodPass pass);
+
+private:
+	// Versions a model-view-projection matrix was calculated with
+	struct Stamp {
+		uint32_t world = 0;
+		uint32_t viewProjection = 0;
+	};
+
+	std::vector<glm::mat4> mvps;
+	std::vector<Stamp> stamps;
+	std::vector<std::array<uint32_t, static_cast<size_t>(LodPass::COUNT)>> lods;
+
+	// Level of detail handed out for transforms without a world matrix slot
+	uint32_t fallbackLod;
+
+	// Current view projection and its version
+	glm::mat4 viewProjection;
+	uint32_t viewProjectionVersion;
+
+	// Makes sure all world matrix slots are available
+	void resize();
+
+	// Recalculates the model-view-projection matrix of the given slot if outdated
+	void refresh(uint32_t slot);
+
+	// Returns if the model-view-projection matrix of the given slot is outdated
+	bool outdated(const WorldMatrices& matrices, uint32_t slot) const;
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "world_matrices.h"
+
+#include <algorithm>
+
+WorldMatrices::WorldMatrices() : models(),
+normals(),
+worldVersions(),
+storeVersion(1)
+{
+}
+
+void WorldMatrices::reserve(uint32_t slot)
+{
+	if (slot < models.size()) return;
+
+	// Grow geometrically, entity indices are mostly dense
+	size_t size = std::max<size_t>(static_cast<size_t>(slot) + 1, models.size() * 2);
+	models.resize(size, glm::mat4(1.0f));
+	normals.resize(size, glm::mat3(1.0f));
+
+	// New slots start at version one, so view relative matrices of them start outdated
+	worldVersions.resize(size, 1);
+}
+
+size_t WorldMatrices::size() const
+{
+	return models.size();
+}
\ No newline at end of file
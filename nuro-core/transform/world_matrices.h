@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Contiguous structure of arrays storage for the world space matrices of all transforms, indexed by entity
+class WorldMatrices
+{
+public:
+	// Slot of transforms which aren't part of a registry
+	static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+	WorldMatrices();
+
+	// Makes sure the given slot is available, initializing new slots to identity
+	void reserve(uint32_t slot);
+
+	// Returns the amount of slots available
+	size_t size() const;
+
+	// Returns the model matrix of the given slot
+	glm::mat4& model(uint32_t slot) { return models[slot]; }
+
+	// Returns the normal matrix of the given slot
+	glm::mat3& normal(uint32_t slot) { return normals[slot]; }
+
+	// Returns the contiguous model matrices
+	const glm::mat4* modelData() const { return models.data(); }
+
+	// Bumps the world version of the given slot after its model matrix changed
+	void touch(uint32_t slot) { worldVersions[slot]++; }
+
+	// Returns the world version of the given slot, view relative matrices derived from it are outdated once it changed
+	uint32_t worldVersion(uint32_t slot) const { return worldVersions[slot]; }
+
+	// Bumps the version of the whole store once a batch of slots was touched (single thread only)
+	void commit() { storeVersion++; }
+
+	// Returns the version of the whole store, anything derived from all slots is outdated once it changed
+	uint32_t version() const { return storeVersion; }
+
+private:
+	std::vector<glm::mat4> models;
+	std::vector<glm::mat3> normals;
+
+	// Version of each slots model matrix
+	std::vector<uint32_t> worldVersions;
+
+	// Version of the whole store
+	uint32_t storeVersion;
+};
\ No newline at end of file
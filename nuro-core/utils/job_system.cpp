@@ -0,0 +1,129 @@
+#include "job_system.h"
+
+#include <memory>
+#include <algorithm>
+
+JobSystem::JobSystem() : workers(),
+running(false),
+jobs(),
+mtxJobs(),
+cvNextJob()
+{
+}
+
+JobSystem::~JobSystem()
+{
+	stop();
+}
+
+void JobSystem::start(uint32_t nWorkers)
+{
+	// Make sure job system isn't running already
+	if (running) return;
+
+	// Leave one hardware thread to the calling thread by default
+	if (!nWorkers) nWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	running = true;
+	for (uint32_t i = 0; i < nWorkers; i++) {
+		workers.emplace_back(&JobSystem::workerLoop, this);
+	}
+}
+
+void JobSystem::stop()
+{
+	if (!running) return;
+
+	// Wake up all workers so they can exit once the queued jobs are done
+	{
+		std::lock_guard<std::mutex> lock(mtxJobs);
+		running = false;
+	}
+	cvNextJob.notify_all();
+
+	for (std::thread& worker : workers) {
+		if (worker.joinable()) worker.join();
+	}
+	workers.clear();
+}
+
+void JobSystem::parallelFor(size_t count, size_t batchSize, const RangeJob& job)
+{
+	if (!count) return;
+
+	batchSize = std::max<size_t>(batchSize, 1);
+	size_t nBatches = (count + batchSize - 1) / batchSize;
+
+	// Process inline if there's nothing to distribute
+	if (workers.empty() || nBatches == 1) {
+		job(0, count);
+		return;
+	}
+
+	// Shared state of this parallel for, lives until the last queued helper ran
+	// The caller only waits on the batches, helpers finding no batch left retire without being waited on
+	struct Context {
+		std::atomic<size_t> nextBatch = 0;
+		size_t nDone = 0;
+		std::mutex mtx;
+		std::condition_variable cvDone;
+	};
+	std::shared_ptr<Context> context = std::make_shared<Context>();
+
+	// Processes batches until none are left, the job is only accessed while the caller waits on a claimed batch
+	auto process = [&job, nBatches, batchSize, count](Context& state) {
+		size_t batch;
+		while ((batch = state.nextBatch.fetch_add(1)) < nBatches) {
+			size_t begin = batch * batchSize;
+			job(begin, std::min(begin + batchSize, count));
+
+			std::lock_guard<std::mutex> lock(state.mtx);
+			if (++state.nDone == nBatches) state.cvDone.notify_one();
+		}
+	};
+
+	// Queue one helper per worker needed
+	uint32_t nHelpers = static_cast<uint32_t>(std::min<size_t>(workers.size(), nBatches - 1));
+	{
+		std::lock_guard<std::mutex> lock(mtxJobs);
+		for (uint32_t i = 0; i < nHelpers; i++) {
+			jobs.emplace_back([context, process]() {
+				process(*context);
+				});
+		}
+	}
+	cvNextJob.notify_all();
+
+	// Calling thread participates too
+	process(*context);
+
+	// Wait for batches still processed by helpers
+	std::unique_lock<std::mutex> lock(context->mtx);
+	context->cvDone.wait(lock, [&context, nBatches]() { return context->nDone == nBatches; });
+}
+
+uint32_t JobSystem::nWorkers() const
+{
+	return static_cast<uint32_t>(workers.size());
+}
+
+void JobSystem::workerLoop()
+{
+	while (true) {
+		std::function<void()> job;
+
+		// Wait for next job
+		{
+			std::unique_lock<std::mutex> lock(mtxJobs);
+			cvNextJob.wait(lock, [this]() { return !running || !jobs.empty(); });
+
+			// Queued jobs are still processed when stopping, parallel for callers wait on them
+			if (jobs.empty()) return;
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		job();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+class JobSystem
+{
+public:
+	// Job processing the range [begin, end) of a parallel for
+	using RangeJob = std::function<void(size_t begin, size_t end)>;
+
+	JobSystem();
+	~JobSystem();
+
+	// Starts the given amount of worker threads (hardware concurrency minus one if zero)
+	void start(uint32_t nWorkers = 0);
+
+	// Stops and joins all worker threads after they processed all queued jobs
+	void stop();
+
+	// Splits [0, count) into batches and processes them on the workers and the calling thread; returns once all batches are done
+	// Doesn't wait on helpers still queued behind other jobs, the calling thread takes over their batches
+	void parallelFor(size_t count, size_t batchSize, const RangeJob& job);
+
+	// Returns the amount of worker threads
+	uint32_t nWorkers() const;
+
+private:
+	// Processes queued jobs until stopped and no jobs are left
+	void workerLoop();
+
+	std::vector<std::thread> workers;
+	std::atomic<bool> running;
+
+	std::deque<std::function<void()>> jobs;
+	std::mutex mtxJobs;
+	std::condition_variable cvNextJob;
+};
\ No newline at end of file
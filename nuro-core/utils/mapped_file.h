@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <utils/fsutil.h>
+
+// Read only memory mapping of a whole file
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file at the given path, returns false if it couldn't be mapped
+	bool open(const FS::Path& path);
+
+	// Unmaps the file if mapped
+	void close();
+
+	// Returns the mapped file contents, nullptr if not mapped
+	const uint8_t* data() const;
+
+	// Returns the size of the mapped file in bytes
+	size_t size() const;
+
+private:
+	const uint8_t* _data;
+	size_t _size;
+
+	// Native file and mapping handles
+	void* file;
+	void* mapping;
+};
\ No newline at end of file
@@ -16,12 +16,13 @@
 // initialize with users editor settings later
 GameViewPipeline::GameViewPipeline() : drawSkybox(true),
 drawGizmos(false),
+indirectDraws(false),
 viewport(),
 msaaSamples(4),
 profile(),
 skybox(nullptr),
 gizmos(nullptr),
-transformPass(),
+viewMatrices(),
 prePass(viewport),
 forwardPass(viewport),
 ssaoPass(viewport),
@@ -66,17 +67,17 @@ void GameViewPipeline::render()
 	glm::mat3 viewNormal = glm::transpose(glm::inverse(glm::mat3(view)));
 
 	//
-	// TRANSFORM PASS
-	// Evaluate and update transforms
+	// VIEW MATRICES
+	// Update model-view-projection matrices relative to this view, world matrices were evaluated for the frame already
 	// 
-	transformPass.perform(viewProjection);
+	viewMatrices.update(viewProjection);
 
 	//
 	// PRE PASS
 	// Create geometry pass with depth buffer before forward pass
 	//
 	Profiler::start("pre_pass");
-	prePass.render(viewProjection, viewNormal);
+	prePass.render(viewMatrices, viewNormal);
 	Profiler::stop("pre_pass");
 	const uint32_t PRE_PASS_DEPTH_OUTPUT = prePass.getDepthOutput();
 	const uint32_t PRE_PASS_NORMAL_OUTPUT = prePass.getNormalOutput();
@@ -103,7 +104,7 @@ void GameViewPipeline::render()
 	velocityOutput = 0;
 
 	if (velocityBufferNeeded)
-		velocityOutput = velocityBuffer.render(view, projection, profile);
+		velocityOutput = velocityBuffer.render(view, projection, profile, viewMatrices);
 
 	const uint32_t VELOCITY_BUFFER_OUTPUT = velocityOutput;
 	Profiler::stop("velocity_buffer");
@@ -120,12 +121,14 @@ void GameViewPipeline::render()
 	LitMaterial::castShadows = true;
 	LitMaterial::mainShadowDisk = Runtime::mainShadowDisk();
 	LitMaterial::mainShadowMap = Runtime::mainShadowMap();
+	LitMaterial::syncViewData();
 
 	Profiler::start("forward_pass");
 	forwardPass.drawSkybox = drawSkybox;
+	forwardPass.indirectDraws = indirectDraws;
 	forwardPass.drawGizmos = drawGizmos && gizmos;
 	if (forwardPass.drawGizmos) forwardPass.linkGizmos(gizmos);
-	uint32_t FORWARD_PASS_OUTPUT = forwardPass.render(view, projection, viewProjection);
+	uint32_t FORWARD_PASS_OUTPUT = forwardPass.render(view, projection, viewMatrices);
 	Profiler::stop("forward_pass");
 
 	//
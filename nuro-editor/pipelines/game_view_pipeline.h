@@ -4,7 +4,7 @@
 
 #include <viewport/viewport.h>
 #include <rendering/gizmos/gizmos.h>
-#include <transform/transform_pass.h>
+#include <transform/view_matrices.h>
 #include <rendering/passes/pre_pass.h>
 #include <rendering/passes/ssao_pass.h>
 #include <rendering/passes/forward_pass.h>
@@ -58,6 +58,9 @@ public:
 	// Gizmos will be drawn if this is set
 	bool drawGizmos;
 
+	// Meshes will be submitted with multi draw indirect instead of a draw per mesh if this is set
+	bool indirectDraws;
+
 	// Returns true if there was a camera render target available during the last render
 	bool getCameraAvailable();
 
@@ -93,7 +96,7 @@ private:
 	// Passes
 	//
 
-	TransformPass transformPass;
+	ViewMatrices viewMatrices;
 	PrePass prePass;
 	ForwardPass forwardPass;
 	SSAOPass ssaoPass;
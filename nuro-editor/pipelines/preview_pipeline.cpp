@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <rendering/model/model.h>
 #include <rendering/shader/shader.h>
@@ -21,18 +22,18 @@ void PreviewPipeline::create()
 {
 	// Generate framebuffer
 	glCreateFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 }
 
 void PreviewPipeline::destroy()
 {
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &fbo);
+	GLState::deleteFramebuffers(1, &fbo);
 	fbo = 0;
 
 	// Delete all outputs
 	for (PreviewOutput output : outputs) {
-		glDeleteTextures(1, &output.texture);
+		GLState::deleteTextures(1, &output.texture);
 	}
 	outputs.clear();
 }
@@ -45,7 +46,7 @@ size_t PreviewPipeline::createOutput()
 
 	// Generate outputs texture
 	glGenTextures(1, &output.texture);
-	glBindTexture(GL_TEXTURE_2D, output.texture);
+	GLState::bindTexture(GL_TEXTURE_2D, output.texture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, output.viewport.getWidth_gl(), output.viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -83,7 +84,7 @@ void PreviewPipeline::addRenderInstruction(PreviewRenderInstruction instruction)
 void PreviewPipeline::render()
 {
 	// Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, fbo);
 
 	// Perform all render instructions
 	for (PreviewRenderInstruction instruction : renderInstructions) {
@@ -98,7 +99,7 @@ void PreviewPipeline::render()
 		// Resize output texture if needed
 		if (output.resizePending) {
 			// Only resize if issued new size is big enough
-			glBindTexture(GL_TEXTURE_2D, output.texture);
+			GLState::bindTexture(GL_TEXTURE_2D, output.texture);
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, output.viewport.getWidth_gl(), output.viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, NULL);
 			output.resizePending = false;
 		}
@@ -117,7 +118,7 @@ void PreviewPipeline::render()
 		ResourceRef<Shader> shader = instruction.modelMaterial->getShader();
 		shader->bind();
 		instruction.modelMaterial->bind();
-		instruction.modelMaterial->setSampleDirectionalLight();
+		LitMaterial::setSampleDirectionalLight();
 
 		// Calculate and sync transform matrices
 		glm::mat4 _model = Transformation::model(instruction.modelTransform.position, instruction.modelTransform.rotation, instruction.modelTransform.scale);
@@ -132,11 +133,12 @@ void PreviewPipeline::render()
 		// Bind and render all meshes of model
 		for (int i = 0; i < instruction.model->nLoadedMeshes(); i++) {
 			const Mesh* mesh = instruction.model->queryMesh(i);
-			glBindVertexArray(mesh->vao());
-			glDrawElements(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+			VertexFormat::setDecodeUniforms(*shader, *mesh);
+			GLState::bindVertexArray(mesh->vao());
+			glDrawElementsBaseVertex(GL_TRIANGLES, mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(mesh->firstIndex()) * sizeof(uint32_t)), mesh->baseVertex());
 		}
 
-		instruction.modelMaterial->syncLightUniforms();
+		LitMaterial::syncFrameData();
 
 	}
 
@@ -144,5 +146,5 @@ void PreviewPipeline::render()
 	renderInstructions.clear();
 
 	// Bind screen framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
\ No newline at end of file
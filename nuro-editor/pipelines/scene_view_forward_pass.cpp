@@ -2,9 +2,12 @@
 
 #include <glad/glad.h>
 
+#include <backend/gl_state.h>
 #include <utils/console.h>
 #include <transform/transform.h>
 #include <rendering/model/mesh.h>
+#include <rendering/model/vertex_format.h>
+#include <rendering/model/lod_selection.h>
 #include <rendering/skybox/skybox.h>
 #include <memory/resource_manager.h>
 #include <rendering/material/imaterial.h>
@@ -37,11 +40,11 @@ void SceneViewForwardPass::create(uint32_t msaaSamples)
 
 	// Generate forward pass framebuffer
 	glGenFramebuffers(1, &outputFbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, outputFbo);
 
 	// Generate color output texture
 	glGenTextures(1, &outputColor);
-	glBindTexture(GL_TEXTURE_2D, outputColor);
+	GLState::bindTexture(GL_TEXTURE_2D, outputColor);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, GL_RGBA, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -58,11 +61,11 @@ void SceneViewForwardPass::create(uint32_t msaaSamples)
 
 	// Generate multisampled framebuffer
 	glGenFramebuffers(1, &multisampledFbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
 
 	// Generate multisampled color buffer texture
 	glGenTextures(1, &multisampledColorBuffer);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisampledColorBuffer);
+	GLState::bindTexture(GL_TEXTURE_2D_MULTISAMPLE, multisampledColorBuffer);
 	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, msaaSamples, GL_RGBA16F, viewport.getWidth_gl(), viewport.getHeight_gl(), GL_TRUE);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -81,7 +84,7 @@ void SceneViewForwardPass::create(uint32_t msaaSamples)
 		Console::out::warning("Scene View Forward Pass", "Issue while generating multisampled framebuffer: " + std::to_string(fboStatus));
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void SceneViewForwardPass::destroy() {
@@ -90,15 +93,15 @@ void SceneViewForwardPass::destroy() {
 	selectionMaterial = nullptr;
 
 	// Delete color output texture
-	glDeleteTextures(1, &outputColor);
+	GLState::deleteTextures(1, &outputColor);
 	outputColor = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &outputFbo);
+	GLState::deleteFramebuffers(1, &outputFbo);
 	outputFbo = 0;
 
 	// Delete color output texture
-	glDeleteTextures(1, &multisampledColorBuffer);
+	GLState::deleteTextures(1, &multisampledColorBuffer);
 	multisampledColorBuffer = 0;
 
 	// Delete renderbuffer
@@ -106,14 +109,14 @@ void SceneViewForwardPass::destroy() {
 	multisampledRbo = 0;
 
 	// Delete framebuffer
-	glDeleteFramebuffers(1, &multisampledFbo);
+	GLState::deleteFramebuffers(1, &multisampledFbo);
 	multisampledFbo = 0;
 }
 
-uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities)
+uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& projection, ViewMatrices& viewMatrices, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities)
 {
 	// Bind framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
+	GLState::bindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
 
 	// Clear framebuffer
 	if (!wireframe)
@@ -132,15 +135,15 @@ uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& pr
 	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
 
 	// Set culling to back face
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
+	GLState::enable(GL_CULL_FACE);
+	GLState::cullFace(GL_BACK);
 
 	// Enable depth testing
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::depthFunc(GL_LESS);
 
 	// Enable stencil testing without writing
-	glEnable(GL_STENCIL_TEST);
+	GLState::enable(GL_STENCIL_TEST);
 	glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
 	glStencilMask(0x00);
 	glStencilFunc(GL_ALWAYS, 0, 0xFF);
@@ -148,35 +151,38 @@ uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& pr
 	// Set wireframe if enabled
 	if (wireframe) {
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glDisable(GL_CULL_FACE);
+		GLState::disable(GL_CULL_FACE);
 	}
 
+	// Sort render queue front to back for current view
+	ECS::main().sortRenderQueue(view);
+
 	// Render each entity
-	renderMeshes(selectedEntities);
+	renderMeshes(selectedEntities, viewMatrices);
 
 	// Render selected entity with outline
 	for (auto& entity : selectedEntities) {
-		renderSelectedEntity(entity, viewProjection, camera);
+		renderSelectedEntity(entity, viewMatrices, camera);
 	}
 
 	// Disable wireframe if enabled
 	if (wireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
 	// Disable culling before rendering skybox
-	glDisable(GL_CULL_FACE);
+	GLState::disable(GL_CULL_FACE);
 
 	// Render skybox to bound forward pass frame
 	if (drawSkybox && skybox) skybox->render(view, projection);
 
 	// Render gizmos
-	if (drawGizmos && gizmos) gizmos->renderAll(viewProjection);
+	if (drawGizmos && gizmos) gizmos->renderAll(viewMatrices.getViewProjection());
 
 	// Disable stencil testing
-	glDisable(GL_STENCIL_TEST);
+	GLState::disable(GL_STENCIL_TEST);
 
 	// Bilt multisampled framebuffer to post processing framebuffer
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, multisampledFbo);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
+	GLState::bindFramebuffer(GL_READ_FRAMEBUFFER, multisampledFbo);
+	GLState::bindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
 	glBlitFramebuffer(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl(), 0, 0, viewport.getWidth_gl(), viewport.getHeight_gl(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
 	return outputColor;
@@ -192,9 +198,9 @@ void SceneViewForwardPass::linkGizmos(IMGizmo* _gizmos)
 	gizmos = _gizmos;
 }
 
-void SceneViewForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer)
+void SceneViewForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer, ViewMatrices& viewMatrices, uint32_t& currentVao)
 {
-	// Transform components model and mvp must have been calculated beforehand
+	// Transform components world matrices must have been evaluated beforehand
 
 	// Renderer must be enabled
 	if (!renderer.enabled) return;
@@ -202,29 +208,42 @@ void SceneViewForwardPass::renderMesh(TransformComponent& transform, MeshRendere
 	// Make sure mesh is available
 	if (!renderer.mesh) return;
 
+	// Skip meshes outside the view frustum
+	const glm::mat4& mvp = viewMatrices.mvp(transform);
+	if (!MeshBounds::intersectsFrustum(renderer.mesh->bounds(), mvp)) return;
+
+	// Select level of detail
+	uint32_t& lod = viewMatrices.lod(transform, ViewMatrices::LodPass::FORWARD);
+	lod = LodSelection::select(*renderer.mesh, mvp, lod);
+
 	// Set shader uniforms
 	ResourceRef<Shader> shader = renderer.material->getShader();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
-
-	// Bind mesh
-	glBindVertexArray(renderer.mesh->vao());
+	shader->setMatrix4(UniformId<"mvpMatrix">, mvp);
+	shader->setMatrix4(UniformId<"modelMatrix">, Transform::model(transform));
+	shader->setMatrix3(UniformId<"normalMatrix">, Transform::normal(transform));
+	VertexFormat::setDecodeUniforms(*shader, *renderer.mesh);
+
+	// Bind mesh, meshes of the same geometry arena page share their vertex array
+	if (renderer.mesh->vao() != currentVao) {
+		GLState::bindVertexArray(renderer.mesh->vao());
+		currentVao = renderer.mesh->vao();
+	}
 
 	// Render mesh
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	LodSelection::draw(*renderer.mesh, lod);
 }
 
-void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& skippedEntities)
+void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& skippedEntities, ViewMatrices& viewMatrices)
 {
 	uint32_t currentShaderId = 0;
 	uint32_t currentMaterialId = 0;
+	uint32_t currentVao = 0;
 
 	uint16_t newBoundShaders = 0;
 	uint16_t newBoundMaterials = 0;
 
 	// Render each entity except for skipped one
-	for (auto& [entity, transform, renderer] : ECS::main().getRenderQueue()) {
+	for (auto [entity, transform, renderer] : ECS::main().getRenderQueue()) {
 
 		// Skip if target entity is selected entity
 		// tmp
@@ -246,12 +265,12 @@ void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& ski
 			newBoundMaterials++;
 		}
 
-		renderMesh(transform, renderer);
+		renderMesh(transform, renderer, viewMatrices, currentVao);
 
 	}
 }
 
-void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const glm::mat4& viewProjection, const Camera& camera)
+void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, ViewMatrices& viewMatrices, const Camera& camera)
 {
 	// Render selected entitites gizmos if needed
 	if (gizmos) ComponentGizmos::drawEntityGizmos(*gizmos, *entity);
@@ -276,12 +295,13 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	// Forward render entities base mesh
 	ResourceRef<Shader> shader = renderer.material->getShader();
 	shader->bind();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
+	shader->setMatrix4(UniformId<"mvpMatrix">, viewMatrices.mvp(transform));
+	shader->setMatrix4(UniformId<"modelMatrix">, Transform::model(transform));
+	shader->setMatrix3(UniformId<"normalMatrix">, Transform::normal(transform));
+	VertexFormat::setDecodeUniforms(*shader, *renderer.mesh);
 	renderer.material->bind();
-	glBindVertexArray(renderer.mesh->vao());
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	GLState::bindVertexArray(renderer.mesh->vao());
+	glDrawElementsBaseVertex(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(renderer.mesh->firstIndex()) * sizeof(uint32_t)), renderer.mesh->baseVertex());
 
 	// Don't render outline if wireframe is enabled
 	if (wireframe) return;
@@ -289,32 +309,30 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	// Render outline of selected entity
 	glStencilFunc(GL_NOTEQUAL, 1, 0xFF); // Pass if stencil value is NOT 1
 	glStencilMask(0x00); // Disable stencil writes
-	glDepthFunc(GL_LEQUAL); // Pass depth test if less or equal
+	GLState::depthFunc(GL_LEQUAL); // Pass depth test if less or equal
 
 	// Enable blending
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::enable(GL_BLEND);
+	GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	// Temporary transform component
-	TransformComponent outlineTransform;
+	// Outline model-view-projection, not part of the world matrix store
 	float thickness = 0.038f;
-	outlineTransform.parent = transform.parent;
 	glm::vec3 position = Transform::getPosition(transform, Space::WORLD);
 	glm::quat rotation = Transform::getRotation(transform, Space::WORLD);
 	glm::vec3 scale = Transform::getScale(transform, Space::WORLD) + thickness;
-	outlineTransform.model = Transformation::model(position, rotation, scale);
-	Transform::updateMvp(outlineTransform, viewProjection);
+	glm::mat4 outlineMvp = viewMatrices.getViewProjection() * Transformation::model(position, rotation, scale);
 
 	// Render mesh as outline
 	shader = selectionMaterial->getShader();
 	shader->bind();
-	shader->setMatrix4("mvpMatrix", outlineTransform.mvp);
+	shader->setMatrix4(UniformId<"mvpMatrix">, outlineMvp);
+	VertexFormat::setDecodeUniforms(*shader, *renderer.mesh);
 	selectionMaterial->bind();
-	glBindVertexArray(renderer.mesh->vao());
-	glDrawElements(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, 0);
+	GLState::bindVertexArray(renderer.mesh->vao());
+	glDrawElementsBaseVertex(GL_TRIANGLES, renderer.mesh->indiceCount(), GL_UNSIGNED_INT, (void*)(static_cast<uintptr_t>(renderer.mesh->firstIndex()) * sizeof(uint32_t)), renderer.mesh->baseVertex());
 
 	// Reset state
-	glDisable(GL_BLEND);
+	GLState::disable(GL_BLEND);
 	glStencilMask(0xFF);
 	glStencilFunc(GL_ALWAYS, 0, 0xFF);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <viewport/viewport.h>
 #include <ecs/ecs_collection.h>
+#include <transform/view_matrices.h>
 #include <rendering/gizmos/imgizmo.h>
 
 class Skybox;
@@ -21,7 +22,7 @@ public:
 	void destroy(); // Destroys forward pass
 
 	// Scene view forward passes all entity render targets and returns color output
-	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities);
+	uint32_t render(const glm::mat4& view, const glm::mat4& projection, ViewMatrices& viewMatrices, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities);
 
 	void linkSkybox(Skybox* skybox);
 	bool drawSkybox; // Draw skybox in scene view
@@ -49,7 +50,7 @@ private:
 	// Default scene view clearing color rgb values
 	static constexpr float defaultClearColor[3] = { 0.015f, 0.015f, 0.015f };
 
-	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer); // Renders a given entities mesh
-	void renderMeshes(const std::vector<EntityContainer*>& skippedEntities); // Renders all meshes
-	void renderSelectedEntity(EntityContainer* entity, const glm::mat4& viewProjection, const Camera& camera); // Renders the selected entity with an outline
+	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer, ViewMatrices& viewMatrices, uint32_t& currentVao); // Renders a given entities mesh
+	void renderMeshes(const std::vector<EntityContainer*>& skippedEntities, ViewMatrices& viewMatrices); // Renders all meshes
+	void renderSelectedEntity(EntityContainer* entity, ViewMatrices& viewMatrices, const Camera& camera); // Renders the selected entity with an outline
 };
\ No newline at end of file
@@ -26,7 +26,7 @@ defaultProfile(),
 flyCameraTransform(),
 flyCameraRoot(),
 flyCamera(flyCameraTransform, flyCameraRoot),
-transformPass(),
+viewMatrices(),
 prePass(viewport),
 sceneViewForwardPass(viewport),
 ssaoPass(viewport),
@@ -95,19 +95,17 @@ void SceneViewPipeline::render()
 	ComponentGizmos::drawSceneViewIcons(gizmos, cameraTransform);
 
 	//
-	// TRANSFORM PASS
-	// Evaluate and update transforms
+	// VIEW MATRICES
+	// Update model-view-projection matrices relative to this view, world matrices were evaluated for the frame already
 	// 
-	Profiler::start("transform_pass");
-	transformPass.perform(viewProjection);
-	Profiler::stop("transform_pass");
+	viewMatrices.update(viewProjection);
 
 	//
 	// PRE PASS
 	// Create geometry pass with depth buffer before forward pass
 	//
 	Profiler::start("pre_pass");
-	prePass.render(viewProjection, viewNormal);
+	prePass.render(viewMatrices, viewNormal);
 	Profiler::stop("pre_pass");
 	const uint32_t PRE_PASS_DEPTH_OUTPUT = prePass.getDepthOutput();
 	const uint32_t PRE_PASS_NORMAL_OUTPUT = prePass.getNormalOutput();
@@ -142,12 +140,13 @@ void SceneViewPipeline::render()
 	LitMaterial::castShadows = renderingShadows;
 	LitMaterial::mainShadowDisk = Runtime::mainShadowDisk();
 	LitMaterial::mainShadowMap = Runtime::mainShadowMap();
+	LitMaterial::syncViewData();
 
 	sceneViewForwardPass.wireframe = wireframe;
 	sceneViewForwardPass.drawSkybox = showSkybox;
 	sceneViewForwardPass.linkSkybox(Runtime::gameViewPipeline().getLinkedSkybox());
 	sceneViewForwardPass.drawGizmos = showGizmos;
-	uint32_t FORWARD_PASS_OUTPUT = sceneViewForwardPass.render(view, projection, viewProjection, camera, selectedEntities);
+	uint32_t FORWARD_PASS_OUTPUT = sceneViewForwardPass.render(view, projection, viewMatrices, camera, selectedEntities);
 
 	//
 	// POST PROCESSING PASS
@@ -7,7 +7,7 @@
 #include <ecs/ecs_collection.h>
 #include <rendering/skybox/skybox.h>
 #include <rendering/gizmos/gizmos.h>
-#include <transform/transform_pass.h>
+#include <transform/view_matrices.h>
 #include <rendering/passes/pre_pass.h>
 #include <rendering/passes/ssao_pass.h>
 #include <rendering/velocitybuffer/velocity_buffer.h>
@@ -107,7 +107,7 @@ private:
 	// Linked passes
 	//
 
-	TransformPass transformPass;
+	ViewMatrices viewMatrices;
 	PrePass prePass;
 	SceneViewForwardPass sceneViewForwardPass;
 	SSAOPass ssaoPass;
@@ -20,6 +20,7 @@
 #include <viewport/viewport.h>
 #include <ecs/ecs_collection.h>
 #include <transform/transform.h>
+#include <transform/transform_pass.h>
 #include <diagnostics/profiler.h>
 #include <context/application_context.h>
 
@@ -38,6 +39,9 @@ namespace Runtime {
 	// Project manager
 	ProjectManager gProjectManager;
 
+	// Transform pass evaluating world matrices once per frame for all views
+	TransformPass gTransformPass;
+
 	// Pipelines
 	SceneViewPipeline gSceneViewPipeline;
 	GameViewPipeline gGameViewPipeline;
@@ -52,7 +56,7 @@ namespace Runtime {
 
 	// Default assets
 	Skybox gDefaultSkybox;
-	uint32_t gDefaultCubemap = 0;
+	CubemapHandle gDefaultCubemap;
 
 	// Global game state
 	GameState gGameState = GameState::GAME_SLEEPING;
@@ -96,8 +100,7 @@ namespace Runtime {
 		gDefaultCubemap = cubemapId;
 		cubemap->setSource_Cross("./resources/skybox/default/default_night.png");
 
-		// Create default skybox
-		gDefaultSkybox.setCubemap(cubemap);
+		// Create default skybox, its cubemap is set once loaded
 		gDefaultSkybox.create();
 		gGameViewPipeline.linkSkybox(&gDefaultSkybox);
 
@@ -130,15 +133,7 @@ namespace Runtime {
 
 	void _renderShadowsGlobal()
 	{
-		// WARNING
-		// 
-		// Right now, the shadow passes will use the "current model matrix" from the mesh renderer.
-		// As the shadows will be rendered before the other rendering pipelines,
-		// which prepare the mesh renderer by among other things calculating and 
-		// settings its "current model matrix", the "current model matrix" will always be
-		// one frame delayed, ultimately delaying object movement for shadows by one frame
-		//
-		// Fix: Calculate transform matrices before rendering shadows
+		// World matrices are evaluated by the global transform pass before shadows are rendered
 
 		//
 		// SHADOW PASS
@@ -158,6 +153,14 @@ namespace Runtime {
 		}
 	}
 
+	void _syncFrameDataGlobal()
+	{
+		// Upload lights and shadow parameters shared by all lit materials once for all views
+		LitMaterial::mainShadowDisk = gMainShadowDisk;
+		LitMaterial::mainShadowMap = gMainShadowMap;
+		LitMaterial::syncFrameData();
+	}
+
 	void _stepGame() {
 
 		// UPDATE GAME LOGIC
@@ -241,8 +244,14 @@ namespace Runtime {
 		// UPDATE GAME IF GAME IS RUNNING
 		if (gGameState == GameState::GAME_RUNNING) _stepGame();
 
+		// EVALUATE TRANSFORMS ONCE FOR ALL VIEWS
+		Profiler::start("transform_pass");
+		gTransformPass.perform();
+		Profiler::stop("transform_pass");
+
 		// RENDER NEXT FRAME
 		_renderShadowsGlobal();
+		_syncFrameDataGlobal();
 		gSceneViewPipeline.render();
 		gGameViewPipeline.render();
 		// gPreviewPipeline.render();
@@ -283,8 +292,13 @@ namespace Runtime {
 
 		// LOAD DEFAULT CUBEMAP
 		ResourceManager& resource = ApplicationContext::resourceManager();
-		if (auto cubemap = resource.getResourceAs<Cubemap>(gDefaultCubemap)) {
-			resource.exec(cubemap->create());
+		if (Cubemap* cubemap = resource.get(gDefaultCubemap)) {
+			ResourcePipe cubemapPipe = cubemap->create();
+			cubemapPipe.onComplete([&resource](bool success) {
+				if (success) gDefaultSkybox.setCubemap(resource.getResourceAs<Cubemap>(gDefaultCubemap));
+				else Console::out::warning("Runtime", "Failed to load the default cubemap, the skybox stays empty");
+			});
+			resource.exec(std::move(cubemapPipe));
 		}
 
 		// MAIN LOOP
@@ -13,7 +13,7 @@ EntityContainer kinematic;
 EntityContainer player;
 EntityContainer audio;
 
-uint32_t albedoResourceId;
+TextureHandle albedoResourceId;
 
 void _physics_example() {
 	// Get resource manager
@@ -138,9 +138,11 @@ void _physics_example() {
 	resource.exec(audioClip->create());
 	audio = ecs.createEntity("Sound Emitter");
 	Transform::setPosition(audio.transform(), glm::vec3(0.0f, 0.0f, 15.0f));
-	MeshRendererComponent& audioMr = audio.add<MeshRendererComponent>();
-	audioMr.mesh = sphereMesh;
-	audioMr.material = glowingMaterial;
+	audio.add<MeshRendererComponent>();
+	audio.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = sphereMesh;
+		renderer.material = glowingMaterial;
+		});
 	audio.add<SphereColliderComponent>();
 	RigidbodyComponent& audioRb = audio.add<RigidbodyComponent>();
 	Rigidbody::setGravity(audioRb, false);
@@ -158,9 +160,11 @@ void _physics_example() {
 	EntityContainer ground(ecs.createEntity("Ground"));
 	Transform::setPosition(ground.transform(), glm::vec3(0.0f, -10.1f, 35.0f));
 	Transform::setScale(ground.transform(), glm::vec3(140.0f, 0.1f, 140.0f));
-	MeshRendererComponent& groundMr = ground.add<MeshRendererComponent>();
-	groundMr.mesh = cubeMesh;
-	groundMr.material = standardMaterial;
+	ground.add<MeshRendererComponent>();
+	ground.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = cubeMesh;
+		renderer.material = standardMaterial;
+		});
 	RigidbodyComponent& groundRb = ground.add<RigidbodyComponent>();
 	Rigidbody::setKinematic(groundRb, true);
 	BoxColliderComponent& groundCollider = ground.add<BoxColliderComponent>();
@@ -169,9 +173,11 @@ void _physics_example() {
 	kinematic = ecs.createEntity("Kinematic");
 	Transform::setPosition(kinematic.transform(), glm::vec3(1.0f, 0.5f, 6.0f));
 	Transform::setScale(kinematic.transform(), glm::vec3(2.0f));
-	MeshRendererComponent& kinematicMr = kinematic.add<MeshRendererComponent>();
-	kinematicMr.mesh = sphereMesh;
-	kinematicMr.material = redMaterial;
+	kinematic.add<MeshRendererComponent>();
+	kinematic.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = sphereMesh;
+		renderer.material = redMaterial;
+		});
 	kinematic.add<SphereColliderComponent>();
 	RigidbodyComponent& kinematicRb = kinematic.add<RigidbodyComponent>();
 	Rigidbody::setCollisionDetection(kinematicRb, RB_CollisionDetection::CONTINUOUS);
@@ -180,9 +186,11 @@ void _physics_example() {
 	// Player sphere
 	player = ecs.createEntity("Player");
 	Transform::setPosition(player.transform(), glm::vec3(8.0f, 0.0f, -4.0f));
-	MeshRendererComponent& playerMr = player.add<MeshRendererComponent>();
-	playerMr.mesh = sphereMesh;
-	playerMr.material = playerMaterial;
+	player.add<MeshRendererComponent>();
+	player.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = sphereMesh;
+		renderer.material = playerMaterial;
+		});
 	player.add<SphereColliderComponent>();
 	RigidbodyComponent& playerRb = player.add<RigidbodyComponent>();
 	Rigidbody::setCollisionDetection(playerRb, RB_CollisionDetection::CONTINUOUS);
@@ -193,31 +201,40 @@ void _physics_example() {
 	EntityContainer playerChild(ecs.createEntity("Player Child", player.handle()));
 	Transform::setPosition(playerChild.transform(), glm::vec3(8.0f, 2.0f, -4.5f), Space::WORLD);
 	Transform::setScale(playerChild.transform(), glm::vec3(0.5f));
-	MeshRendererComponent& playerChildMr = playerChild.add<MeshRendererComponent>();
-	playerChildMr.mesh = sphereMesh;
-	playerChildMr.material = playerMaterial;
+	playerChild.add<MeshRendererComponent>();
+	playerChild.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = sphereMesh;
+		renderer.material = playerMaterial;
+		});
 
 	// Second child
 	EntityContainer secondChild(ecs.createEntity("Second Child", playerChild.handle()));
 	Transform::setPosition(secondChild.transform(), glm::vec3(-2.5f, 0.0f, 0.0f));
 	Transform::setScale(secondChild.transform(), glm::vec3(0.6f));
-	MeshRendererComponent& secondChildMr = secondChild.add<MeshRendererComponent>();
-	secondChildMr.mesh = sphereMesh;
-	secondChildMr.material = playerMaterial;
+	secondChild.add<MeshRendererComponent>();
+	secondChild.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = sphereMesh;
+		renderer.material = playerMaterial;
+		});
 
 	// Model async loading example
 	auto [asyncModelId, asyncModel] = resource.create<Model>("mannequin");
 	asyncModel->setSource("resources/example-assets/models/mannequin.fbx");
-	resource.exec(asyncModel->create());
+	asyncModel->setVertexPacking(true);
+	ResourcePipe asyncModelPipe = asyncModel->create();
+	asyncModelPipe.dependsOn(albedoResourceId); // Only show the model once its material's albedo texture is ready
+	resource.exec(std::move(asyncModelPipe));
 	const Mesh* asyncModelMesh = asyncModel->queryMesh(0);
 
 	EntityContainer asyncModelEntity(ecs.createEntity("Async Model"));
 	Transform::setPosition(asyncModelEntity.transform(), glm::vec3(6.0f, 0.0f, 10.0f));
 	Transform::setRotation(asyncModelEntity.transform(), glm::quat(glm::radians(55.0f), glm::vec3(1.0f, 0.0f, 0.0f)));
 	Transform::setScale(asyncModelEntity.transform(), glm::vec3(7.0f));
-	MeshRendererComponent& asyncModelMr = asyncModelEntity.add<MeshRendererComponent>();
-	asyncModelMr.mesh = asyncModelMesh;
-	asyncModelMr.material = scifiMaterial;
+	asyncModelEntity.add<MeshRendererComponent>();
+	asyncModelEntity.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+		renderer.mesh = asyncModelMesh;
+		renderer.material = scifiMaterial;
+		});
 
 	// Cube batch
 	int objectAmount = 28;
@@ -226,9 +243,11 @@ void _physics_example() {
 		for (int y = 0; y < std::sqrt(objectAmount); y++) {
 			EntityContainer e(ecs.createEntity("Cube " + std::to_string(c)));
 			Transform::setPosition(e.transform(), glm::vec3(x * 2.5f - 8.0f, y * 2.5f - 8.0f, 35.0f));
-			MeshRendererComponent& r = e.add<MeshRendererComponent>();
-			r.mesh = cubeMesh;
-			r.material = standardMaterial;
+			e.add<MeshRendererComponent>();
+			e.patch<MeshRendererComponent>([&](MeshRendererComponent& renderer) {
+				renderer.mesh = cubeMesh;
+				renderer.material = standardMaterial;
+				});
 			e.add<BoxColliderComponent>();
 			RigidbodyComponent& rb = e.add<RigidbodyComponent>();
 			c++;
@@ -198,7 +198,7 @@ namespace InspectableComponents {
 			_headline("General");
 
 			if (meshRenderer.mesh) {
-				IMComponents::label("Mesh ID: " + std::to_string(meshRenderer.mesh->vao()));
+				IMComponents::label("Mesh ID: " + std::to_string(meshRenderer.mesh->id()));
 			}
 
 			if (meshRenderer.material) {
@@ -60,13 +60,14 @@ void Footer::renderContent(ImDrawList& drawList)
     // Fetch worker state
     ResourceManager& manager = ApplicationContext::resourceManager();
     auto state = manager.readProcessorState();
-    uint32_t nPending = manager.nQueuedPipes();
+    uint32_t nPending = manager.nQueuedPipes() + manager.nWaitingPipes();
 
     // Fetch target resource if worker is active
     std::string informationText = "No pending assets.";
     if (state.loading) {
         std::string pending = nPending < 1 ? "" : (" (" + std::to_string(nPending) + " pending)");
-        informationText = "Loading '" + state.name + "'..." + pending;
+        std::string progress = state.progress < 0.0f ? "" : (" " + std::to_string(static_cast<int32_t>(state.progress * 100.0f)) + "%");
+        informationText = "Loading '" + state.name + "'..." + progress + pending;
     }
 
     // Draw text and loading buffer
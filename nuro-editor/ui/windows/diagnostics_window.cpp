@@ -6,6 +6,7 @@
 #include <time/time.h>
 #include <diagnostics/profiler.h>
 #include <diagnostics/diagnostics.h>
+#include <context/application_context.h>
 
 DiagnosticsWindow::DiagnosticsWindow() : fpsCache(std::deque<float>(100)),
 fpsUpdateTimer(0.0f)
@@ -64,9 +65,13 @@ void DiagnosticsWindow::render()
 
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
+		IMComponents::input("Indirect Draws", Runtime::gameViewPipeline().indirectDraws);
+
 		IMComponents::indicatorLabel("Current Draw Calls:", Diagnostics::getCurrentDrawCalls());
 		IMComponents::indicatorLabel("Current Vertices:", Diagnostics::getCurrentVertices());
 		IMComponents::indicatorLabel("Current Polygons:", Diagnostics::getCurrentPolygons());
+		IMComponents::indicatorLabel("State Changes:", Diagnostics::getCurrentStateChanges());
+		IMComponents::indicatorLabel("Filtered State Changes:", Diagnostics::getCurrentFilteredStateChanges());
 
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
@@ -86,6 +91,22 @@ void DiagnosticsWindow::render()
 		IMComponents::indicatorLabel("PP Pass:", Profiler::getMs("post_processing"), "ms");
 		IMComponents::indicatorLabel("UI Pass:", Profiler::getMs("ui_pass"), "ms");
 		IMComponents::indicatorLabel("Scene View:", Profiler::getMs("scene_view"), "ms");
+
+		ImGui::Dummy(ImVec2(0.0f, 5.0f));
+
+		ResourceManager::ContextUsage contextUsage = ApplicationContext::resourceManager().readContextUsage();
+		IMComponents::indicatorLabel("Context Task Budget:", contextUsage.budget, "ms");
+		IMComponents::indicatorLabel("Context Task Time:", contextUsage.used, "ms");
+		IMComponents::indicatorLabel("Context Tasks Executed:", contextUsage.nExecuted);
+		IMComponents::indicatorLabel("Context Tasks Pending:", contextUsage.nPending);
+
+		ImGui::Dummy(ImVec2(0.0f, 5.0f));
+
+		ResourceManager::MemoryUsage memoryUsage = ApplicationContext::resourceManager().readMemoryUsage();
+		IMComponents::indicatorLabel("Resource CPU Memory:", static_cast<float>(memoryUsage.used.cpu / (1024.0 * 1024.0)), "MB");
+		IMComponents::indicatorLabel("Resource GPU Memory:", static_cast<float>(memoryUsage.used.gpu / (1024.0 * 1024.0)), "MB");
+		IMComponents::indicatorLabel("Resources Evicted:", memoryUsage.nEvicted);
+		IMComponents::indicatorLabel("Resources Reloaded:", memoryUsage.nReloads);
 	}
 	ImGui::End();
 }
\ No newline at end of file
@@ -36,7 +36,7 @@ void ResourceViewerWindow::render()
 		
 		ImGui::BeginChild(EditorUI::generateId(), ImVec2(ImGui::GetContentRegionAvail()));
 		{
-			for (const auto& [id, resource] : resources) {
+			resources.each([&](ResourceID id, const ResourceRef<Resource>& resource) {
 				IMComponents::label("ID " + std::to_string(id) + ": ", EditorUI::getFonts().p_bold);
 				ImGui::SameLine();
 
@@ -67,12 +67,16 @@ void ResourceViewerWindow::render()
 					IMComponents::label("FAILED", IM_COL32(255, 50, 50, 255));
 					ImGui::SameLine();
 					break;
+				case ResourceState::EVICTED:
+					IMComponents::label("EVICTED", IM_COL32(150, 150, 150, 255));
+					ImGui::SameLine();
+					break;
 				}
 
 				IMComponents::label("- Used by: ");
 				ImGui::SameLine();
 				IMComponents::label(std::to_string(resource.use_count() - 1));
-			}
+			});
 		}
 		ImGui::EndChild();
 	}
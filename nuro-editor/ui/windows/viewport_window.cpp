@@ -262,7 +262,7 @@ void ViewportWindow::renderTransformGizmos()
 
 	// Copy transforms model matrix
 	TransformComponent& transform = selected->get<TransformComponent>();
-	glm::mat4 model = transform.model;
+	glm::mat4 model = Transform::model(transform);
 
 	// Snapping
 	bool snapping = Input::keyDown(Key::LEFT_CONTROL);